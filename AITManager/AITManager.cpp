@@ -1,10 +1,13 @@
 #include "base/MemoryControlSystem.h"
 #include "base/Packet.h"
 #include "base/EventQueue.h"
+#include "base/IDAllocator.h"
 #include "base/Stats.h"
 #include "base/MemInfo.h"
 #include "base/PCMInfo.h"
+#include "base/ReqTracer.h"
 #include "AITManager/AITManager.h"
+#include "AITManager/AITPrefetcher.h"
 #include "MemoryModules/GPCache/GPCache.h"
 #include "TraceGen/TraceGen.h"
 
@@ -12,7 +15,7 @@ using namespace PCMCsim;
 
 AITManager::AITManager(MemoryControlSystem* memsys_, std::string cfg_header)
 :Component(memsys_), mcu(NULL), rmw(NULL), tcache(NULL), tdram(NULL),
-wake_mcuq(0), last_wake_mcuq(0), proc_wlv(NULL), status_ait(ST_NORMAL), 
+prefetcher(NULL), wake_mcuq(0), last_wake_mcuq(0), proc_wlv(NULL), status_ait(ST_NORMAL), 
 wake_mux(0), last_wake_mux(0), free_mux(0), wake_hostq(0), 
 last_wake_hostq(0), wake_remapq(0), last_wake_remapq(0)
 {
@@ -42,8 +45,7 @@ last_wake_hostq(0), wake_remapq(0), last_wake_remapq(0)
     credit_buffer = size_buffer;
     bentry_t b_init{false, false, NULL};
     cmd_buffer.resize(size_buffer, b_init);
-    for(uint64_t id=0 ; id<size_buffer; id++)
-        avail_ID.push_back(id);
+    ID_alloc = new IDAllocator(size_buffer);
 
     /* Construct cache */
     tcache = new GPCache(memsys_, cp_name+".gpc");
@@ -54,6 +56,10 @@ last_wake_hostq(0), wake_remapq(0), last_wake_remapq(0)
     width_block = 1 << gpc_byte_offset;
     num_blocks = 1 << (gpc_cline_bits-gpc_byte_offset);
 
+    /* Construct prefetcher of AIT entries */
+    if (memsys->getParamBOOL(cp_name+".prefetch", false))
+        prefetcher = new AITPrefetcher(memsys_, cp_name+".pf", this);
+
     /* Stats registration */
     register_stats( );
 }
@@ -62,6 +68,9 @@ AITManager::~AITManager()
 {
     if (tcache)
         delete tcache;
+    if (prefetcher)
+        delete prefetcher;
+    delete ID_alloc;
 }
 
 bool AITManager::isReady(Packet* pkt)
@@ -81,6 +90,7 @@ bool AITManager::isReady(Packet* pkt)
 void AITManager::recvRequest(Packet* pkt, ncycle_t delay)
 {
     pkt->recvTick = geq->getCurrentTick( )+delay*ticks_per_cycle;
+    PCMC_TRACE(pkt, TRC_AITM, pkt->recvTick);
     if (pkt->src_id==SRC_HOST)
     {
         credit_buffer--;
@@ -127,6 +137,23 @@ void AITManager::recvResponse(Packet* pkt, ncycle_t delay)
             mcu->recvRequest(irq_ready, tCMD);
         }
     }
+    else if (pkt->from==tcache && pkt->is_prefetch)
+    {
+        /* Prefetched AIT$ line: fill PB and respond waiting lookups */
+        std::vector<Packet*> waiters;
+        prefetcher->fill(pkt, waiters);
+        for (uint64_t i=0; i<waiters.size( ); i++)
+            Component::recvResponse(waiters[i], delay);
+        delete pkt;
+
+        /* PB entry is released for the next prefetch */
+        if (last_wake_mux==wake_mux && isPrefetchable( ))
+        {
+            wake_mux = geq->getCurrentTick( )+1*ticks_per_cycle;
+            wake_mux = std::max(wake_mux, free_mux);
+            registerCallbackAt((CallbackPtr)&AITManager::ait_mux, wake_mux);
+        }
+    }
     else if (pkt->from==tcache)
     {
         /* Response of address get cmd */
@@ -211,12 +238,11 @@ void AITManager::cycle_mcuq( )
 
 void AITManager::ID_remap(Packet* pkt)
 {
-    assert(!avail_ID.empty( ));
+    assert(!ID_alloc->full( ));
 
     /* Allocate an inner ID */
-    uint64_t newID = avail_ID.front( );
+    uint64_t newID = ID_alloc->alloc( );
     assert(cmd_buffer[newID].valid==false);
-    avail_ID.pop_front( );
     cmd_buffer[newID].valid = true;
     cmd_buffer[newID].pkt = pkt;
 
@@ -238,16 +264,35 @@ void AITManager::ID_remap(Packet* pkt)
 
     ait_pkt->recvTick = geq->getCurrentTick( );
 
+    /* Look up prefetch buffer unless AIT is being remapped */
+    int pb_lookup = AITPrefetcher::PB_MISS;
+    if (prefetcher && status_ait==ST_NORMAL)
+    {
+        pb_lookup = prefetcher->lookup(ait_pkt);
+        prefetcher->train(ait_pkt->LADDR);
+    }
 
-    qentry_t new_entry{true, ait_pkt};
-    ait_rdq.push(new_entry);
+    if (pb_lookup==AITPrefetcher::PB_HIT)
+    {
+        cmd_buffer[newID].inflight_ait_rd = true;
+        Component::recvResponse(ait_pkt, prefetcher->get_tPB( ));
+    }
+    else if (pb_lookup==AITPrefetcher::PB_WAIT)
+        cmd_buffer[newID].inflight_ait_rd = true;
+    else
+    {
+        qentry_t new_entry{true, ait_pkt};
+        ait_rdq.push(new_entry);
+    }
 
     PCMC_DBG(dbg_msg, "[AM] Confer tmp-ID=%lx to [0x%lx, ID=%lx, CMD=%c]"
-        " to gen AIT$ RD [0x%lx]\n", newID, pkt->LADDR, pkt->req_id,
-        (pkt->cmd==CMD_READ)? 'R':'W', ait_pkt->LADDR);
+        " to gen AIT$ RD [0x%lx]%s\n", newID, pkt->LADDR, pkt->req_id,
+        (pkt->cmd==CMD_READ)? 'R':'W', ait_pkt->LADDR,
+        (pb_lookup==AITPrefetcher::PB_MISS)? "":" served by PB");
     
     /* Schedule to issue AIT$ cmd */
-    if (last_wake_mux==wake_mux)
+    if (last_wake_mux==wake_mux &&
+        (ait_rdq.empty( )==false || isPrefetchable( )))
     {
         wake_mux = geq->getCurrentTick( )+1*ticks_per_cycle;
         wake_mux = std::max(wake_mux, free_mux);
@@ -315,6 +360,8 @@ void AITManager::gen_blk_remap( )
         ref_pkt->req_id = i | (1<<buffer_bits);
         ref_pkt->LADDR = LBA << gpc_byte_offset;
         ref_pkt->PADDR = ref_pkt->LADDR;
+        if (prefetcher)
+            prefetcher->invalidate(ref_pkt->LADDR);
         ref_pkt->buffer_data.setSize(width_block);
         for (uint64_t b=0; b<width_block; b++)
         {
@@ -467,6 +514,20 @@ bool AITManager::isIssuable(int qid)
     return rv;
 }
 
+bool AITManager::isPrefetchable( )
+{
+    /* Prefetch only fills idle AIT$ input slots */
+    bool rv = false;
+    if (prefetcher && prefetcher->has_candidate( ) &&
+        status_ait==ST_NORMAL && ait_rdq.empty( ))
+    {
+        /* AIT$ admission does not depend on the packet */
+        rv = tcache->isReady(NULL);
+    }
+
+    return rv;
+}
+
 void AITManager::ait_mux( )
 {
     bool rd_issuable = isIssuable(AIT_RDQ);
@@ -484,10 +545,16 @@ void AITManager::ait_mux( )
         ait_issue(AIT_RDQ);
         isIssued = true;
     }
+    else if (isPrefetchable( ))
+    {
+        ait_issue_prefetch( );
+        isIssued = true;
+    }
 
     last_wake_mux = wake_mux;
     free_mux = (isIssued==false)? free_mux : (wake_mux+1*ticks_per_cycle);
-    if (ait_rdq.empty( )==false || ait_wrq.empty( )==false)
+    if (ait_rdq.empty( )==false || ait_wrq.empty( )==false || 
+        isPrefetchable( ))
     {
         wake_mux = geq->getCurrentTick( )+1*ticks_per_cycle;
         registerCallback((CallbackPtr)&AITManager::ait_mux, 1);
@@ -521,6 +588,29 @@ void AITManager::ait_issue(int qid)
         (qid==AIT_RDQ)? "RD":"WR", pkt->LADDR, pkt->req_id);
 }
 
+void AITManager::ait_issue_prefetch( )
+{
+    /* Read whole AIT$ line into prefetch buffer */
+    uint64_t pf_id = 0;
+    Packet* pf_pkt = new Packet( );
+    pf_pkt->LADDR = prefetcher->issue_candidate(pf_id);
+    pf_pkt->PADDR = pf_pkt->LADDR;
+    pf_pkt->req_id = pf_id;
+    pf_pkt->src_id = SRC_HOST;
+    pf_pkt->cmd = CMD_READ;
+    pf_pkt->owner = this;
+    pf_pkt->from = this;
+    pf_pkt->dest = tdram;
+    pf_pkt->is_prefetch = true;
+    pf_pkt->recvTick = geq->getCurrentTick( );
+    init_ait_entry(pf_pkt->PADDR, pf_pkt->buffer_data);
+
+    tcache->recvRequest(pf_pkt, tCMD);
+
+    PCMC_DBG(dbg_msg, "[AM] Issue prefetch to AIT$, where [0x%lx, ID=%lx]\n", 
+        pf_pkt->LADDR, pf_pkt->req_id);
+}
+
 void AITManager::ID_unmap(Packet* pkt)
 {
     /* Retire assigned ID when request is issued */
@@ -532,7 +622,7 @@ void AITManager::ID_unmap(Packet* pkt)
             cmd_buffer[i].valid = false;
             cmd_buffer[i].pkt = NULL;
             cmd_buffer[i].inflight_ait_rd = false;
-            avail_ID.push_back(i);
+            ID_alloc->release(i);
             break;
         }
     }
@@ -653,12 +743,12 @@ void AITManager::register_stats( )
 
     ADD_STATS(cp_name, num_update);
     ADD_STATS(cp_name, num_map);
-    ADD_STATS_N_UNIT(cp_name, max_wait_ait, "cycles");
-    ADD_STATS_N_UNIT(cp_name, min_wait_ait, "cycles");
-    ADD_STATS_N_UNIT(cp_name, avg_wait_ait, "cycles");
-    ADD_STATS_N_UNIT(cp_name, max_issue_lat, "cycles");
-    ADD_STATS_N_UNIT(cp_name, min_issue_lat, "cycles");
-    ADD_STATS_N_UNIT(cp_name, avg_issue_lat, "cycles");
+    ADD_STATS_LAT(cp_name, max_wait_ait);
+    ADD_STATS_LAT(cp_name, min_wait_ait);
+    ADD_STATS_LAT(cp_name, avg_wait_ait);
+    ADD_STATS_LAT(cp_name, max_issue_lat);
+    ADD_STATS_LAT(cp_name, min_issue_lat);
+    ADD_STATS_LAT(cp_name, avg_issue_lat);
 }
 
 void AITManager::calculate_stats( )
@@ -676,11 +766,24 @@ void AITManager::calculate_stats( )
         min_issue_lat /= ticks_per_cycle;
         avg_issue_lat /= ticks_per_cycle;
     }
+
+    tcache->calculate_stats( );
+    if (prefetcher)
+        prefetcher->calculate_stats( );
 }
 
 void AITManager::print_stats(std::ostream& os)
 {
     stats->print(os);
-    tcache->calculate_stats( );
     tcache->print_stats(os);
+    if (prefetcher)
+        prefetcher->print_stats(os);
+}
+
+void AITManager::collect_stats(std::vector<Stats*>& slist)
+{
+    slist.push_back(stats);
+    tcache->collect_stats(slist);
+    if (prefetcher)
+        prefetcher->collect_stats(slist);
 }
@@ -53,6 +53,7 @@ namespace PCMCsim
     class Parser;
     class GPCache;
     class AITPrefetcher;
+    class IDAllocator;
 
     class AITManager : public Component
     {
@@ -68,6 +69,7 @@ namespace PCMCsim
         
         void calculate_stats( ) override;
         void print_stats(std::ostream& os) override;
+        void collect_stats(std::vector<Stats*>& slist) override;
         
         /* Externally connected components */
         Component* mcu;
@@ -110,14 +112,6 @@ namespace PCMCsim
             Packet* pkt;
         } bentry_t;
 
-        typedef struct _pbe_t
-        {
-            bool valid;
-            bool useful;
-            uint64_t addr;
-            DataBlock data;
-        } pbe_t;
-
         uint64_t gpc_cline_bits;    // $line offset
         uint64_t gpc_byte_offset;   // data block offset in a $line address
         uint64_t num_blocks;
@@ -138,7 +132,7 @@ namespace PCMCsim
         void cycle_mcuq( );
 
         /* ID mapping for normal req */
-        std::list<uint64_t> avail_ID;
+        IDAllocator* ID_alloc;
         void ID_remap(Packet* pkt);
         
         /* Block manager that generates address remap/swap req */
@@ -162,8 +156,10 @@ namespace PCMCsim
         std::queue<qentry_t> ait_wrq; // addr update cmds from BLKMGR, fixed as 3
         
         bool isIssuable(int qid);
+        bool isPrefetchable( );
         void ait_mux( );
         void ait_issue(int qid);
+        void ait_issue_prefetch( );
 
         /* Response path of AIT cache */
         void handle_await_resps( ) override;
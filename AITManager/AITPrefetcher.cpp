@@ -0,0 +1,165 @@
+#include "base/MemoryControlSystem.h"
+#include "base/Packet.h"
+#include "base/EventQueue.h"
+#include "AITManager/AITManager.h"
+#include "AITManager/AITPrefetcher.h"
+
+using namespace PCMCsim;
+
+AITPrefetcher::AITPrefetcher(MemoryControlSystem* memsys_, std::string cfg_header,
+                             AITManager* aitm_)
+:Prefetcher(memsys_, cfg_header, 16, 64), aitm(aitm_), next_pf_id(0)
+{
+    tPB = memsys->getParamUINT64(cp_name+".tPB", 1);
+
+    /* AIT$ line geometry */
+    aitm->get_gpc_info(cline_bits, byte_offset);
+    width_block = 1 << byte_offset;
+    num_blocks = 1 << (cline_bits-byte_offset);
+}
+
+AITPrefetcher::~AITPrefetcher( )
+{
+}
+
+int AITPrefetcher::lookup(Packet* pkt)
+{
+    int rv = PB_MISS;
+    uint64_t line = pkt->LADDR >> cline_bits;
+    int64_t idx = find_pb(line);
+    if (idx>=0 && pb[idx].inflight==false)
+    {
+        /* Copy the AIT entry of the block */
+        uint64_t blk = (pkt->LADDR>>byte_offset) % num_blocks;
+        pkt->buffer_data.setSize(width_block);
+        for (uint64_t i=0; i<width_block; i++)
+            pkt->buffer_data.setByte(i, pb[idx].data.getByte(blk*width_block+i));
+        pkt->pb_hit = true;
+
+        num_pb_hit += 1;
+        rv = PB_HIT;
+    }
+    else if (idx>=0)
+    {
+        /* Late prefetch: wait for the line */
+        pb[idx].waiters.push_back(pkt);
+        num_pb_wait += 1;
+        rv = PB_WAIT;
+    }
+
+    count_lookup(idx);
+
+    PCMC_DBG(dbg_msg, "[AITPF] Lookup [0x%lx, ID=%lx] in PB: %s\n", pkt->LADDR, 
+        pkt->req_id, (rv==PB_HIT)? "HIT":((rv==PB_WAIT)? "WAIT":"MISS"));
+
+    return rv;
+}
+
+void AITPrefetcher::train(uint64_t addr)
+{
+    /* Streams are tracked by LBA */
+    uint64_t lba = addr >> byte_offset;
+    stream_t* s = train_stream(lba);
+    if (s==NULL)
+        return;
+
+    /* Generate candidates */
+    uint64_t line = lba / num_blocks;
+    if (s->conf>=2)
+    {
+        /* Lines of the next LBAs along the stride */
+        uint64_t n = degree;
+        uint64_t prev_line = line;
+        uint64_t target = lba;
+        for (uint64_t k=0; k<n*num_blocks && n>0; k++)
+        {
+            if (s->stride<0 && (uint64_t)(-s->stride)>target)
+                break;
+            target += s->stride;
+            if (target/num_blocks!=prev_line)
+            {
+                prev_line = target/num_blocks;
+                push_candidate(prev_line);
+                n -= 1;
+            }
+        }
+    }
+    else
+    {
+        for (uint64_t k=1; k<=degree; k++)
+            push_candidate(line+k);
+    }
+}
+
+uint64_t AITPrefetcher::issue_candidate(uint64_t& pf_id)
+{
+    uint64_t line;
+    int64_t idx = alloc_pb(line);
+
+    /* Prefetch IDs are sequential and matched when filled */
+    pb[idx].pf_id = next_pf_id;
+    pf_id = next_pf_id;
+    next_pf_id += 1;
+
+    PCMC_DBG(dbg_msg, "[AITPF] Issue prefetch of AIT$ line 0x%lx (PB=%ld)\n",
+        line<<cline_bits, idx);
+
+    return (line<<cline_bits);
+}
+
+void AITPrefetcher::fill(Packet* pkt, std::vector<Packet*>& waiters)
+{
+    assert(pkt->is_prefetch && pkt->buffer_data.getSize( )==(1U<<cline_bits));
+    int64_t idx = -1;
+    for (uint64_t i=0; i<size_pb; i++)
+    {
+        if (pb[i].valid && pb[i].inflight && pb[i].pf_id==(uint64_t)pkt->req_id)
+        {
+            idx = (int64_t)i;
+            break;
+        }
+    }
+
+    /* Entry has been invalidated by remapping */
+    if (idx<0)
+    {
+        num_pf_stale += 1;
+        return;
+    }
+
+    pb[idx].inflight = false;
+    pb[idx].data = pkt->buffer_data;
+
+    /* Serve the lookups that have waited */
+    for (uint64_t w=0; w<pb[idx].waiters.size( ); w++)
+    {
+        Packet* wpkt = pb[idx].waiters[w];
+        uint64_t blk = (wpkt->LADDR>>byte_offset) % num_blocks;
+        wpkt->buffer_data.setSize(width_block);
+        for (uint64_t i=0; i<width_block; i++)
+            wpkt->buffer_data.setByte(i, pb[idx].data.getByte(blk*width_block+i));
+        wpkt->pb_hit = true;
+        waiters.push_back(wpkt);
+    }
+    pb[idx].waiters.clear( );
+
+    PCMC_DBG(dbg_msg, "[AITPF] Fill AIT$ line 0x%lx to PB=%ld, %lu waiters\n",
+        pkt->LADDR, idx, waiters.size( ));
+}
+
+void AITPrefetcher::invalidate(uint64_t addr)
+{
+    int64_t idx = find_pb(addr>>cline_bits);
+    if (idx>=0)
+    {
+        assert(pb[idx].waiters.empty( ));
+        pb[idx].valid = false;
+        pb[idx].inflight = false;
+    }
+
+    /* Candidates of the line are stale as well */
+    std::deque<uint64_t>::iterator it = 
+        std::find(pfq.begin( ), pfq.end( ), addr>>cline_bits);
+    if (it!=pfq.end( ))
+        pfq.erase(it);
+}
@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) 2019 Computer Architecture and Paralllel Processing Lab, 
+ * Seoul National University, Republic of Korea. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     1. Redistribution of source code must retain the above copyright 
+ *        notice, this list of conditions and the follwoing disclaimer.
+ *     2. Redistributions in binary form must reproduce the above copyright 
+ *        notice, this list conditions and the following disclaimer in the 
+ *        documentation and/or other materials provided with the distirubtion.
+ *     3. Neither the name of the copyright holders nor the name of its 
+ *        contributors may be used to endorse or promote products derived from 
+ *        this software without specific prior written permission. 
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *
+ * Description: This is a prefetcher of AIT entries for AITManager.
+ * It watches the logical block (LBA) stream of AIT lookups and issues
+ * AIT$-line reads marked as prefetch, which GPCache serves on hit and
+ * bypasses on miss. Returned lines are kept in a dedicated prefetch 
+ * buffer (PB) that is checked before a lookup goes to AIT$
+ * > stride: a small table tracks streams by LBA proximity; a confirmed 
+ *   stride prefetches the lines of the next LBAs along the stride
+ * > next-N-line: otherwise, next N lines of the current one are fetched
+ * > throttling: degree N is adjusted by the accuracy (see Prefetcher)
+ * A lookup whose line is still being prefetched waits in the PB entry.
+ * Lines updated by block remapping are invalidated in the PB
+ */
+
+#ifndef __PCMCSIM_AIT_PREFETCHER_H_
+#define __PCMCSIM_AIT_PREFETCHER_H_
+
+#include "base/PCMCTypes.h"
+#include "base/Prefetcher.h"
+
+namespace PCMCsim
+{
+    class MemoryControlSystem;
+    class Packet;
+    class AITManager;
+
+    class AITPrefetcher : public Prefetcher
+    {
+      public:
+        AITPrefetcher(MemoryControlSystem* memsys_, std::string cfg_header, 
+                      AITManager* aitm_);
+        ~AITPrefetcher( );
+
+        /* Interface for AITManager (addresses are of AIT$ reqs) */
+        int lookup(Packet* pkt);
+        void train(uint64_t addr);
+        uint64_t issue_candidate(uint64_t& pf_id);
+        void fill(Packet* pkt, std::vector<Packet*>& waiters);
+        void invalidate(uint64_t addr);
+
+        ncycle_t get_tPB( ) { return tPB; }
+
+      private:
+        AITManager* aitm;
+        uint64_t cline_bits;
+        uint64_t byte_offset;
+        uint64_t width_block;
+        uint64_t num_blocks;
+        uint64_t next_pf_id;
+        ncycle_t tPB;
+    };
+};
+
+#endif
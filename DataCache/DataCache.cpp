@@ -2,12 +2,20 @@
 #include "base/Packet.h"
 #include "base/EventQueue.h"
 #include "base/PipeBufferv2.h"
+#include "base/IDAllocator.h"
+#include "base/TagArray.h"
 #include "base/Stats.h"
 #include "base/MemInfo.h"
+#include "base/ReqTracer.h"
 #include "DataCache/DataCache.h"
+#include "DataCache/DataPrefetcher.h"
+#include "ReadModifyWrite/ReadModifyWrite.h"
+#include "uCMDEngine/uCMDEngine.h"
 #include "ReplacePolicy/RoundRobin/RoundRobin.h"
 #include "ReplacePolicy/TrueLRU/TrueLRU.h"
 #include "ReplacePolicy/PseudoLRU/PseudoLRU.h"
+#include "ReplacePolicy/RRIP/RRIP.h"
+#include "ReplacePolicy/SHiP/SHiP.h"
 #include "TraceGen/TraceGen.h"
 
 using namespace PCMCsim;
@@ -21,7 +29,9 @@ typedef struct _signals_t
 
 DataCache::DataCache(MemoryControlSystem* memsys_, std::string cfg_header)
 :Component(memsys_), recvr(NULL), need_wakeup(true), size_cmdq(32),
-wake_resp_mux(0), last_wake_resp_mux(0), free_resp(0), status(NO_STALL)
+wake_resp_mux(0), last_wake_resp_mux(0), free_resp(0), prefetcher(NULL), 
+wake_pf(0), last_wake_pf(0), rdmiss_inflight(0), ewb_ptr(0), ewb_scans(0), ewb_pkt(NULL),
+wake_ewb(0), last_wake_ewb(0), status(NO_STALL)
 {
     cp_name = cfg_header;
     dbg_msg = memsys->getParamBOOL(cp_name+".dbg_msg", false);
@@ -50,19 +60,22 @@ wake_resp_mux(0), last_wake_resp_mux(0), free_resp(0), status(NO_STALL)
         exit(1);
     }
 
-    cache.resize(num_cache);
+    tags.resize(num_cache);
+    dmem.resize(num_cache);
     for (uint64_t c = 0; c < num_cache; c++)
     {
-        cache[c].resize(num_sets);
+        tags[c] = new TagArray(num_sets, num_ways);
+        dmem[c].resize(num_sets);
         for (uint64_t s = 0; s < num_sets; s++)
         {
             DataBlock e_data;
-            entry_t e_init {0, 0, 0, 0, e_data};
-            cache[c][s].resize(num_ways, e_init);
+            dmem[c][s].resize(num_ways, e_data);
         }
     }
 
     std::string got_policy = memsys->getParamSTR(cp_name+".policy");
+    /* SHiP signature is a coarse region (not a line tag) to be shared */
+    uint64_t ship_region_bits = memsys->getParamUINT64(cp_name+".ship_region_bits", 14);
     victim_policy.resize(num_cache);
     for (uint64_t c=0; c<num_cache; c++)
     {
@@ -72,6 +85,14 @@ wake_resp_mux(0), last_wake_resp_mux(0), free_resp(0), status(NO_STALL)
             victim_policy[c] = new TrueLRU(num_sets, num_ways);
         else if (got_policy == "PSEUDO_LRU")
             victim_policy[c] = new PseudoLRU(num_sets, num_ways);
+        else if (got_policy == "SRRIP")
+            victim_policy[c] = new RRIP(num_sets, num_ways, RRIP::MODE_SRRIP);
+        else if (got_policy == "BRRIP")
+            victim_policy[c] = new RRIP(num_sets, num_ways, RRIP::MODE_BRRIP);
+        else if (got_policy == "DRRIP")
+            victim_policy[c] = new RRIP(num_sets, num_ways, RRIP::MODE_DRRIP);
+        else if (got_policy == "SHIP")
+            victim_policy[c] = new SHiP(num_sets, num_ways, ship_region_bits);
         else
         {
             std::cerr << "[DC] Error! Invalid replacement policy!" << std::endl;
@@ -97,6 +118,9 @@ wake_resp_mux(0), last_wake_resp_mux(0), free_resp(0), status(NO_STALL)
         exit(1);
     }
 
+    /* Each $ holds a 64B sector of the page, so evictions can merge them */
+    gather_evct = memsys->getParamBOOL(cp_name+".gather_evct", false) && num_sets>0;
+
     /* 
      * Note DCACHE, BLKMGR, RMW, uCMDE, DPU has common ID space 
      * Write ID should be conferred again in DCACHE, 
@@ -104,8 +128,7 @@ wake_resp_mux(0), last_wake_resp_mux(0), free_resp(0), status(NO_STALL)
      */
     uint64_t buffer_size_bits = memsys->getParamUINT64("reqRecv.buffer_size_bits", 7);
     uint64_t num_wid = 1<<buffer_size_bits;
-    for (uint64_t id=0; id<num_wid; id++)
-        avail_WID.push_back((id|(1<<buffer_size_bits)));
+    WID_alloc = new IDAllocator(num_wid, (1<<buffer_size_bits));
     credit_WID = num_wid;
 
     /* Timing parameter setup */
@@ -115,6 +138,23 @@ wake_resp_mux(0), last_wake_resp_mux(0), free_resp(0), status(NO_STALL)
     /* Setup pipeline buffers (static latency) */
     pipe_access = new PipeBufferv2( );
 
+    /* Construct prefetcher of pages */
+    if (memsys->getParamBOOL(cp_name+".prefetch", false))
+        prefetcher = new DataPrefetcher(memsys_, cp_name+".pf");
+
+    /* Eager write-back cleans cache lines, so bypass needs none */
+    eager_wb = memsys->getParamBOOL(cp_name+".eager_wb", false) && num_sets>0;
+    ewb_rmw_thres = memsys->getParamUINT64(cp_name+".ewb_rmw_thres", 8);
+    ewb_ucmd_thres = memsys->getParamUINT64(cp_name+".ewb_ucmd_thres", 4);
+    ewb_cmdq_thres = memsys->getParamUINT64(cp_name+".ewb_cmdq_thres", 4);
+    ewb_rdmiss_thres = memsys->getParamUINT64(cp_name+".ewb_rdmiss_thres", 4);
+    if (eager_wb)
+    {
+        ewb_clean.resize(num_cache);
+        for (uint64_t c=0; c<num_cache; c++)
+            ewb_clean[c].resize(num_sets*num_ways, false);
+    }
+
     /* Get energy parameters */
     memsys->getParamSRAM(num_sets, num_ways, &Esrpa, &Erdpa, &Ewrpa);
     Esr = new double[num_cache];
@@ -129,6 +169,7 @@ wake_resp_mux(0), last_wake_resp_mux(0), free_resp(0), status(NO_STALL)
 DataCache::~DataCache( )
 {
     delete pipe_access;
+    delete WID_alloc;
 
     delete [] Esr;
     delete [] Erd;
@@ -136,7 +177,13 @@ DataCache::~DataCache( )
     delete [] Etot;
 
     for (uint64_t c=0; c<num_cache; c++)
+    {
         delete victim_policy[c];
+        delete tags[c];
+    }
+
+    if (prefetcher)
+        delete prefetcher;
 }
 
 bool DataCache::isReady(Packet* /*pkt*/)
@@ -153,6 +200,7 @@ void DataCache::recvRequest(Packet* pkt, ncycle_t delay)
     assert(pkt->src_id==SRC_HOST);
     cmdq.push(pkt);
     pkt->recvTick = geq->getCurrentTick( )+delay*ticks_per_cycle;
+    PCMC_TRACE(pkt, TRC_DCACHE, pkt->recvTick);
 
     if (need_wakeup)
     {
@@ -163,6 +211,7 @@ void DataCache::recvRequest(Packet* pkt, ncycle_t delay)
 
 void DataCache::recvResponse(Packet* pkt, ncycle_t delay)
 {
+    PCMC_TRACE(pkt, TRC_DCACHE, geq->getCurrentTick( )+delay*ticks_per_cycle);
     if (pkt->cmd==CMD_WACK_ID)
     {
         assert(pkt->owner==this);
@@ -173,6 +222,17 @@ void DataCache::recvResponse(Packet* pkt, ncycle_t delay)
         assert(pkt->owner==this);
         delete pkt;
     }
+    else if (pkt->cmd==CMD_WRITE && pkt==ewb_pkt)
+    {
+        /* Ready to send eager write-back data to RMW */
+        assert(pkt->from==dynamic_cast<Component*>(rmw));
+        PCMC_DBG(dbg_msg, "[DC] Push eager-wb-data of [0x%lx, ID=%lx] to RMW\n",
+            ewb_pkt->LADDR, ewb_pkt->req_id);
+
+        ewb_pkt->from = this;
+        rmw->recvResponse(ewb_pkt, tBURST_RMW);
+        ewb_pkt = NULL;
+    }
     else if (pkt->cmd==CMD_WRITE && pkt->from==dynamic_cast<Component*>(rmw))
     {
         /* Ready to send eviction data to RMW */
@@ -189,7 +249,13 @@ void DataCache::recvResponse(Packet* pkt, ncycle_t delay)
         {
             uint64_t cidx = get_cache_idx(evct_pkt->LADDR); 
             uint64_t sidx = get_set_idx(evct_pkt->LADDR); 
-            cache[cidx][sidx][pb_signals->tmp_way].dirty = false;
+            tags[cidx]->set_dirty(sidx, pb_signals->tmp_way, false);
+
+            /* Stats update (pipe is stalled since the victim was picked) */
+            ncycle_t tmp_lat = geq->getCurrentTick( )-evct_pkt->recvTick_dcache;
+            avg_evct_stall = (avg_evct_stall*num_evct_stall+tmp_lat)/
+                    (double)(num_evct_stall+1);
+            num_evct_stall += 1;
         }
 
         /* Evct write data */
@@ -262,11 +328,26 @@ void DataCache::handle_await_resps( )
     for ( ; e_it!=await_resp.end( ); )
     {
         Packet* pkt = (*e_it)->pkt;
-        if (pkt->cmd==CMD_READ)
+        if (pkt->cmd==CMD_READ && pkt->is_prefetch)
+        {
+            /* Prefetched page: fill PB and respond waiting reads */
+            assert(pkt->owner==this && pkt->from==dynamic_cast<Component*>(rmw));
+            std::vector<Packet*> waiters;
+            prefetcher->fill(pkt, waiters);
+            for (uint64_t w=0; w<waiters.size( ); w++)
+                fillq.push(waiters[w]);
+            delete pkt;
+
+            /* PB entry is released for the next prefetch */
+            schedule_prefetch( );
+        }
+        else if (pkt->cmd==CMD_READ)
         {
             /* Respond read request from RMW */
             assert(pkt->from==dynamic_cast<Component*>(rmw));
             assert(pkt->buffer_data.getSize( )==PAGE_SIZE);
+            assert(rdmiss_inflight>0);
+            rdmiss_inflight -= 1;
             fillq.push(pkt);
 
             PCMC_DBG(dbg_msg, "[DC] Ready to respond RD [0x%lx, ID=%lx] "
@@ -425,16 +506,9 @@ void DataCache::get_cache_position(uint64_t& cidx, uint64_t& sidx, int64_t& widx
     cidx = get_cache_idx(pkt->LADDR);
     sidx = get_set_idx(pkt->LADDR);
     uint64_t tag = get_tag(pkt->LADDR);
-    for (uint64_t i = 0; i < num_ways; i++)
-    {
-        if (cache[cidx][sidx][i].valid==false) continue;
-
-        if (cache[cidx][sidx][i].tag==tag)
-        {
-            widx = (int64_t)i;
-            break;
-        }
-    }
+    int64_t hit_way = tags[cidx]->find(sidx, tag);
+    if (hit_way>=0)
+        widx = hit_way;
     
     Esr[cidx]+=Esrpa;
 }
@@ -443,6 +517,10 @@ void DataCache::handle_hitmiss(bool hit, int64_t hit_way, Packet* pkt)
 {
     assert(status==NO_STALL);
 
+    /* Prefetched page becomes stale from this write on */
+    if (prefetcher && pkt->cmd==CMD_WRITE)
+        prefetcher->invalidate(pkt->LADDR);
+
     /* Hit/miss handling */
     if (num_sets==0)    // bypass mode
         miss_handle(pkt);
@@ -486,7 +564,7 @@ void DataCache::hit_handle(Packet* pkt, int64_t hit_way)
     if (pkt->cmd==CMD_READ)
     {
         /* Direct service with data */
-        pkt->buffer_data = cache[cidx][s][w].data;
+        pkt->buffer_data = dmem[cidx][s][w];
         assert(pkt->buffer_data.getSize( )>0);
         if (isRespAvailable( ))
         {
@@ -537,6 +615,22 @@ void DataCache::rdhit_resp(Packet* pkt)
 
 void DataCache::miss_handle(Packet* pkt)
 {
+    /* Read miss is served by PB w/o allocation if prefetched */
+    if (prefetcher && pkt->cmd==CMD_READ)
+    {
+        int pb_lookup = prefetcher->lookup(pkt);
+        prefetcher->train(pkt->LADDR);
+        schedule_prefetch( );
+
+        if (pb_lookup==DataPrefetcher::PB_HIT)
+        {
+            fillq.push(pkt);
+            return;
+        }
+        else if (pb_lookup==DataPrefetcher::PB_WAIT)
+            return;
+    }
+
     /* Miss handling */
     status = dcache_alloc(pkt);
 }
@@ -627,6 +721,8 @@ void DataCache::gen_evct(uint64_t addr, DataBlock& evct_data)
 {
     assert(evct_pkt==NULL && addr!=INVALID_ADDR);
     uint64_t cidx = get_cache_idx(addr);
+    if (prefetcher)
+        prefetcher->invalidate(addr);
 
     /* Generate eviction request */
     evct_pkt = new Packet(PAGE_SIZE/HOST_TX_SIZE);
@@ -646,14 +742,46 @@ void DataCache::gen_evct(uint64_t addr, DataBlock& evct_data)
     WID_map(evct_pkt); // Newly map WID
 }
 
+void DataCache::gather_sectors(uint64_t s, uint64_t tag)
+{
+    /* 
+     * Sectors of a page share set & tag in every $, so dirty ones are 
+     * written back together and RMW merges them by dvalid at once
+     */
+    assert(evct_pkt);
+    for (uint64_t c=0; c<num_cache; c++)
+    {
+        if (evct_pkt->dvalid[c])
+            continue;
+
+        /* Reserved way holds the tag of a pending fill, not its data */
+        int64_t w = tags[c]->find(s, tag);
+        Esr[c]+=Esrpa;
+        if (w<0 || tags[c]->is_dirty(s, w)==false || 
+            victim_policy[c]->get_rsvd(s, w))
+            continue;
+
+        uint64_t base_byte = HOST_TX_SIZE*c;
+        for (uint64_t i=0; i<HOST_TX_SIZE; i++)
+            evct_pkt->buffer_data.setByte(base_byte+i, dmem[c][s][w].getByte(i));
+        evct_pkt->dvalid[c] = true;
+        tags[c]->set_dirty(s, w, false);
+
+        /* Stats update */
+        num_evct_sector += 1;
+        Erd[c]+=Erdpa;
+
+        PCMC_DBG(dbg_msg, "[DC] Gather dirty sector (c=%lu, s=%lu, w=%ld) "
+            "into evct-req [0x%lx]\n", c, s, w, evct_pkt->LADDR);
+    }
+}
+
 void DataCache::WID_map(Packet* pkt)
 {
     assert(pkt->cmd==CMD_WRITE);
     uint64_t newID = 0;
-    assert(!avail_WID.empty( ));
-    newID = avail_WID.front( );
-    avail_WID.pop_front( );
-    alloc_WID.insert(newID);
+    assert(!WID_alloc->full( ));
+    newID = WID_alloc->alloc( );
     pkt->req_id = newID;
 
     credit_WID-=1;
@@ -667,8 +795,7 @@ void DataCache::WID_unmap(Packet* pkt)
     assert(pkt->cmd==CMD_WACK_ID && pkt->req_id>=0);
     uint64_t retire_WID = (uint64_t)pkt->req_id;
 
-    avail_WID.push_back(retire_WID);
-    alloc_WID.erase(retire_WID);
+    WID_alloc->release(retire_WID);
 
     credit_WID+=1;
 
@@ -683,7 +810,7 @@ void DataCache::WID_unmap(Packet* pkt)
     num_persist+=1;
 
     PCMC_DBG(dbg_msg, "[DC] Retire WID=%lx of evct-req [0x%lx, CMD=W](credit=%ld)\n", 
-        retire_WID, pkt->LADDR, avail_WID.size( ));
+        retire_WID, pkt->LADDR, WID_alloc->get_free( ));
 }
 
 void DataCache::recv_wdata(Packet* pkt, bool wr_bypass, int64_t wr_hit_way)
@@ -749,6 +876,7 @@ int DataCache::issue_cmd(Packet* pkt)
             sub_status = SUB_RDMISS_EVICT;
             ret = WAIT_AITMGR;
         }
+        rdmiss_inflight += 1;
 
         /* Stats update */
         ncycle_t tmp_lat = geq->getCurrentTick( )-pkt->recvTick;
@@ -822,15 +950,17 @@ int DataCache::dcache_alloc(Packet* pkt)
         {
             PCMC_DBG(dbg_msg, "[DC] Reserve (%lu, %lu, %ld, dirty=%d) "
                 "for Req [0x%lx, CMD=%s, ID=%lx]\n", cidx, s, w, 
-                cache[cidx][s][w].dirty, pkt->LADDR, 
+                tags[cidx]->is_dirty(s, w), pkt->LADDR, 
                 get_cmd_str(pkt).c_str( ), pkt->req_id);
 
-            if (cache[cidx][s][w].dirty)
+            if (tags[cidx]->is_dirty(s, w))
             {
                 /* Dirty line needs to be evicted to address mapper */
-                uint64_t evct_LADDR = (cache[cidx][s][w].tag<<(PAGE_OFFSET+bit_sets)) |
+                uint64_t evct_LADDR = (tags[cidx]->get_tag(s, w)<<(PAGE_OFFSET+bit_sets)) |
                                     (s<<PAGE_OFFSET) | (cidx << HOST_TX_OFFSET);
-                gen_evct(evct_LADDR, cache[cidx][s][w].data);
+                gen_evct(evct_LADDR, dmem[cidx][s][w]);
+                if (gather_evct)
+                    gather_sectors(s, tags[cidx]->get_tag(s, w));
 
                 /* RD miss is issued prior to evict & stall the pipe */
                 sub_status = (pkt->cmd==CMD_READ)? SUB_RDMISS_ISSUE : SUB_NORMAL;
@@ -852,6 +982,10 @@ int DataCache::dcache_alloc(Packet* pkt)
             }
             else
             {
+                /* Eviction is saved if the line was cleaned eagerly */
+                if (eager_wb && ewb_clean[cidx][s*num_ways+w])
+                    num_ewb_saved += 1;
+
                 /* For clean cache line, W: req wdata; R: issue */
                 if (pkt->cmd==CMD_WRITE)
                     nxt_status = req_wdata(pkt);
@@ -864,8 +998,8 @@ int DataCache::dcache_alloc(Packet* pkt)
                     nxt_status = WAIT_AITMGR;
             }
 
-            cache[cidx][s][w].valid = true;
-            cache[cidx][s][w].tag = get_tag(pkt->LADDR);
+            tags[cidx]->set_valid(s, w, true);
+            tags[cidx]->set_tag(s, w, get_tag(pkt->LADDR));
             victim_policy[cidx]->set_rsvd(s, w);
             pb_signals->tmp_way = w; // Note tag of evct_pkt is occupied by new address
         }
@@ -904,13 +1038,15 @@ void DataCache::cycle_fillq( )
     assert(pkt->buffer_data.getSize( )==PAGE_SIZE);
     
     uint64_t cidx = 0; uint64_t sidx = 0; int64_t widx = -1;
-    if (num_sets>0)
+    if (pkt->pb_hit)    // served by PB, no $line is allocated
+        cidx = get_cache_idx(pkt->LADDR);
+    else if (num_sets>0)
         get_cache_position(cidx, sidx, widx, pkt);
 
     /* Process responded read data */
     bool responded = false;
     if (widx<0 ||                               // no $line is allocated
-        cache[cidx][sidx][widx].dirty==false)   // dirty line has evcted
+        tags[cidx]->is_dirty(sidx, widx)==false)   // dirty line has evcted
     {
         /* Truncate data as host desired size */
         DataBlock resp_data;
@@ -946,25 +1082,198 @@ void DataCache::cycle_fillq( )
 void DataCache::fill_line(uint64_t cidx, uint64_t s, int64_t w, Packet* pkt)
 {
     assert(w>=0);
+    if (eager_wb)
+    {
+        /* Eagerly cleaned line written again: its write-back was extra */
+        if (victim_policy[cidx]->get_rsvd(s, w)==false && pkt->cmd==CMD_WRITE &&
+            ewb_clean[cidx][s*num_ways+w])
+        {
+            num_ewb_redirty += 1;
+        }
+        ewb_clean[cidx][s*num_ways+w] = false;
+
+        if (pkt->cmd==CMD_WRITE)
+            schedule_ewb( );
+    }
+
     /* Fill the data */
     uint64_t tag = get_tag(pkt->LADDR);
-    cache[cidx][s][w].data = pkt->buffer_data;
-    cache[cidx][s][w].tag = tag;
-    cache[cidx][s][w].valid = true;
-    victim_policy[cidx]->unset_rsvd(s, w);
-    victim_policy[cidx]->update_victim(s, w);
+    dmem[cidx][s][w] = pkt->buffer_data;
+    tags[cidx]->set_tag(s, w, tag);
+    tags[cidx]->set_valid(s, w, true);
+
+    /* Reserved way is being filled after miss; otherwise write-hit */
+    if (victim_policy[cidx]->get_rsvd(s, w))
+    {
+        victim_policy[cidx]->unset_rsvd(s, w);
+        victim_policy[cidx]->insert_victim(s, w, pkt->LADDR);
+    }
+    else
+        victim_policy[cidx]->update_victim(s, w);
 
     /* Set dirty */    
     if (pkt->cmd==CMD_WRITE)
-        cache[cidx][s][w].dirty = true; // direct write w/o updating==dirty
+        tags[cidx]->set_dirty(s, w, true); // direct write w/o updating==dirty
     
     PCMC_DBG(dbg_msg, "[DC] Fill data of [0x%lx, ID=%lx, CMD=%s] to "
         "(c=%lu, s=%lu, w=%ld, dirty=%d)\n", pkt->LADDR, pkt->req_id, 
-        get_cmd_str(pkt->cmd).c_str( ), cidx, s, w, cache[cidx][s][w].dirty);
+        get_cmd_str(pkt->cmd).c_str( ), cidx, s, w, tags[cidx]->is_dirty(s, w));
     
     Ewr[cidx]+=Ewrpa;
 }
 
+bool DataCache::isMissPathFree( )
+{
+    /* Background reqs never take AITManager from a miss or an eviction */
+    bool rv = false;
+    if (status!=WAIT_AITMGR && status!=ALLOC_FAIL && evct_pkt==NULL)
+    {
+        /* AITManager admits host reqs regardless of the packet */
+        Packet probe;
+        probe.src_id = SRC_HOST;
+        rv = aitm->isReady(&probe);
+    }
+
+    return rv;
+}
+
+bool DataCache::isPrefetchable( )
+{
+    return (prefetcher && prefetcher->has_candidate( ) && isMissPathFree( ));
+}
+
+void DataCache::schedule_prefetch( )
+{
+    if (last_wake_pf==wake_pf && prefetcher && prefetcher->has_candidate( ))
+    {
+        wake_pf = geq->getCurrentTick( )+1*ticks_per_cycle;
+        registerCallbackAt((CallbackPtr)&DataCache::cycle_prefetch, wake_pf);
+    }
+}
+
+void DataCache::cycle_prefetch( )
+{
+    if (isPrefetchable( ))
+        issue_prefetch( );
+
+    /* Candidates wait until a miss path gets free */
+    last_wake_pf = wake_pf;
+    if (prefetcher->has_candidate( ))
+    {
+        wake_pf = geq->getCurrentTick( )+1*ticks_per_cycle;
+        registerCallback((CallbackPtr)&DataCache::cycle_prefetch, 1);
+    }
+}
+
+void DataCache::issue_prefetch( )
+{
+    /* Read whole page into prefetch buffer */
+    id_t pf_id = 0;
+    Packet* pf_pkt = new Packet(PAGE_SIZE/HOST_TX_SIZE);
+    pf_pkt->LADDR = prefetcher->issue_candidate(pf_id);
+    pf_pkt->req_id = pf_id;
+    pf_pkt->src_id = SRC_HOST;
+    pf_pkt->cmd = CMD_READ;
+    pf_pkt->owner = this;
+    pf_pkt->from = this;
+    pf_pkt->is_prefetch = true;
+    pf_pkt->recvTick = geq->getCurrentTick( );
+    pf_pkt->recvTick_dcache = geq->getCurrentTick( );
+
+    aitm->recvRequest(pf_pkt, tCMD);
+
+    PCMC_DBG(dbg_msg, "[DC] Issue prefetch to AITManager, where [0x%lx, ID=%lx]\n",
+        pf_pkt->LADDR, pf_pkt->req_id);
+}
+
+bool DataCache::isEagerWBable( )
+{
+    /* Write-back holds a WID, so leave enough of them to the misses */
+    if (ewb_pkt || WID_alloc->get_free( )<=WID_alloc->get_capacity( )/2 ||
+        isMissPathFree( )==false)
+        return false;
+
+    /* Demand requests go first: few queued cmds and outstanding read misses */
+    if (cmdq.size( )>=ewb_cmdq_thres || rdmiss_inflight>=ewb_rdmiss_thres)
+        return false;
+
+    /* PCM-side queues should be lightly loaded */
+    if (memsys->rmw->get_num_reqs( )>=ewb_rmw_thres)
+        return false;
+    for (uint64_t ch=0; ch<memsys->ucmde.size( ); ch++)
+    {
+        if (memsys->ucmde[ch]->get_num_reqs( )>=ewb_ucmd_thres)
+            return false;
+    }
+
+    return true;
+}
+
+void DataCache::schedule_ewb( )
+{
+    ewb_scans = 0;
+    if (last_wake_ewb==wake_ewb)
+    {
+        wake_ewb = geq->getCurrentTick( )+1*ticks_per_cycle;
+        registerCallbackAt((CallbackPtr)&DataCache::cycle_ewb, wake_ewb);
+    }
+}
+
+void DataCache::cycle_ewb( )
+{
+    /* Scan a victim position of (set, $) per cycle */
+    if (isEagerWBable( ))
+    {
+        uint64_t c = ewb_ptr % num_cache;
+        uint64_t s = ewb_ptr / num_cache;
+        ewb_ptr = (ewb_ptr+1) % (num_cache*num_sets);
+
+        int64_t w = victim_policy[c]->peek_victim(s);
+        if (w>=0 && tags[c]->is_dirty(s, w))
+        {
+            issue_ewb(c, s, w);
+            ewb_scans = 0;
+        }
+        else
+            ewb_scans += 1;
+
+        Esr[c]+=Esrpa;
+    }
+
+    /* Sleep after a full sweep found no dirty victim */
+    last_wake_ewb = wake_ewb;
+    if (ewb_scans<num_cache*num_sets)
+    {
+        wake_ewb = geq->getCurrentTick( )+1*ticks_per_cycle;
+        registerCallback((CallbackPtr)&DataCache::cycle_ewb, 1);
+    }
+}
+
+void DataCache::issue_ewb(uint64_t cidx, uint64_t s, int64_t w)
+{
+    /* Write the line back as an eviction but keep it valid & clean */
+    uint64_t ewb_LADDR = (tags[cidx]->get_tag(s, w)<<(PAGE_OFFSET+bit_sets)) |
+                         (s<<PAGE_OFFSET) | (cidx << HOST_TX_OFFSET);
+    gen_evct(ewb_LADDR, dmem[cidx][s][w]);
+    if (gather_evct)
+        gather_sectors(s, tags[cidx]->get_tag(s, w));
+    ewb_pkt = evct_pkt;
+    evct_pkt = NULL;
+
+    tags[cidx]->set_dirty(s, w, false);
+    ewb_clean[cidx][s*num_ways+w] = true;
+
+    ewb_pkt->from = this;
+    aitm->recvRequest(ewb_pkt, tCMD);
+
+    /* Stats update */
+    num_ewb += 1;
+    Erd[cidx]+=Erdpa;
+
+    PCMC_DBG(dbg_msg, "[DC] Eager write-back of (c=%lu, s=%lu, w=%ld) as "
+        "[0x%lx, ID=%lx]\n", cidx, s, w, ewb_pkt->LADDR, ewb_pkt->req_id);
+}
+
 uint64_t DataCache::get_cache_idx(uint64_t addr)
 {
     assert(num_cache > 0);
@@ -996,6 +1305,13 @@ void DataCache::register_stats( )
     RESET_STATS(write_hit, u64_zero); 
     RESET_STATS(write_miss, u64_zero);
     RESET_STATS(num_evct, u64_zero);
+    RESET_STATS(num_evct_sector, u64_zero);
+    RESET_STATS(num_ewb, u64_zero);
+    RESET_STATS(num_ewb_redirty, u64_zero);
+    RESET_STATS(num_ewb_saved, u64_zero);
+    RESET_STATS(num_evct_stall, u64_zero);
+    RESET_STATS(avg_evct_stall, df_init);
+    RESET_STATS(ewb_saved_stall, df_init);
     RESET_STATS(num_wait_rdresp, u64_zero);
     RESET_STATS(num_persist, u64_zero);
     RESET_STATS(num_wait_rsvd, u64_zero);
@@ -1033,31 +1349,41 @@ void DataCache::register_stats( )
     ADD_STATS(cp_name, read_miss);
     ADD_STATS(cp_name, write_hit);
     ADD_STATS(cp_name, write_miss);
-    ADD_STATS(cp_name, read_miss_rate);
-    ADD_STATS(cp_name, write_miss_rate);
-    ADD_STATS(cp_name, overall_miss_rate);
+    ADD_STATS_LEVEL(cp_name, read_miss_rate);
+    ADD_STATS_LEVEL(cp_name, write_miss_rate);
+    ADD_STATS_LEVEL(cp_name, overall_miss_rate);
     ADD_STATS(cp_name, num_evct);
+    if (gather_evct)
+        ADD_STATS(cp_name, num_evct_sector);
+    if (eager_wb)
+    {
+        ADD_STATS(cp_name, num_ewb);
+        ADD_STATS(cp_name, num_ewb_redirty);
+        ADD_STATS(cp_name, num_ewb_saved);
+        ADD_STATS_LAT(cp_name, avg_evct_stall);
+        ADD_STATS_N_UNIT(cp_name, ewb_saved_stall, "cycles");
+    }
     ADD_STATS(cp_name, num_persist);
     ADD_STATS(cp_name, num_wait_rsvd);
     ADD_STATS(cp_name, num_wait_rdresp);
-    ADD_STATS_N_UNIT(cp_name, max_wait_rdresp, "cycles");
-    ADD_STATS_N_UNIT(cp_name, min_wait_rdresp, "cycles");
-    ADD_STATS_N_UNIT(cp_name, avg_wait_rdresp, "cycles");
-    ADD_STATS_N_UNIT(cp_name, max_persist_lat, "cycles");
-    ADD_STATS_N_UNIT(cp_name, min_persist_lat, "cycles");
-    ADD_STATS_N_UNIT(cp_name, avg_persist_lat, "cycles");
-    ADD_STATS_N_UNIT(cp_name, max_rdhit_lat, "cycles");
-    ADD_STATS_N_UNIT(cp_name, min_rdhit_lat, "cycles");
-    ADD_STATS_N_UNIT(cp_name, avg_rdhit_lat, "cycles");
-    ADD_STATS_N_UNIT(cp_name, max_rdmiss_lat, "cycles");
-    ADD_STATS_N_UNIT(cp_name, min_rdmiss_lat, "cycles");
-    ADD_STATS_N_UNIT(cp_name, avg_rdmiss_lat, "cycles");
-    ADD_STATS_N_UNIT(cp_name, max_wrget_lat, "cycles");
-    ADD_STATS_N_UNIT(cp_name, min_wrget_lat, "cycles");
-    ADD_STATS_N_UNIT(cp_name, avg_wrget_lat, "cycles");
-    ADD_STATS_N_UNIT(cp_name, max_issue_lat, "cycles");
-    ADD_STATS_N_UNIT(cp_name, min_issue_lat, "cycles");
-    ADD_STATS_N_UNIT(cp_name, avg_issue_lat, "cycles");
+    ADD_STATS_LAT(cp_name, max_wait_rdresp);
+    ADD_STATS_LAT(cp_name, min_wait_rdresp);
+    ADD_STATS_LAT(cp_name, avg_wait_rdresp);
+    ADD_STATS_LAT(cp_name, max_persist_lat);
+    ADD_STATS_LAT(cp_name, min_persist_lat);
+    ADD_STATS_LAT(cp_name, avg_persist_lat);
+    ADD_STATS_LAT(cp_name, max_rdhit_lat);
+    ADD_STATS_LAT(cp_name, min_rdhit_lat);
+    ADD_STATS_LAT(cp_name, avg_rdhit_lat);
+    ADD_STATS_LAT(cp_name, max_rdmiss_lat);
+    ADD_STATS_LAT(cp_name, min_rdmiss_lat);
+    ADD_STATS_LAT(cp_name, avg_rdmiss_lat);
+    ADD_STATS_LAT(cp_name, max_wrget_lat);
+    ADD_STATS_LAT(cp_name, min_wrget_lat);
+    ADD_STATS_LAT(cp_name, avg_wrget_lat);
+    ADD_STATS_LAT(cp_name, max_issue_lat);
+    ADD_STATS_LAT(cp_name, min_issue_lat);
+    ADD_STATS_LAT(cp_name, avg_issue_lat);
 
     memset(Esr, 0, num_cache*sizeof(double));
     memset(Erd, 0, num_cache*sizeof(double));
@@ -1102,6 +1428,10 @@ void DataCache::calculate_stats( )
         avg_rdmiss_lat /= ticks_per_cycle;
     }
     
+    if (num_evct_stall>0)
+        avg_evct_stall /= ticks_per_cycle;
+    ewb_saved_stall = num_ewb_saved*avg_evct_stall;
+
     if (num_wrget>0)
     {
         max_wrget_lat /= ticks_per_cycle;
@@ -1134,5 +1464,21 @@ void DataCache::calculate_stats( )
 
     for (uint64_t cidx=0; cidx<num_cache; cidx++)
         Etot[cidx] = Esr[cidx]+Erd[cidx]+Ewr[cidx];
+
+    if (prefetcher)
+        prefetcher->calculate_stats( );
 }
 
+void DataCache::print_stats(std::ostream& os)
+{
+    stats->print(os);
+    if (prefetcher)
+        prefetcher->print_stats(os);
+}
+
+void DataCache::collect_stats(std::vector<Stats*>& slist)
+{
+    slist.push_back(stats);
+    if (prefetcher)
+        prefetcher->collect_stats(slist);
+}
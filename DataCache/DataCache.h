@@ -41,7 +41,10 @@ namespace PCMCsim
 {
     class MemoryControlSystem;
     class PipeBufferv2;
+    class IDAllocator;
+    class TagArray;
     class ReplacePolicy;
+    class DataPrefetcher;
 
     class DataCache : public Component
     {
@@ -62,6 +65,8 @@ namespace PCMCsim
         void handle_events(ncycle_t curr_tick) override;
 
         void calculate_stats( ) override;
+        void print_stats(std::ostream& os) override;
+        void collect_stats(std::vector<Stats*>& slist) override;
 
       private:
         /* Internal types */
@@ -91,15 +96,6 @@ namespace PCMCsim
             NUM_SUB_STATUS
         };
 
-        typedef struct _entry_t
-        {
-            uint64_t tag;
-            bool valid;
-            bool dirty;
-            bool rsvd;
-            DataBlock data;
-        } entry_t;
-
         /* Top functions */
         bool need_wakeup;
         uint64_t size_cmdq;
@@ -115,8 +111,7 @@ namespace PCMCsim
         PipeBufferv2* pipe_access;
         Packet* evct_pkt = NULL;
         int sub_status = SUB_NORMAL;
-        std::list<uint64_t> avail_WID;
-        std::set<uint64_t> alloc_WID;
+        IDAllocator* WID_alloc;
         uint64_t credit_WID;
         
         void access_exec( );
@@ -129,6 +124,7 @@ namespace PCMCsim
         
         /* Write request path */
         void gen_evct(uint64_t addr, DataBlock& evct_data);
+        void gather_sectors(uint64_t set, uint64_t tag);
         void WID_map(Packet* pkt); 
         void WID_unmap(Packet* pkt);
         void recv_wdata(Packet* pkt, bool wr_bypass=true, int64_t wr_hit_way=-1);
@@ -147,6 +143,36 @@ namespace PCMCsim
         void cycle_fillq( );
         void fill_line(uint64_t cidx, uint64_t set, int64_t way, Packet* pkt);
 
+        /* Prefetch path (issued unless miss path waits for AITManager) */
+        DataPrefetcher* prefetcher;
+        ncycle_t wake_pf;
+        ncycle_t last_wake_pf;
+
+        bool isMissPathFree( );
+        bool isPrefetchable( );
+        void schedule_prefetch( );
+        void cycle_prefetch( );
+        void issue_prefetch( );
+
+        /* Eager write-back (cleans dirty victims while PCM is lightly loaded) */
+        bool eager_wb;
+        uint64_t ewb_rmw_thres;     // max reqs in RMW
+        uint64_t ewb_ucmd_thres;    // max reqs in each uCMD engine
+        uint64_t ewb_cmdq_thres;    // max queued cmds in DataCache
+        uint64_t ewb_rdmiss_thres;  // max outstanding demand read misses
+        uint64_t rdmiss_inflight;   // demand read misses waiting for PCM
+        uint64_t ewb_ptr;           // next (set, $) position to scan
+        uint64_t ewb_scans;         // positions scanned w/o dirty victim in a row
+        Packet* ewb_pkt;            // write-back waiting for RMW to take data
+        ncycle_t wake_ewb;
+        ncycle_t last_wake_ewb;
+        std::vector<std::vector<bool>> ewb_clean; // [NUM][SET*WAY] cleaned eagerly
+
+        bool isEagerWBable( );
+        void schedule_ewb( );
+        void cycle_ewb( );
+        void issue_ewb(uint64_t cidx, uint64_t set, int64_t way);
+
         /* Cache definition */
         uint64_t num_cache;
         uint64_t bit_sets;
@@ -155,8 +181,10 @@ namespace PCMCsim
         int status;
         bool write_only;
         bool write_alloc;
+        bool gather_evct;   // evict dirty sectors of a page together
 
-        std::vector<std::vector<std::vector<entry_t>>> cache; // [NUM][SET][WAY]
+        std::vector<TagArray*> tags;                            // [NUM]
+        std::vector<std::vector<std::vector<DataBlock>>> dmem;  // [NUM][SET][WAY]
         std::vector<ReplacePolicy*> victim_policy;
 
         uint64_t get_cache_idx(uint64_t addr); // 0: even cache, 1: odd cache
@@ -186,6 +214,10 @@ namespace PCMCsim
         uint64_t write_hit;
         uint64_t write_miss;
         uint64_t num_evct;
+        uint64_t num_evct_sector;   // dirty sectors gathered into evictions
+        uint64_t num_ewb;           // eager write-backs
+        uint64_t num_ewb_redirty;   // eagerly cleaned lines written again
+        uint64_t num_ewb_saved;     // misses finding an eagerly cleaned victim
         uint64_t num_wait_rdresp;   // read-hit pended by read response
         uint64_t num_persist;
         uint64_t num_wait_rsvd;
@@ -213,6 +245,10 @@ namespace PCMCsim
         ncycle_t min_rdmiss_lat;
         double avg_rdmiss_lat;
 
+        uint64_t num_evct_stall;
+        double avg_evct_stall;      // pipe stall of a dirty-victim eviction
+        double ewb_saved_stall;     // evictions saved x avg eviction stall
+
         uint64_t num_wrget;
         ncycle_t max_wrget_lat;
         ncycle_t min_wrget_lat;
@@ -0,0 +1,165 @@
+#include "base/MemoryControlSystem.h"
+#include "base/Packet.h"
+#include "base/EventQueue.h"
+#include "base/MemInfo.h"
+#include "DataCache/DataPrefetcher.h"
+
+using namespace PCMCsim;
+
+DataPrefetcher::DataPrefetcher(MemoryControlSystem* memsys_, std::string cfg_header)
+:Prefetcher(memsys_, cfg_header, 8, 16)
+{
+    distance = memsys->getParamUINT64(cp_name+".distance", 8);
+    if (distance==0)
+    {
+        std::cerr << "[DCPF] Error! Invalid prefetcher configuration" << std::endl;
+        assert(0);
+        exit(1);
+    }
+
+    /* Page geometry (prefetch never exceeds the range of host reqs) */
+    PAGE_OFFSET = memsys->adec->PAGE_OFFSET;
+    PAGE_SIZE = memsys->info->PAGE_SIZE;
+    num_lines = memsys->info->get_capacity_bits( ) >> PAGE_OFFSET;
+
+    uint64_t buffer_size_bits = memsys->getParamUINT64("reqRecv.buffer_size_bits", 7);
+    pf_id_base = 2*(1<<buffer_size_bits);
+}
+
+DataPrefetcher::~DataPrefetcher( )
+{
+}
+
+int DataPrefetcher::lookup(Packet* pkt)
+{
+    assert(pkt->cmd==CMD_READ);
+    int rv = PB_MISS;
+    int64_t idx = find_pb(pkt->LADDR>>PAGE_OFFSET);
+    if (idx>=0 && pb[idx].inflight==false)
+    {
+        /* Copy the whole page as a read response from RMW */
+        pkt->buffer_data = pb[idx].data;
+        pkt->pb_hit = true;
+
+        num_pb_hit += 1;
+        rv = PB_HIT;
+    }
+    else if (idx>=0)
+    {
+        /* Late prefetch: wait for the page */
+        pb[idx].waiters.push_back(pkt);
+        num_pb_wait += 1;
+        rv = PB_WAIT;
+    }
+    else
+    {
+        /* Demand miss has overtaken the candidate */
+        std::deque<uint64_t>::iterator it = 
+            std::find(pfq.begin( ), pfq.end( ), pkt->LADDR>>PAGE_OFFSET);
+        if (it!=pfq.end( ))
+            pfq.erase(it);
+    }
+
+    count_lookup(idx);
+
+    PCMC_DBG(dbg_msg, "[DCPF] Lookup [0x%lx, ID=%lx] in PB: %s\n", pkt->LADDR, 
+        pkt->req_id, (rv==PB_HIT)? "HIT":((rv==PB_WAIT)? "WAIT":"MISS"));
+
+    return rv;
+}
+
+void DataPrefetcher::train(uint64_t addr)
+{
+    /* Streams are tracked by page (host reads within a page are no stride) */
+    uint64_t page = addr >> PAGE_OFFSET;
+    stream_t* s = train_stream(page);
+    if (s==NULL)
+        return;
+
+    /* Generate candidates */
+    if (s->conf>=2)
+    {
+        /* 
+         * Pages along the stride up to distance ahead of the access,
+         * continuing from the last page queued for the stream
+         */
+        int64_t ahead = ((int64_t)s->pf_addr-(int64_t)page)/s->stride;
+        if (ahead<0)
+            s->pf_addr = page;
+
+        for (uint64_t k=0; k<degree; k++)
+        {
+            ahead = ((int64_t)s->pf_addr-(int64_t)page)/s->stride;
+            if (ahead>=(int64_t)distance ||
+                (s->stride<0 && (uint64_t)(-s->stride)>s->pf_addr))
+                break;
+            s->pf_addr += s->stride;
+            push_candidate(s->pf_addr);
+        }
+    }
+}
+
+uint64_t DataPrefetcher::issue_candidate(id_t& pf_id)
+{
+    uint64_t page;
+    int64_t idx = alloc_pb(page);
+
+    /* An entry in flight is never reallocated, so its ID is unique */
+    pf_id = (id_t)(pf_id_base+idx);
+
+    PCMC_DBG(dbg_msg, "[DCPF] Issue prefetch of page 0x%lx (PB=%ld)\n",
+        page<<PAGE_OFFSET, idx);
+
+    return (page<<PAGE_OFFSET);
+}
+
+void DataPrefetcher::fill(Packet* pkt, std::vector<Packet*>& waiters)
+{
+    assert(pkt->is_prefetch && pkt->buffer_data.getSize( )==PAGE_SIZE);
+    assert(pkt->req_id>=(id_t)pf_id_base && pkt->req_id<(id_t)(pf_id_base+size_pb));
+    uint64_t idx = (uint64_t)pkt->req_id-pf_id_base;
+    assert(pb[idx].valid && pb[idx].inflight);
+
+    pb[idx].inflight = false;
+    pb[idx].data = pkt->buffer_data;
+
+    /* Serve the reads that have waited */
+    for (uint64_t w=0; w<pb[idx].waiters.size( ); w++)
+    {
+        Packet* wpkt = pb[idx].waiters[w];
+        wpkt->buffer_data = pb[idx].data;
+        wpkt->pb_hit = true;
+        waiters.push_back(wpkt);
+    }
+    pb[idx].waiters.clear( );
+
+    /* Page has been written while in flight */
+    if (pb[idx].stale)
+    {
+        pb[idx].valid = false;
+        pb[idx].stale = false;
+        num_pf_stale += 1;
+    }
+
+    PCMC_DBG(dbg_msg, "[DCPF] Fill page 0x%lx to PB=%ld, %lu waiters\n",
+        pkt->LADDR, idx, waiters.size( ));
+}
+
+void DataPrefetcher::invalidate(uint64_t addr)
+{
+    /* 
+     * Reads waiting in the entry precede the write, so the entry in 
+     * flight only becomes stale and it is still filled for them
+     */
+    int64_t idx = find_pb(addr>>PAGE_OFFSET);
+    if (idx>=0 && pb[idx].inflight)
+        pb[idx].stale = true;
+    else if (idx>=0)
+        pb[idx].valid = false;
+
+    /* Candidates of the page are stale as well */
+    std::deque<uint64_t>::iterator it = 
+        std::find(pfq.begin( ), pfq.end( ), addr>>PAGE_OFFSET);
+    if (it!=pfq.end( ))
+        pfq.erase(it);
+}
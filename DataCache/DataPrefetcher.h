@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2019 Computer Architecture and Paralllel Processing Lab, 
+ * Seoul National University, Republic of Korea. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     1. Redistribution of source code must retain the above copyright 
+ *        notice, this list of conditions and the follwoing disclaimer.
+ *     2. Redistributions in binary form must reproduce the above copyright 
+ *        notice, this list conditions and the following disclaimer in the 
+ *        documentation and/or other materials provided with the distirubtion.
+ *     3. Neither the name of the copyright holders nor the name of its 
+ *        contributors may be used to endorse or promote products derived from 
+ *        this software without specific prior written permission. 
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Description: This is a data prefetcher for DataCache.
+ * It watches the page stream of demand read misses and issues page reads
+ * marked as prefetch through AITManager and ReadModifyWrite. Returned
+ * pages are kept in a prefetch buffer (PB) next to the cache, so that
+ * a streaming read does not pollute the cache lines
+ * > stride: a small table tracks streams by page proximity; a confirmed
+ *   stride prefetches pages along the stride, up to distance ahead
+ * > throttling: degree (pages queued per access) is adjusted by the
+ *   accuracy (see Prefetcher)
+ * A read miss whose page is still being prefetched waits in the PB entry.
+ * Written or evicted pages are invalidated in the PB
+ */
+
+#ifndef __PCMCSIM_DATA_PREFETCHER_H_
+#define __PCMCSIM_DATA_PREFETCHER_H_
+
+#include "base/PCMCTypes.h"
+#include "base/Prefetcher.h"
+
+namespace PCMCsim
+{
+    class MemoryControlSystem;
+    class Packet;
+
+    class DataPrefetcher : public Prefetcher
+    {
+      public:
+        DataPrefetcher(MemoryControlSystem* memsys_, std::string cfg_header);
+        ~DataPrefetcher( );
+
+        /* Interface for DataCache */
+        int lookup(Packet* pkt);
+        void train(uint64_t addr);
+        uint64_t issue_candidate(id_t& pf_id);
+        void fill(Packet* pkt, std::vector<Packet*>& waiters);
+        void invalidate(uint64_t addr);
+
+      private:
+        uint64_t PAGE_OFFSET;
+        uint64_t PAGE_SIZE;
+        uint64_t distance;          // strides to run ahead of the stream
+
+        /* 
+         * Prefetch reads share the ID space of DCACHE, BLKMGR, RMW, ...
+         * PB index is added to the base following the WIDs of DCACHE
+         */
+        uint64_t pf_id_base;
+    };
+};
+
+#endif
@@ -2,6 +2,7 @@
 #include "base/EventQueue.h"
 #include "base/Packet.h"
 #include "base/Stats.h"
+#include "base/ReqTracer.h"
 #include "DataPathUnit/DataPathUnit.h"
 #include "ReadModifyWrite/ReadModifyWrite.h"
 #include "uCMDEngine/uCMDEngine.h"
@@ -11,8 +12,8 @@ using namespace PCMCsim;
 
 DataPathUnit::DataPathUnit(MemoryControlSystem* memsys_, 
         std::string cfg_header, ncycle_t ticks_per_cycle_, uint64_t id_)
-: Component(memsys_), rmw(NULL), ucmde(NULL), ber_errors(0), ber_correct(0),
-ber_due(0), ber_sdc(0), ber_reads(0)
+: Component(memsys_), rmw(NULL), ucmde(NULL), retain_wdata(false),
+ber_errors(0), ber_correct(0), ber_due(0), ber_sdc(0), ber_reads(0), num_resent(0)
 {
     id = id_;
     cp_name = cfg_header + "[" + std::to_string(id) + "]";
@@ -38,6 +39,15 @@ ber_due(0), ber_sdc(0), ber_reads(0)
 
 DataPathUnit::~DataPathUnit( )
 {
+    std::map<uint64_t, Packet*>::iterator iter = dpu_retained.begin( );
+    for ( ; iter!=dpu_retained.end( ); iter++)
+        delete iter->second;
+}
+
+void DataPathUnit::enable_retain_wdata( )
+{
+    retain_wdata = true;
+    ADD_STATS(cp_name, num_resent);
 }
 
 bool DataPathUnit::isReady(Packet* pkt)
@@ -60,6 +70,7 @@ bool DataPathUnit::isReady(Packet* pkt)
 void DataPathUnit::recvRequest(Packet* pkt, ncycle_t delay)
 {
     ncycle_t LAT=delay+tECC_WR;
+    PCMC_TRACE(pkt, TRC_DPU, geq->getCurrentTick( )+delay*ticks_per_cycle);
 
     if (((pkt->cmd==CMD_WRITE || pkt->cmd==CMD_WRITE_PRE) && 
           pkt->isDATA==false) ||
@@ -67,13 +78,41 @@ void DataPathUnit::recvRequest(Packet* pkt, ncycle_t delay)
     {
         std::map<uint64_t, Packet*>::iterator iter;
         iter=dpu_wbuf.find(pkt->buffer_idx);
-        assert(pkt->from==ucmde && iter!=dpu_wbuf.end( ));
+        assert(pkt->from==ucmde);
+        if (iter==dpu_wbuf.end( ))
+        {
+            /* Re-issue of a cancelled write: resend retained data */
+            iter = dpu_retained.find(pkt->buffer_idx);
+            assert(retain_wdata && iter!=dpu_retained.end( ));
+            Packet* resend_pkt = new Packet( );
+            *resend_pkt = *(iter->second);
+
+            PCMC_DBG(dbg_msg,"[DPU] Resend data of WB_ID=%lx to Media\n",
+                pkt->buffer_idx);
+
+            media->recvRequest(resend_pkt, tBURST);
+            num_resent += 1;
+            return;
+        }
         media_wr_pkt = iter->second;
 
         PCMC_DBG(dbg_msg,"[DPU] Req [0x%lx, ID=%lx, CMD=BWT] "
             "from ucmde of WB_ID=%lx has Wrote to Media\n", 
             media_wr_pkt->LADDR, pkt->req_id, media_wr_pkt->buffer_idx);
 
+        if (retain_wdata)
+        {
+            /* wbuffer id is occupied until ucmde retires it */
+            Packet* retained_pkt = new Packet( );
+            *retained_pkt = *media_wr_pkt;
+            retained_pkt->owner = this;
+            dpu_retained.insert(
+                std::pair<uint64_t,Packet*>(pkt->buffer_idx, retained_pkt));
+            media->recvRequest(media_wr_pkt, tBURST);
+            dpu_wbuf.erase(iter);
+            return;
+        }
+
         /* Issue wdata pkt to media, and confer new wbuffer id to RMW */
         media->recvRequest(media_wr_pkt, tBURST);
 
@@ -82,6 +121,18 @@ void DataPathUnit::recvRequest(Packet* pkt, ncycle_t delay)
         if (wbid_stalled)
             confer_wbid2rmw( );
     }
+    else if (pkt->cmd==CMD_WACK_ID)             // retire retained data
+    {
+        std::map<uint64_t, Packet*>::iterator iter;
+        iter = dpu_retained.find(pkt->buffer_idx);
+        assert(pkt->from==ucmde && iter!=dpu_retained.end( ));
+        delete iter->second;
+        dpu_retained.erase(iter);
+
+        dpu_wbuf_index.erase(pkt->buffer_idx);
+        if (wbid_stalled)
+            confer_wbid2rmw( );
+    }
     else if (pkt->cmd==CMD_WRITE && pkt->isDATA)  //Write from RMW
     {
         PCMC_DBG(dbg_msg,"[DPU] Get Req-Write [0x%lx, ID=%lx, CMD=W, "
@@ -97,7 +148,16 @@ void DataPathUnit::recvRequest(Packet* pkt, ncycle_t delay)
 
 void DataPathUnit::recvResponse(Packet* pkt, ncycle_t delay)
 {
+    if (pkt->cmd==CMD_PKT_DEL)
+    {
+        /* Resent data of cancelled writes */
+        assert(pkt->owner==this);
+        delete pkt;
+        return;
+    }
+
     assert(pkt->cmd==CMD_READ);
+    PCMC_TRACE(pkt, TRC_DPU, geq->getCurrentTick( )+delay*ticks_per_cycle);
     Component::recvResponse(pkt, delay);
 }
 
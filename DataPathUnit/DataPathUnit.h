@@ -68,6 +68,9 @@ namespace PCMCsim
         //Component* emu;
         Component* media;
 
+        /* Keep write data until ucmde retires it (for write cancellation) */
+        void enable_retain_wdata( );
+
      private:
         /* Latencies */
         ncycle_t tECC_WR;
@@ -78,6 +81,8 @@ namespace PCMCsim
         std::map<uint64_t, Packet*> dpu_wbuf;
         std::set<uint64_t> dpu_wbuf_index;
         std::queue<Packet*> dpu_rbuf;
+        std::map<uint64_t, Packet*> dpu_retained; // programming write data
+        bool retain_wdata;
 
         uint64_t dpu_wbuf_size;
         uint64_t dpu_rbuf_size;
@@ -108,6 +113,7 @@ namespace PCMCsim
         uint64_t ber_due;       // detected uncorrectable errors
         uint64_t ber_sdc;       // silent data corruption (not awared by ECC)
         uint64_t ber_reads;     // # of read bits
+        uint64_t num_resent;    // write data resent for cancelled writes
         
         void register_stats( ) override;
    };
@@ -75,9 +75,9 @@ void DummyAIT::handle_await_resps( )
 
 void DummyAIT::refer_data(Packet* pkt) 
 {
-    static uint64_t tx_line_bytes = 1 << tx_line_bits;
-    static uint64_t width_block = 1 << byte_offset;
-    static uint64_t num_blocks = 1 << (tx_line_bits-byte_offset); 
+    uint64_t tx_line_bytes = 1 << tx_line_bits;
+    uint64_t width_block = 1 << byte_offset;
+    uint64_t num_blocks = 1 << (tx_line_bits-byte_offset); 
 
     /* Linearly map address as data initially */
     uint64_t mem_addr = get_addr(pkt->LADDR);
@@ -136,6 +136,6 @@ uint64_t DummyAIT::get_addr(uint64_t addr)
 
 uint64_t DummyAIT::get_block(uint64_t addr)
 {
-    static uint64_t num_blocks =  1 << (tx_line_bits-byte_offset); 
+    uint64_t num_blocks =  1 << (tx_line_bits-byte_offset); 
     return ((addr >> (tx_line_bits-byte_offset)) % num_blocks);
 }
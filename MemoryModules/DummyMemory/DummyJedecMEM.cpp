@@ -2,6 +2,7 @@
 #include "base/Packet.h"
 #include "base/EventQueue.h"
 #include "base/MemInfo.h"
+#include "base/ReqTracer.h"
 #include "MemoryModules/DummyMemory/DummyJedecMEM.h"
 
 using namespace PCMCsim;
@@ -29,6 +30,7 @@ DummyJedecMEM::DummyJedecMEM(MemoryControlSystem* memsys_, std::string cfg_heade
 
 void DummyJedecMEM::recvRequest(Packet* pkt, ncycle_t delay)
 {
+    PCMC_TRACE(pkt, TRC_MEDIA, geq->getCurrentTick( )+delay*ticks_per_cycle);
     switch (pkt->cmd)
     {
         case CMD_ACT:
@@ -87,6 +89,14 @@ void DummyJedecMEM::recvRequest(Packet* pkt, ncycle_t delay)
                     pkt->buffer_data = tmp_data;
                 }
 
+                /* Data-only write (no meta carried) keeps the stored meta */
+                if (meta_enable && pkt->buffer_meta.getSize( )==0)
+                {
+                    pkt->buffer_meta = get_stored_meta(pkt->PADDR);
+                    if (pkt->buffer_meta.getSize( )==0)
+                        pkt->buffer_meta.setSize(META_SIZE);
+                }
+
                 if (data_enable)
                     set_stored(pkt->PADDR, true_enable, 
                         &(pkt->buffer_data), &(pkt->buffer_meta));
@@ -59,6 +59,15 @@ DataBlock DummyMemory::get_stored(uint64_t PA)
     return ret;
 }
 
+DataBlock DummyMemory::get_stored_meta(uint64_t PA)
+{
+    DataBlock ret;
+    if (store_data.count(PA)>0 && store_data[PA].second!=NULL)
+        ret = *(store_data[PA].second);
+
+    return ret;
+}
+
 void DummyMemory::set_stored(uint64_t PA, bool set_true, DataBlock* data, DataBlock* meta)
 {
     if (data_enable==false)
@@ -55,6 +55,7 @@ namespace PCMCsim
 
         bool get_stored(Packet* pkt);
         DataBlock get_stored(uint64_t PADDR);
+        DataBlock get_stored_meta(uint64_t PADDR);
         void set_stored(uint64_t PADDR, bool set_true, DataBlock* data, DataBlock* meta=NULL);
         bool get_true(Packet* pkt);
  
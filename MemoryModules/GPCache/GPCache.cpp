@@ -3,10 +3,13 @@
 #include "base/PipeBufferv2.h"
 #include "base/EventQueue.h"
 #include "base/Stats.h"
+#include "base/TagArray.h"
 #include "MemoryModules/GPCache/GPCache.h"
 #include "ReplacePolicy/TrueLRU/TrueLRU.h"
 #include "ReplacePolicy/PseudoLRU/PseudoLRU.h"
 #include "ReplacePolicy/RoundRobin/RoundRobin.h"
+#include "ReplacePolicy/RRIP/RRIP.h"
+#include "ReplacePolicy/SHiP/SHiP.h"
 
 using namespace PCMCsim;
 
@@ -41,13 +44,11 @@ free_resp(0), status(NO_STALL)
     num_ways = memsys->getParamUINT64(cfg_header+".num_ways", 4);
     size_cmdq = memsys->getParamUINT64(cfg_header+".size_cmdq", 2);
     size_missq = memsys->getParamUINT64(cfg_header+".size_missq", 16);
-    tmem.resize(num_sets);
+    tmem = new TagArray(num_sets, num_ways);
     dmem.resize(num_sets);
     for (uint64_t s = 0; s < num_sets; s++)
     {
-        tmem_t e_tag {false, false, false, 0};
         DataBlock e_data;
-        tmem[s].resize(num_ways, e_tag);
         dmem[s].resize(num_ways, e_data);
     }
     assert(bypass || (num_sets>0 && num_ways>=1 && size_cmdq>=2 && size_missq>=1));
@@ -60,6 +61,8 @@ free_resp(0), status(NO_STALL)
     }
 
     std::string got_policy = memsys->getParamSTR(cfg_header+".policy");
+    /* SHiP signature is a coarse region (not a line tag) to be shared */
+    uint64_t ship_region_bits = memsys->getParamUINT64(cfg_header+".ship_region_bits", 14);
     victim_policy = NULL;
     if (got_policy=="TRUE_LRU")
         victim_policy = new TrueLRU(num_sets, num_ways);
@@ -67,6 +70,14 @@ free_resp(0), status(NO_STALL)
         victim_policy = new PseudoLRU(num_sets, num_ways);
     else if (got_policy == "ROUND_ROBIN")
         victim_policy = new RoundRobin(num_sets, num_ways);
+    else if (got_policy == "SRRIP")
+        victim_policy = new RRIP(num_sets, num_ways, RRIP::MODE_SRRIP);
+    else if (got_policy == "BRRIP")
+        victim_policy = new RRIP(num_sets, num_ways, RRIP::MODE_BRRIP);
+    else if (got_policy == "DRRIP")
+        victim_policy = new RRIP(num_sets, num_ways, RRIP::MODE_DRRIP);
+    else if (got_policy == "SHIP")
+        victim_policy = new SHiP(num_sets, num_ways, ship_region_bits);
     else
         assert(0);
 
@@ -113,6 +124,7 @@ GPCache::~GPCache( )
 {
     delete pipe_access;
     delete victim_policy;
+    delete tmem;
 }
 
 bool GPCache::isReady(Packet* /*pkt*/)
@@ -308,16 +320,9 @@ void GPCache::get_cache_position(uint64_t& sidx, int64_t& widx, Packet* proc_pkt
 {
     sidx = get_set_idx(proc_pkt->LADDR);
     uint64_t tag = get_tag(proc_pkt->LADDR);
-    for (uint64_t w = 0; w < num_ways; w++)
-    {
-        if (tmem[sidx][w].valid==false) continue;
-
-        if (tmem[sidx][w].tag==tag)
-        {
-            widx = (int64_t)w;
-            break;
-        }
-    }
+    int64_t hit_way = tmem->find(sidx, tag);
+    if (hit_way>=0)
+        widx = hit_way;
 
     Esr+=Esrpa;
 }
@@ -326,6 +331,16 @@ void GPCache::handle_hitmiss(bool hit, int64_t hit_way, Packet* pkt)
 {
     assert(status==NO_STALL);
 
+    /* Prefetch is served on hit, otherwise bypassed w/o allocation */
+    if (pkt->is_prefetch)
+    {
+        if (hit)
+            hit_handle(pkt, hit_way);
+        else
+            prefetch_bypass(pkt);
+        return;
+    }
+
     /* Hit/miss handling */
     if (hit==false)
         miss_handle(pkt);
@@ -366,10 +381,15 @@ void GPCache::hit_handle(Packet* pkt, int64_t hit_way)
 
     if (pkt->cmd==CMD_READ)
     {
-        /* Get partial data for read response */
-        pkt->buffer_data.setSize(width_block);
-        for (uint64_t i = 0; i < width_block; i++)
-            pkt->buffer_data.setByte(i, dmem[s][w].getByte(blk*width_block+i));
+        /* Get partial data for read response (whole line for prefetch) */
+        if (pkt->is_prefetch)
+            pkt->buffer_data = dmem[s][w];
+        else
+        {
+            pkt->buffer_data.setSize(width_block);
+            for (uint64_t i = 0; i < width_block; i++)
+                pkt->buffer_data.setByte(i, dmem[s][w].getByte(blk*width_block+i));
+        }
     
         /* Check if read-resp port is available (HIGHER priority to fillq) */
         if (isRespPortAvailable( ))
@@ -401,10 +421,29 @@ void GPCache::hit_handle(Packet* pkt, int64_t hit_way)
     else
         assert(0);
 
-    victim_policy->update_victim(s, w);
+    if (pkt->is_prefetch==false)
+        victim_policy->update_victim(s, w);
     status = nxt_status;
 }
 
+void GPCache::prefetch_bypass(Packet* pkt)
+{
+    assert(pkt->cmd==CMD_READ);
+    if (missq.size( )<size_missq)
+    {
+        missq.push_back(pkt);
+        status = NO_STALL;
+
+        PCMC_DBG(dbg_msg, "[GPC] Prefetch [0x%lx, ID=%lx] bypassed\n",
+            pkt->LADDR, pkt->req_id);
+    }
+    else
+    {
+        status = WAIT_MISSQ;
+        pipe_access->prgm_stall = true;
+    }
+}
+
 void GPCache::miss_handle(Packet* pkt)
 {
     signals_t* pb_signals = 
@@ -483,20 +522,20 @@ int GPCache::gpc_alloc(Packet* pkt)
          (write_alloc==false && missq.size( )<size_missq-2)))   // ev+rd
     {
         /* Check dirtiness */
-        if (tmem[s][w].dirty)
+        if (tmem->is_dirty(s, w))
         {
             Packet* ev_pkt = new Packet( );
             ev_pkt->cmd = CMD_WRITE;
             ev_pkt->owner = this;
             ev_pkt->isDATA = true;
-            ev_pkt->LADDR = (tmem[s][w].tag<<(cline_bits+bit_sets)) | (s<<cline_bits);
+            ev_pkt->LADDR = (tmem->get_tag(s, w)<<(cline_bits+bit_sets)) | (s<<cline_bits);
             ev_pkt->req_id = pkt->req_id;
             ev_pkt->buffer_data.setSize(cline_bytes);
             for (uint64_t i = 0; i < cline_bytes; i++)
                 ev_pkt->buffer_data.setByte(i, dmem[s][w].getByte(i));
 
             missq.push_back(ev_pkt);
-            tmem[s][w].dirty = false;
+            tmem->set_dirty(s, w, false);
             
             /* Stats update */
             num_evct+=1;
@@ -504,10 +543,10 @@ int GPCache::gpc_alloc(Packet* pkt)
         }
 
         /* Allocate cache block */
-        tmem[s][w].tag = get_tag(pkt->LADDR);
-        tmem[s][w].valid = true;
+        tmem->set_tag(s, w, get_tag(pkt->LADDR));
+        tmem->set_valid(s, w, true);
         victim_policy->set_rsvd(s, w);
-        victim_policy->update_victim(s, w);
+        victim_policy->insert_victim(s, w, pkt->LADDR);
 
         /* Link way # and MSHR entry */
         uint64_t pkt_addr = pkt->LADDR >> cline_bits;
@@ -757,10 +796,13 @@ void GPCache::cycle_fillq( )
         assert(proc_pkt->owner!=this && proc_pkt->cmd==CMD_READ);
         uint64_t blk = get_block(proc_pkt->LADDR);
         
-        DataBlock tmp_data = proc_pkt->buffer_data;
-        proc_pkt->buffer_data.setSize(width_block);
-        for (uint64_t i = 0; i < width_block; i++)
-            proc_pkt->buffer_data.setByte(i, tmp_data.getByte(blk*width_block+i));
+        if (proc_pkt->is_prefetch==false)
+        {
+            DataBlock tmp_data = proc_pkt->buffer_data;
+            proc_pkt->buffer_data.setSize(width_block);
+            for (uint64_t i = 0; i < width_block; i++)
+                proc_pkt->buffer_data.setByte(i, tmp_data.getByte(blk*width_block+i));
+        }
 
         sendParentResp(proc_pkt, tRESP);
         fillq.pop_front( );
@@ -789,7 +831,7 @@ void GPCache::cycle_fillq( )
     uint64_t s = 0; int64_t w = -1;
     get_cache_position(s, w, proc_pkt);
 
-    assert(write_only || (w>=0 && tmem[s][w].tag==get_tag(proc_pkt->LADDR)));
+    assert(write_only || (w>=0 && tmem->get_tag(s, w)==get_tag(proc_pkt->LADDR)));
 
     /* Find MSHR for merged request & determine processing packet */
     uint64_t pkt_addr = proc_pkt->LADDR >> cline_bits;
@@ -896,7 +938,7 @@ void GPCache::cycle_fillq( )
         if (w>=0)
         {
             victim_policy->unset_rsvd(s, w);
-            victim_policy->update_victim(s, w);
+            victim_policy->insert_victim(s, w, pkt_addr<<cline_bits);
         }
 
         /* If all merged reqs are processed, delete whole MSHR entry */
@@ -998,7 +1040,7 @@ void GPCache::fill_line(uint64_t s, int64_t w, Packet* pkt)
 {
     assert(w>=0);
     if (pkt->cmd==CMD_WRITE)
-        tmem[s][w].dirty = true;
+        tmem->set_dirty(s, w, true);
 
     if (num_blocks!=1 && pkt->buffer_data.getSize( )==width_block)
     {
@@ -1084,18 +1126,18 @@ void GPCache::register_stats( )
     ADD_STATS(cp_name, read_miss);
     ADD_STATS(cp_name, write_hit);
     ADD_STATS(cp_name, write_miss);
-    ADD_STATS(cp_name, read_miss_rate);
-    ADD_STATS(cp_name, write_miss_rate);
-    ADD_STATS(cp_name, overall_miss_rate);
+    ADD_STATS_LEVEL(cp_name, read_miss_rate);
+    ADD_STATS_LEVEL(cp_name, write_miss_rate);
+    ADD_STATS_LEVEL(cp_name, overall_miss_rate);
     ADD_STATS(cp_name, mshr_hit);
     ADD_STATS(cp_name, mshr_miss);
     ADD_STATS(cp_name, mshr_subentry_full);
     ADD_STATS(cp_name, num_evct);
     ADD_STATS_N_UNIT(cp_name, num_wait_rsvd, "cycles");
     ADD_STATS_N_UNIT(cp_name, num_wait_rdresp, "cycles");
-    ADD_STATS_N_UNIT(cp_name, max_wait_rdresp, "cycles");
-    ADD_STATS_N_UNIT(cp_name, min_wait_rdresp, "cycles");
-    ADD_STATS_N_UNIT(cp_name, avg_wait_rdresp, "cycles");
+    ADD_STATS_LAT(cp_name, max_wait_rdresp);
+    ADD_STATS_LAT(cp_name, min_wait_rdresp);
+    ADD_STATS_LAT(cp_name, avg_wait_rdresp);
     ADD_STATS_N_UNIT(cp_name, Esr, "nJ");
     ADD_STATS_N_UNIT(cp_name, Erd, "nJ");
     ADD_STATS_N_UNIT(cp_name, Ewr, "nJ");
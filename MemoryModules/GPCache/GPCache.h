@@ -62,6 +62,7 @@ namespace PCMCsim
     class PipeBufferv2;
     class Packet;
     class ReplacePolicy;
+    class TagArray;
 
     class GPCache : public Component
     {
@@ -96,14 +97,6 @@ namespace PCMCsim
             NUM_STATUS
         };
 
-        typedef struct _tmem_t
-        {
-            bool valid;
-            bool dirty;
-            bool rsvd;
-            uint64_t tag;
-        } tmem_t;
-
         typedef struct _mshr_t
         {
             bool cline_filled;      // cache line is filled w/ data
@@ -135,6 +128,7 @@ namespace PCMCsim
         void hit_handle(Packet* pkt, int64_t hit_way);
         void hit_wdata(Packet* pkt, int64_t hit_way);
         void miss_handle(Packet* pkt);
+        void prefetch_bypass(Packet* pkt);
         void stall_handle(Packet* pkt, int64_t hit_way);
         void cycle_missq( );
        
@@ -164,7 +158,7 @@ namespace PCMCsim
         bool write_only;
         bool write_alloc;
 
-        std::vector<std::vector<tmem_t>> tmem;   // [SET][WAY]
+        TagArray* tmem;                         // [SET][WAY]
         std::vector<std::vector<DataBlock>> dmem;
         std::set<mshr_t*> mshr;
 
@@ -2,6 +2,7 @@
 #include "base/MemInfo.h"
 #include "base/Packet.h"
 #include "base/EventQueue.h"
+#include "base/ReqTracer.h"
 #include "Parsers/Parser.h"
 
 using namespace PCMCsim;
@@ -12,6 +13,13 @@ Parser::Parser(MemoryControlSystem* memsys_, std::string cfg_header)
     cp_name = cfg_header;
     dbg_msg = memsys->getParamBOOL(cp_name+".dbg_msg", false);
     ticks_per_cycle= memsys->getParamUINT64("global.ticks_per_cycle", 1);
+    num_ports = memsys->getParamUINT64(cp_name+".num_ports", 1);
+    if (num_ports==0)
+    {
+        std::cerr << "[Parser] Error! num_ports should be at least 1" << std::endl;
+        assert(0);
+        exit(1);
+    }
 }
 
 Parser::~Parser( )
@@ -24,6 +32,9 @@ void Parser::recvRequest(Packet* pkt, ncycle_t delay)
     if (memsys->sys_name=="DRAM")
         ch = memsys->adec->decode_addr(pkt->LADDR, FLD_CH);
 
+    if (memsys->tracer && pkt->src_id==SRC_HOST)
+        memsys->tracer->sample(pkt, geq->getCurrentTick( ));
+
     paths[ch]->recvRequest(pkt, delay);
     
     PCMC_DBG(dbg_msg, "[Parser] Dispatch [LA=0x%lx, PA=%lx, ID=%ld]\n",
@@ -42,6 +53,9 @@ void Parser::recvResponse(Packet* pkt, ncycle_t delay)
         (pkt->cmd==CMD_READ)? "Make RD-resp":"Virtual resp", 
         pkt->LADDR, pkt->PADDR, pkt->req_id);
 
+    if (memsys->tracer)
+        memsys->tracer->finish(pkt, geq->getCurrentTick( )+delay*ticks_per_cycle);
+
     memsys->recvResponse(pkt, delay);
 }
 
@@ -67,3 +81,11 @@ void Parser::expand_path(Component* c)
     paths.push_back(c);
 }
 
+uint64_t Parser::get_port(Packet* pkt)
+{
+    uint64_t rv = 0;
+    if (pkt->src_id==SRC_HOST && pkt->tid>=0)
+        rv = (uint64_t)pkt->tid % num_ports;
+    return rv;
+}
+
@@ -19,6 +19,10 @@ namespace PCMCsim
         void handle_events(ncycle_t curr_tick) override;
         virtual void expand_path(Component* c);
 
+        /* Host ports (agents), host requests are classified by thread ID */
+        uint64_t num_ports;
+        uint64_t get_port(Packet* pkt);
+
         ncycle_t last_rdresp;
         
         std::vector<Component*> paths;
@@ -5,6 +5,7 @@
 #include "base/Stats.h"
 #include "base/MemInfo.h"
 #include "base/PCMInfo.h"
+#include "base/ReqTracer.h"
 #include "ReadModifyWrite/ReadModifyWrite.h"
 #include "AITManager/AITManager.h"
 #include "DataCache/DataCache.h"
@@ -22,12 +23,12 @@ typedef struct _signals_t
 
 ReadModifyWrite::ReadModifyWrite(MemoryControlSystem* memsys_, std::string cfg_header): 
 Component(memsys_), dcache(NULL), aitm(NULL), errMgr(NULL), 
-ucmde(NULL), dpu(NULL), mcu(NULL), need_wakeup(true), num_blkmgr_ctrl(0),
+mcu(NULL), need_wakeup(true), num_blkmgr_ctrl(0),
 src_id_IA(0), st_inArbtr(ST_NORMAL), st_hzdCheck(NO_STALL),
 flushRMW_RD(false), flushRMW_WR(false), flushCntRMW_RD(0), flushCntRMW_WR(0),
-starvCntRMW_RD(0), starvCntRMW_WR(0), wbuffer_idx_dpu(0), wake_outArbtr(0), 
+starvCntRMW_RD(0), starvCntRMW_WR(0), wake_outArbtr(0), 
 last_wake_outArbtr(0), free_outArbtr(0), wake_wdcache(0), 
-last_wake_wdcache(0), free_wdcache(0), wake_rdbuf(0), last_wake_rdbuf(0), 
+last_wake_wdcache(0), free_wdcache(0), size_all_dbuf(0), wake_rdbuf(0), last_wake_rdbuf(0), 
 free_rdbuf(0), wake_wdbuf(0), last_wake_wdbuf(0), free_wdbuf(0) 
 {
     assert(memsys);
@@ -70,6 +71,17 @@ free_rdbuf(0), wake_wdbuf(0), last_wake_wdbuf(0), free_wdbuf(0)
     size_rmwq = memsys->getParamUINT64(cp_name+".size_rmwq", 64);    
     assert(size_rmwq>0);
 
+    wcb_size = memsys->getParamUINT64(cp_name+".wcb_size", 0);
+    wcb_window = memsys->getParamUINT64(cp_name+".wcb_window", 64);
+    wcb_skip_full = memsys->getParamBOOL(cp_name+".wcb_skip_full", true);
+    if (wcb_size>0 && (wcb_size>=size_rmwq || wcb_window==0))
+    {
+        std::cerr << "[RMW] Error! wcb_size should be smaller than size_rmwq "
+            << "and wcb_window should be positive" << std::endl;
+        assert(0);
+        exit(1);
+    }
+
     size_dbuf.resize(numReqPorts);
     base_dbuf.resize(numReqPorts);
     for (uint64_t i=0; i<numReqPorts; i++)
@@ -111,6 +123,15 @@ free_rdbuf(0), wake_wdbuf(0), last_wake_wdbuf(0), free_wdbuf(0)
 
     /* Pipeline buffers on main path */
     pipe_hzdCheck = new PipeBufferv2( );
+
+    /* Channel steering (uCMDE & DPU are connected per channel) */
+    num_channels = memsys->info->get_channels( );
+    assert(num_channels>0);
+    ucmde.resize(num_channels, NULL);
+    dpu.resize(num_channels, NULL);
+    wbuffer_idx_dpu.resize(num_channels, 0);
+    num_issue_ch_RD = new uint64_t[num_channels];
+    num_issue_ch_WR = new uint64_t[num_channels];
     
     /* Hard-fixed params */
     size_nonHzdHostRD_cmdq = 1;
@@ -124,6 +145,8 @@ free_rdbuf(0), wake_wdbuf(0), last_wake_wdbuf(0), free_wdbuf(0)
 ReadModifyWrite::~ReadModifyWrite( )
 {
     delete pipe_hzdCheck;
+    delete [] num_issue_ch_RD;
+    delete [] num_issue_ch_WR;
     
     for (uint64_t i=0; i<size_all_dbuf; i++)
     {
@@ -139,6 +162,7 @@ ReadModifyWrite::rmwqe_t::rmwqe_t( )
     issuable = false;
     RD_issued = false;
     RD_only = false;
+    wcb_expire = 0;
     remap_link.first = -1;
     remap_link.second = -1;
 }
@@ -160,6 +184,7 @@ ReadModifyWrite::dbe_t::dbe_t(uint64_t num_data)
     meta_issued = false;
     dvalid.resize(num_data, false);
     mvalid = false;
+    RD_skipped = false;
     pkt = NULL;
     HostHzdPkt_RD = NULL;
 }
@@ -189,6 +214,7 @@ void ReadModifyWrite::recvRequest(Packet* pkt, ncycle_t delay)
 
     cmdq[pkt->src_id].push(pkt);
     pkt->recvTick = geq->getCurrentTick( )+delay*ticks_per_cycle;
+    PCMC_TRACE(pkt, TRC_RMW, pkt->recvTick);
 
     /* Trigger protocol for BLKMV/SWP */
     if (pkt->src_id==SRC_HOST)
@@ -218,6 +244,7 @@ void ReadModifyWrite::recvResponse(Packet* pkt, ncycle_t delay)
      * It is always called from DPU/DCACHE after all RMW-events 
      * are processed according to data structure of the event queue
      */
+    PCMC_TRACE(pkt, TRC_RMW, geq->getCurrentTick( )+delay*ticks_per_cycle);
     if (pkt->cmd==CMD_PKT_DEL)
     {
         assert(pkt->owner==this);
@@ -225,7 +252,7 @@ void ReadModifyWrite::recvResponse(Packet* pkt, ncycle_t delay)
     }
     else if (pkt->cmd==CMD_WACK_ID)
         wack(pkt, CMD_WACK_ID);
-    else if (pkt->from==dynamic_cast<Component*>(dpu) ||
+    else if (get_dpu_ch(pkt->from)>=0 ||
              pkt->from==dynamic_cast<Component*>(dcache))
     {
         /* Will process received data according to source */
@@ -270,6 +297,14 @@ bool ReadModifyWrite::is_cmdq_empty( )
     return true;
 }
 
+uint64_t ReadModifyWrite::get_num_reqs( )
+{
+    uint64_t rv = rmwq.size( )+nonHzdHostRD_cmdq.size( );
+    for (uint64_t i = 0; i < NUM_SRC; i++)
+        rv += cmdq[i].size( );
+    return rv;
+}
+
 void ReadModifyWrite::execute( )
 {
     /* Execute main path sub-modules */
@@ -448,6 +483,7 @@ void ReadModifyWrite::non_hzd_handle(Packet* proc_pkt)
         {
             pipe_hzdCheck->prgm_stall = true;
             st_hzdCheck = UNALLOCABLE;
+            wcb_flush_oldest( );
 
             PCMC_DBG(dbg_msg, "[RMW] NONHZD WR [0x%lx, SRC=%ld, ID=%lx] "
                 "is stalled due to unallocable RMWQ/DBUF\n", proc_pkt->LADDR,
@@ -455,10 +491,11 @@ void ReadModifyWrite::non_hzd_handle(Packet* proc_pkt)
         }
         else 
         {
-            insert_rmwq(proc_pkt);
+            rmwqeIter_t rmwqe = insert_rmwq(proc_pkt);
             int64_t dbe_idx = alloc_dbuf(proc_pkt);
             if (proc_pkt->src_id==SRC_HOST)
             {
+                wcb_hold(rmwqe);
                 st_hzdCheck = req_wdata(proc_pkt, dbe_idx);
             
                 PCMC_DBG(dbg_msg, "[RMW] NONHZD WR [0x%lx, SRC=%ld, ID=%lx] "
@@ -500,6 +537,13 @@ void ReadModifyWrite::hzd_handle(int64_t hit_idx, Packet* proc_pkt)
         assert(proc_pkt->src_id==SRC_HOST && dbuf[hit_idx]->HostHzdPkt_RD==NULL);
         dbuf[hit_idx]->HostHzdPkt_RD = proc_pkt;
 
+        /* Do not let host read wait for the combining window */
+        if (hit_rmwqe->wcb_expire!=0)
+        {
+            wcb_release(hit_rmwqe);
+            num_wcb_rd_flush += 1;
+        }
+
         signals_t* pb_signals = (signals_t*)(pipe_hzdCheck->dequeue_rear( ));
         st_hzdCheck = NO_STALL;
         pipe_hzdCheck->prgm_stall = false;
@@ -597,10 +641,13 @@ void ReadModifyWrite::stall_handle(Packet* pkt)
         if (rmwq.size( )<size_rmwq &&
             cnt_dbuf(pkt->src_id)<size_dbuf[pkt->src_id])
         {
-            insert_rmwq(pkt);
+            rmwqeIter_t rmwqe = insert_rmwq(pkt);
             int64_t dbe_idx = alloc_dbuf(pkt);
             if (pkt->src_id==SRC_HOST)
+            {
+                wcb_hold(rmwqe);
                 st_hzdCheck = req_wdata(pkt, dbe_idx);
+            }
             else
             {
                 signals_t* pb_signals = (signals_t*)(pipe_hzdCheck->dequeue_rear( ));
@@ -612,6 +659,8 @@ void ReadModifyWrite::stall_handle(Packet* pkt)
             PCMC_DBG(dbg_msg, "[RMW] RMWQ/DBUF is now avail. to be newly alloc."
                 " for [0x%lx, SRC=%ld, ID=%lx]\n", pkt->LADDR, pkt->src_id, pkt->req_id);
         }
+        else
+            wcb_flush_oldest( );
     }
     else if (st_hzdCheck==WAIT_DCACHE_WDATA)
     {
@@ -662,12 +711,48 @@ int ReadModifyWrite::req_wdata(Packet* pkt, int64_t dbe_idx)
     return NO_STALL;
 }
 
+uint64_t ReadModifyWrite::get_ch(Packet* pkt)
+{
+    if (num_channels==1)
+        return 0;
+    return memsys->adec->decode_addr(pkt->PADDR, FLD_CH);
+}
+
+int64_t ReadModifyWrite::get_dpu_ch(Component* from)
+{
+    for (uint64_t ch=0; ch<num_channels; ch++)
+    {
+        if (from==dpu[ch])
+            return (int64_t)ch;
+    }
+    return -1;
+}
+
+bool ReadModifyWrite::is_ch_ready(Packet* pkt, bool is_wr)
+{
+    /* WR needs a wbuffer ID conferred by the DPU of the channel */
+    uint64_t ch = get_ch(pkt);
+    if (is_wr && wbuffer_idx_dpu[ch]<0)
+        return false;
+    return ucmde[ch]->isReady(NULL);
+}
+
 void ReadModifyWrite::issue_cmd( )
 {
     bool isIssued = false;
     uint64_t num_RMW_RD = 0;
     uint64_t num_RMW_WR = 0;
-    if (ucmde->isReady(NULL))
+    bool any_ch_ready = false;
+    for (uint64_t ch=0; ch<num_channels; ch++)
+    {
+        if (ucmde[ch]->isReady(NULL))
+        {
+            any_ch_ready = true;
+            break;
+        }
+    }
+
+    if (any_ch_ready)
     {
         isIssued = true;
         std::pair<uint64_t, rmwqeIter_t> cnt_pair_RD = cnt_rmwq_RD( );
@@ -680,6 +765,15 @@ void ReadModifyWrite::issue_cmd( )
         Packet* out_pkt = NULL;
         if (OUT_CMD_SEL<0)
             isIssued = false; // scheduled but issuable sets to 'false'
+        else if ((OUT_CMD_SEL==OUT_NONHZD_HOSTRD && 
+                  is_ch_ready(nonHzdHostRD_cmdq.front( ), false)==false) ||
+                 (OUT_CMD_SEL==OUT_RMW_RD && 
+                  is_ch_ready(cnt_pair_RD.second->pkt, false)==false))
+        {
+            /* Selected cmd is steered to a busy channel */
+            isIssued = false;
+            num_ch_stalls += 1;
+        }
         else if (OUT_CMD_SEL==OUT_NONHZD_HOSTRD || OUT_CMD_SEL==OUT_RMW_RD)
         {
             if (OUT_CMD_SEL==OUT_NONHZD_HOSTRD)
@@ -702,13 +796,14 @@ void ReadModifyWrite::issue_cmd( )
             }
         }
         else if (OUT_CMD_SEL==OUT_RMW_WR && 
-            wbuffer_idx_dpu>=0 &&   // wbuffer id updated
+            is_ch_ready(cnt_pair_WR.second->pkt, true) && // wbuffer id updated
             wcmd_issued.wdata_issued==false && 
             wait_redir==false)      // dbuf entry retired
         {
             rmwqeIter_t ref_e = cnt_pair_WR.second;
-            ref_e->pkt->buffer_idx = wbuffer_idx_dpu;
-            wbuffer_idx_dpu = -1;
+            uint64_t ch = get_ch(ref_e->pkt);
+            ref_e->pkt->buffer_idx = wbuffer_idx_dpu[ch];
+            wbuffer_idx_dpu[ch] = -1;
 
             /* To prevent memory free conflict w/ retire_dbuf */
             out_pkt = new Packet( );
@@ -741,8 +836,13 @@ void ReadModifyWrite::issue_cmd( )
                 registerCallbackAt((CallbackPtr)&ReadModifyWrite::dbuf_rmux, wake_rdbuf);
             }
         }
-        else if (wbuffer_idx_dpu<0 || wait_redir || wcmd_issued.wdata_issued)
+        else if (wait_redir || wcmd_issued.wdata_issued)
+            isIssued = false;
+        else if (is_ch_ready(cnt_pair_WR.second->pkt, true)==false)
+        {
             isIssued = false;
+            num_ch_stalls += 1;
+        }
         else
             assert(0);
 
@@ -790,8 +890,14 @@ void ReadModifyWrite::issue_cmd( )
                         (num_issue_RMW_WR-1)+tmp_lat)/(double)num_issue_RMW_WR;
             }
 
+            uint64_t ch = get_ch(out_pkt);
+            if (out_pkt->cmd==CMD_READ)
+                num_issue_ch_RD[ch] += 1;
+            else
+                num_issue_ch_WR[ch] += 1;
+
             out_pkt->from = this;
-            ucmde->recvRequest(out_pkt, tCMD);
+            ucmde[ch]->recvRequest(out_pkt, tCMD);
 
             PCMC_DBG(dbg_msg, "[RMW] Issue CMD [0x%lx, SRC=%ld, ID=%lx, CMD=%c] "
                 "selected by %s(rmwq.size=%lu, rmw-rd=%lu, rmw-wr=%lu)\n", 
@@ -896,8 +1002,15 @@ ncycle_t ReadModifyWrite::issue_wdata(Packet* pkt, int64_t dbe_idx)
             pkt->LADDR, pkt->src_id, pkt->req_id);
     }
 
-    /* Check metadata for WLV & WDT */
-    check_meta(pkt);
+    /* 
+     * Check metadata for WLV & WDT 
+     * (metadata is not fetched for a combined full page, so the page is
+     *  written data-only: empty meta lets the media keep the stored one)
+     */
+    if (dbuf[dbe_idx]->RD_skipped==false)
+        check_meta(pkt);
+    else
+        pkt->buffer_meta.setSize(0);
 
     /* Dispatch data to DPU (and DCACHE if possible) */
     Packet* wpkt = new Packet( );
@@ -905,7 +1018,7 @@ ncycle_t ReadModifyWrite::issue_wdata(Packet* pkt, int64_t dbe_idx)
     wpkt->isDATA = true;
     wpkt->owner = this;
     wpkt->from = this;
-    dpu->recvRequest(wpkt, LAT);
+    dpu[get_ch(wpkt)]->recvRequest(wpkt, LAT);
 
     return LAT;
 }
@@ -1073,7 +1186,7 @@ void ReadModifyWrite::handle_await_resps( )
     for ( ; e_it!=await_resp.end( ); )
     {
         Packet* pkt = (*e_it)->pkt;
-        if (pkt->from==dynamic_cast<Component*>(dpu))
+        if (get_dpu_ch(pkt->from)>=0)
             handle_dpu_resps(pkt);
         else if (pkt->from==dynamic_cast<Component*>(dcache))
             handle_dcache_resps(pkt);
@@ -1123,10 +1236,12 @@ void ReadModifyWrite::handle_dpu_resps(Packet* pkt)
     if (pkt->cmd==CMD_WRITE)
     {
         /* Get new wbuffer ID for new wcmd-issue */
-        assert(wbuffer_idx_dpu<0);
-        PCMC_DBG(dbg_msg, "[RMW] Update DPU wbuffer-ID=%lx\n", pkt->buffer_idx);
+        int64_t ch = get_dpu_ch(pkt->from);
+        assert(wbuffer_idx_dpu[ch]<0);
+        PCMC_DBG(dbg_msg, "[RMW] Update DPU[%ld] wbuffer-ID=%lx\n", 
+            ch, pkt->buffer_idx);
 
-        wbuffer_idx_dpu = pkt->buffer_idx;
+        wbuffer_idx_dpu[ch] = pkt->buffer_idx;
         delete pkt;
     }
     else if (pkt->cmd==CMD_READ)
@@ -1164,7 +1279,7 @@ void ReadModifyWrite::handle_dcache_resps(Packet* pkt)
         assert(pipe_hzdCheck->isEmpty( )==false && pipe_hzdCheck->prgm_stall);
         signals_t* pb_signals = (signals_t*)
             (pipe_hzdCheck->buffer[pipe_hzdCheck->getRearIdx( )].signals);
-        req_wdata(pb_signals->pkt, pb_signals->pkt->dbe_idx);
+        st_hzdCheck = req_wdata(pb_signals->pkt, pb_signals->pkt->dbe_idx);
     }
 }
 
@@ -1344,16 +1459,134 @@ ReadModifyWrite::rmwqeIter_t ReadModifyWrite::find_n_link(rmwqeIter_t ref_rmwqe)
     return r_it;
 }
 
+uint64_t ReadModifyWrite::cnt_wcb( )
+{
+    uint64_t rv = 0;
+    rmwqeIter_t q_it = rmwq.begin( );
+    for ( ; q_it!=rmwq.end( ); q_it++)
+    {
+        if (q_it->wcb_expire!=0)
+            rv += 1;
+    }
+    return rv;
+}
+
+void ReadModifyWrite::wcb_hold(rmwqeIter_t rmwqe)
+{
+    if (wcb_size==0 || rmwqe->pkt->src_id!=SRC_HOST)
+        return;
+
+    /* Capacity flush: release the oldest one to make a room */
+    if (cnt_wcb( )>=wcb_size)
+        wcb_flush_oldest( );
+
+    rmwqe->wcb_expire = geq->getCurrentTick( )+wcb_window*ticks_per_cycle;
+    registerCallbackAt((CallbackPtr)&ReadModifyWrite::wcb_timeout, rmwqe->wcb_expire);
+    num_wcb_hold += 1;
+
+    PCMC_DBG(dbg_msg, "[RMW] Hold RMW-RD of [0x%lx, ID=%lx] until tick-%lu "
+        "for write combining\n", rmwqe->pkt->LADDR, rmwqe->pkt->req_id,
+        rmwqe->wcb_expire);
+}
+
+void ReadModifyWrite::wcb_release(rmwqeIter_t rmwqe)
+{
+    assert(rmwqe->wcb_expire!=0);
+    rmwqe->wcb_expire = 0;
+    wake_outArbtr_RD( );
+
+    PCMC_DBG(dbg_msg, "[RMW] Release RMW-RD of [0x%lx, ID=%lx] held for "
+        "write combining\n", rmwqe->pkt->LADDR, rmwqe->pkt->req_id);
+}
+
+void ReadModifyWrite::wcb_flush_oldest( )
+{
+    rmwqeIter_t oldest = rmwq.end( );
+    rmwqeIter_t q_it = rmwq.begin( );
+    for ( ; q_it!=rmwq.end( ); q_it++)
+    {
+        if (q_it->wcb_expire!=0 && 
+            (oldest==rmwq.end( ) || q_it->wcb_expire<oldest->wcb_expire))
+            oldest = q_it;
+    }
+
+    if (oldest!=rmwq.end( ))
+    {
+        wcb_release(oldest);
+        num_wcb_cap_flush += 1;
+    }
+}
+
+void ReadModifyWrite::wcb_timeout( )
+{
+    rmwqeIter_t q_it = rmwq.begin( );
+    for ( ; q_it!=rmwq.end( ); q_it++)
+    {
+        if (q_it->wcb_expire!=0 && q_it->wcb_expire<=geq->getCurrentTick( ))
+        {
+            wcb_release(q_it);
+            num_wcb_timeout += 1;
+        }
+    }
+}
+
+void ReadModifyWrite::wcb_check_full(int64_t dbe_idx)
+{
+    if (wcb_size==0 || wcb_skip_full==false)
+        return;
+
+    rmwqeIter_t rmwqe = find_rmwq(dbuf[dbe_idx]->pkt);
+    if (rmwqe==rmwq.end( ) || rmwqe->RD_issued ||
+        rmwqe->pkt->src_id!=SRC_HOST || rmwqe->remap_link.first>=0)
+        return;
+
+    for (uint64_t i=0; i<PAGE_SIZE/HOST_TX_SIZE; i++)
+    {
+        if (dbuf[dbe_idx]->dvalid[i]==false)
+            return;
+    }
+
+    /* 
+     * Whole page is written by host, old data is unnecessary 
+     * (metadata is kept by the media as the write carries data only)
+     */
+    rmwqe->RD_issued = true;
+    rmwqe->wcb_expire = 0;
+    dbuf[dbe_idx]->mvalid = true;
+    dbuf[dbe_idx]->RD_skipped = true;
+    num_wcb_full += 1;
+
+    PCMC_DBG(dbg_msg, "[RMW] DBUF[%ld]=[0x%lx, ID=%lx] is fully combined, "
+        "skip RMW-RD\n", dbe_idx, rmwqe->pkt->LADDR, rmwqe->pkt->req_id);
+}
+
+void ReadModifyWrite::wake_outArbtr_RD( )
+{
+    if (last_wake_outArbtr==wake_outArbtr && cnt_rmwq_RD( ).first>0)
+    {
+        wake_outArbtr = geq->getCurrentTick( )+1*ticks_per_cycle;
+        wake_outArbtr = std::max(wake_outArbtr, free_outArbtr);
+        registerCallback((CallbackPtr)&ReadModifyWrite::issue_cmd, 1);
+    }
+}
+
 std::pair<uint64_t, ReadModifyWrite::rmwqeIter_t> ReadModifyWrite::cnt_rmwq_RD( )
 {
+    /* Candidate is the oldest one steered to a ready channel, if any */
     std::pair<uint64_t, rmwqeIter_t> ret(0, rmwq.end( ));
+    bool found_ready = false;
     rmwqeIter_t q_it = rmwq.begin( );
     for ( ; q_it!=rmwq.end( ); q_it++)
     {
-        if (q_it->RD_issued==false)
+        if (q_it->RD_issued==false && q_it->wcb_expire==0)
         {
             ret.first += 1;
-            if (ret.first==1)
+            if (found_ready==false && is_ch_ready(q_it->pkt, false))
+            {
+                ret.second = q_it;
+                found_ready = true;
+            }
+            else if (ret.first==1)
                 ret.second = q_it;
         }
     }
@@ -1363,6 +1596,7 @@ std::pair<uint64_t, ReadModifyWrite::rmwqeIter_t> ReadModifyWrite::cnt_rmwq_RD(
 std::pair<uint64_t, ReadModifyWrite::rmwqeIter_t> ReadModifyWrite::cnt_rmwq_WR( )
 {
     std::pair<uint64_t, rmwqeIter_t> ret(0, rmwq.end( ));
+    bool found_ready = false;
     rmwqeIter_t q_it = rmwq.begin( );
     for ( ; q_it!=rmwq.end( ); q_it++)
     {
@@ -1372,7 +1606,12 @@ std::pair<uint64_t, ReadModifyWrite::rmwqeIter_t> ReadModifyWrite::cnt_rmwq_WR(
         if (q_it->issuable)
         {
             ret.first += 1;
-            if (ret.first==1)
+            if (found_ready==false && is_ch_ready(q_it->pkt, true))
+            {
+                ret.second = q_it;
+                found_ready = true;
+            }
+            else if (ret.first==1)
                 ret.second = q_it;
         }
     }
@@ -1392,7 +1631,7 @@ void ReadModifyWrite::dbuf_rmux( )
     /* Data-issue has the highest priority cause its cmd is the oldest */
     bool wdata_ready = false;
     if (pkt!=NULL && wcmd_issued.wdata_issued==false && 
-        (wait_redir || dpu->isReady(pkt)))
+        (wait_redir || dpu[get_ch(pkt)]->isReady(pkt)))
         wdata_ready = true;
 
     if (wdata_ready)
@@ -1534,6 +1773,7 @@ void ReadModifyWrite::dbuf_wmux( )
 
         /* Mark-up DCACHE-RD complete & respond if it's a MERGED req */
         dbuf[found_idx]->dcache_read -= 1;
+        wcb_check_full(found_idx);
         if (dbuf[found_idx]->pkt!=pkt)
         {
             wack(pkt, CMD_WACK_ID);
@@ -1942,11 +2182,20 @@ void ReadModifyWrite::register_stats( )
     RESET_STATS(num_issue_RMW_RD, u64_zero);
     RESET_STATS(num_issue_RMW_WR, u64_zero);
     RESET_STATS(num_issue_nonHzdHostRD, u64_zero);
+    RESET_STATS(num_ch_stalls, u64_zero);
+    memset(num_issue_ch_RD, 0, num_channels*sizeof(uint64_t));
+    memset(num_issue_ch_WR, 0, num_channels*sizeof(uint64_t));
     RESET_STATS(num_flush_RMW_RD, u64_zero);
     RESET_STATS(num_flush_RMW_WR, u64_zero);
     RESET_STATS(num_starv_RMW_RD, u64_zero);
     RESET_STATS(num_starv_RMW_WR, u64_zero);
 
+    RESET_STATS(num_wcb_hold, u64_zero);
+    RESET_STATS(num_wcb_full, u64_zero);
+    RESET_STATS(num_wcb_timeout, u64_zero);
+    RESET_STATS(num_wcb_cap_flush, u64_zero);
+    RESET_STATS(num_wcb_rd_flush, u64_zero);
+
     RESET_STATS(num_WLV, u64_zero);
     RESET_STATS(trigger_WLV, u64_zero);
     RESET_STATS(max_interval_WLV, u64_zero);
@@ -1979,26 +2228,40 @@ void ReadModifyWrite::register_stats( )
     ADD_STATS(cp_name, num_issue_RMW_RD);
     ADD_STATS(cp_name, num_issue_RMW_WR);
     ADD_STATS(cp_name, num_issue_nonHzdHostRD);
+    ADD_STATS(cp_name, num_ch_stalls);
+    for (uint64_t ch=0; ch<num_channels; ch++)
+    {
+        ADD_STATS_ITER(cp_name, num_issue_ch_RD, ch);
+        ADD_STATS_ITER(cp_name, num_issue_ch_WR, ch);
+    }
     ADD_STATS(cp_name, num_flush_RMW_RD);
     ADD_STATS(cp_name, num_flush_RMW_WR);
     ADD_STATS(cp_name, num_starv_RMW_RD);
     ADD_STATS(cp_name, num_starv_RMW_WR);
+    if (wcb_size>0)
+    {
+        ADD_STATS(cp_name, num_wcb_hold);
+        ADD_STATS(cp_name, num_wcb_full);
+        ADD_STATS(cp_name, num_wcb_timeout);
+        ADD_STATS(cp_name, num_wcb_cap_flush);
+        ADD_STATS(cp_name, num_wcb_rd_flush);
+    }
     ADD_STATS(cp_name, num_WLV);
-    ADD_STATS_N_UNIT(cp_name, max_interval_WLV, "cycles");
-    ADD_STATS_N_UNIT(cp_name, min_interval_WLV, "cycles");
-    ADD_STATS_N_UNIT(cp_name, avg_interval_WLV, "cycles");
-    ADD_STATS_N_UNIT(cp_name, max_issue_lat, "cycles");
-    ADD_STATS_N_UNIT(cp_name, min_issue_lat, "cycles");
-    ADD_STATS_N_UNIT(cp_name, avg_issue_lat, "cycles");
-    ADD_STATS_N_UNIT(cp_name, max_issue_nonhzdrd_lat, "cycles");
-    ADD_STATS_N_UNIT(cp_name, min_issue_nonhzdrd_lat, "cycles");
-    ADD_STATS_N_UNIT(cp_name, avg_issue_nonhzdrd_lat, "cycles");
-    ADD_STATS_N_UNIT(cp_name, max_issue_rmwrd_lat, "cycles");
-    ADD_STATS_N_UNIT(cp_name, min_issue_rmwrd_lat, "cycles");
-    ADD_STATS_N_UNIT(cp_name, avg_issue_rmwrd_lat, "cycles");
-    ADD_STATS_N_UNIT(cp_name, max_issue_wr_lat, "cycles");
-    ADD_STATS_N_UNIT(cp_name, min_issue_wr_lat, "cycles");
-    ADD_STATS_N_UNIT(cp_name, avg_issue_wr_lat, "cycles");
+    ADD_STATS_LAT(cp_name, max_interval_WLV);
+    ADD_STATS_LAT(cp_name, min_interval_WLV);
+    ADD_STATS_LAT(cp_name, avg_interval_WLV);
+    ADD_STATS_LAT(cp_name, max_issue_lat);
+    ADD_STATS_LAT(cp_name, min_issue_lat);
+    ADD_STATS_LAT(cp_name, avg_issue_lat);
+    ADD_STATS_LAT(cp_name, max_issue_nonhzdrd_lat);
+    ADD_STATS_LAT(cp_name, min_issue_nonhzdrd_lat);
+    ADD_STATS_LAT(cp_name, avg_issue_nonhzdrd_lat);
+    ADD_STATS_LAT(cp_name, max_issue_rmwrd_lat);
+    ADD_STATS_LAT(cp_name, min_issue_rmwrd_lat);
+    ADD_STATS_LAT(cp_name, avg_issue_rmwrd_lat);
+    ADD_STATS_LAT(cp_name, max_issue_wr_lat);
+    ADD_STATS_LAT(cp_name, min_issue_wr_lat);
+    ADD_STATS_LAT(cp_name, avg_issue_wr_lat);
 }
 
 void ReadModifyWrite::calculate_stats( )
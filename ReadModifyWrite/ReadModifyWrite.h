@@ -57,6 +57,7 @@ namespace PCMCsim
 
         /* Communication functions */
         bool isReady(Packet* pkt) override;
+        uint64_t get_num_reqs( );   // reqs in cmdqs & RMWQ
         void recvRequest(Packet* pkt, ncycle_t delay=1) override; 
         void recvResponse(Packet* pkt, ncycle_t delay=1) override; 
         void handle_events(ncycle_t curr_tick) override;
@@ -67,8 +68,8 @@ namespace PCMCsim
         DataCache* dcache;
         AITManager* aitm;
         Component* errMgr;
-        Component* ucmde;
-        Component* dpu;
+        std::vector<Component*> ucmde; // one per channel
+        std::vector<Component*> dpu;   // one per channel
         Component* mcu;
 
       private:
@@ -116,6 +117,7 @@ namespace PCMCsim
             bool issuable;
             bool RD_issued;         // RMW read is issued
             bool RD_only;           // for BLKMV source request, =1
+            ncycle_t wcb_expire;    // RMW read is held until (0: not held)
 
             WLVPair_t remap_link;   // <src ID & req ID>
 
@@ -137,6 +139,7 @@ namespace PCMCsim
             bool meta_issued;       // check linked one is issued
             std::vector<bool> dvalid;
             bool mvalid;
+            bool RD_skipped;        // full page is combined, no RMW read
             
             Packet* pkt;            // original packet
             Packet* HostHzdPkt_RD;
@@ -204,7 +207,7 @@ namespace PCMCsim
         uint64_t flushCntRMW_WR;
         uint64_t starvCntRMW_RD;
         uint64_t starvCntRMW_WR;
-        int64_t wbuffer_idx_dpu;
+        std::vector<int64_t> wbuffer_idx_dpu;
         
         uint64_t intr_th_WLV;
         uint64_t max_pwcnt;
@@ -215,6 +218,12 @@ namespace PCMCsim
 
         wcmd_t wcmd_issued;
 
+        /* Channel steering */
+        uint64_t num_channels;
+        uint64_t get_ch(Packet* pkt);
+        int64_t get_dpu_ch(Component* from);
+        bool is_ch_ready(Packet* pkt, bool is_wr);
+
         void issue_cmd( );
         ncycle_t issue_wdata(Packet* pkt, int64_t dbe_idx);
         bool resp_HostHzd_RD(Packet* pkt, int64_t dbe_idx); 
@@ -245,6 +254,23 @@ namespace PCMCsim
         rmwqeIter_t insert_rmwq(Packet* pkt);
         rmwqeIter_t find_n_link(rmwqeIter_t ref_rmwqe);
 
+        /* 
+         * Write combining: RMW read of a partial host write is held for 
+         * a bounded window, so that sibling writes merged to its DBUF entry
+         * can complete the page, which then skips the RMW read entirely
+         */
+        uint64_t wcb_size;      // max # of held entries (0: disabled)
+        ncycle_t wcb_window;    // hold window in cycles
+        bool wcb_skip_full;
+
+        uint64_t cnt_wcb( );
+        void wcb_hold(rmwqeIter_t rmwqe);
+        void wcb_release(rmwqeIter_t rmwqe);
+        void wcb_flush_oldest( );
+        void wcb_timeout( );
+        void wcb_check_full(int64_t dbe_idx);
+        void wake_outArbtr_RD( );
+
         std::pair<uint64_t, rmwqeIter_t> cnt_rmwq_RD( );
         std::pair<uint64_t, rmwqeIter_t> cnt_rmwq_WR( );
 
@@ -307,11 +333,20 @@ namespace PCMCsim
         uint64_t num_issue_RMW_RD;
         uint64_t num_issue_RMW_WR;
         uint64_t num_issue_nonHzdHostRD;
+        uint64_t* num_issue_ch_RD;
+        uint64_t* num_issue_ch_WR;
+        uint64_t num_ch_stalls; // busy uCMDE or no DPU wbuffer ID
         uint64_t num_flush_RMW_RD; // <num_RMW_RD
         uint64_t num_flush_RMW_WR; // <num_RMW_WR
         uint64_t num_starv_RMW_RD; // <num_RMW_RD
         uint64_t num_starv_RMW_WR; // <num_RMW_WR
 
+        uint64_t num_wcb_hold;
+        uint64_t num_wcb_full;      // RMW reads skipped
+        uint64_t num_wcb_timeout;
+        uint64_t num_wcb_cap_flush;
+        uint64_t num_wcb_rd_flush;  // released by host read hazard
+
         uint64_t num_WLV;
         ncycle_t trigger_WLV;
         ncycle_t max_interval_WLV;
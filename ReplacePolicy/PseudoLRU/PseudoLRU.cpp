@@ -58,6 +58,19 @@ int64_t PseudoLRU::get_victim(uint64_t s)
     return victim;
 }
 
+int64_t PseudoLRU::peek_victim(uint64_t s)
+{
+    if (filled_ways[s]<num_ways)
+        return (int64_t)filled_ways[s];
+
+    /* Only the first pseudo-LRU way is seen w/o flipping the tree */
+    int64_t victim = recurs_trav(s, 1);
+    if (victim<0 || rsvd[s][victim])
+        victim = -1;
+
+    return victim;
+}
+
 /* Executed only for initialization! */
 int64_t PseudoLRU::recurs_init(uint64_t s, int64_t idx)
 {
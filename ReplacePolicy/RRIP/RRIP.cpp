@@ -0,0 +1,138 @@
+#include "ReplacePolicy/RRIP/RRIP.h"
+
+using namespace PCMCsim;
+
+const uint8_t RRIP::max_rrpv;
+const uint64_t RRIP::brrip_period;
+const int64_t RRIP::psel_max;
+
+RRIP::RRIP(uint64_t s, uint64_t w, int m)
+: ReplacePolicy(s, w), mode(m), brrip_cnt(0), duel_period(4), psel(0)
+{
+    assert(mode>=MODE_SRRIP && mode<NUM_RRIP_MODE);
+    init_policy( );
+}
+
+RRIP::~RRIP( )
+{
+}
+
+void RRIP::init_policy( )
+{
+    filled_ways.resize(num_sets, 0);
+    rrpv.resize(num_sets*num_ways, max_rrpv);
+    pending.resize(num_sets*num_ways, false);
+
+    /* Up to 32 leader sets of each kind */
+    duel_period = std::max(num_sets/32, (uint64_t)4);
+    psel = (psel_max+1)/2;
+}
+
+void RRIP::update_victim(uint64_t s, int64_t w)
+{
+    /* Re-reference: predict near-immediate interval (hit priority) */
+    rrpv[s*num_ways+w] = 0;
+}
+
+int64_t RRIP::get_victim(uint64_t s)
+{
+    int64_t victim = -1;
+    if (filled_ways[s]<num_ways)
+    {
+        victim = (int64_t)filled_ways[s];
+        filled_ways[s] += 1;
+    }
+    else
+    {
+        /* Find the first unreserved way having the largest RRPV */
+        for (uint64_t w=0; w<num_ways; w++)
+        {
+            if (rsvd[s][w]) continue;
+
+            if (victim<0 || rrpv[s*num_ways+w]>rrpv[s*num_ways+victim])
+                victim = (int64_t)w;
+        }
+
+        if (victim<0)
+            return -1;
+
+        /* Age the set so that the victim has distant RRPV */
+        uint8_t age = max_rrpv-rrpv[s*num_ways+victim];
+        if (age>0)
+        {
+            for (uint64_t w=0; w<num_ways; w++)
+            {
+                if (rsvd[s][w]==false)
+                    rrpv[s*num_ways+w] += age;
+            }
+        }
+    }
+
+    pending[s*num_ways+victim] = true;
+    return victim;
+}
+
+int64_t RRIP::peek_victim(uint64_t s)
+{
+    if (filled_ways[s]<num_ways)
+        return (int64_t)filled_ways[s];
+
+    int64_t victim = -1;
+    for (uint64_t w=0; w<num_ways; w++)
+    {
+        if (rsvd[s][w]) continue;
+
+        if (victim<0 || rrpv[s*num_ways+w]>rrpv[s*num_ways+victim])
+            victim = (int64_t)w;
+    }
+
+    return victim;
+}
+
+void RRIP::insert_victim(uint64_t s, int64_t w, uint64_t addr)
+{
+    /* A way is inserted once per conferment (repeated fills are ignored) */
+    if (pending[s*num_ways+w]==false)
+        return;
+    pending[s*num_ways+w] = false;
+
+    /* Insertion is a miss in this set; leader sets train PSEL */
+    if (mode==MODE_DRRIP)
+    {
+        if (s%duel_period==0 && psel<psel_max)
+            psel += 1;
+        else if (s%duel_period==duel_period/2 && psel>0)
+            psel -= 1;
+    }
+
+    rrpv[s*num_ways+w] = get_insert_rrpv(s, w, addr);
+}
+
+uint8_t RRIP::get_insert_rrpv(uint64_t s, int64_t /*w*/, uint64_t /*addr*/)
+{
+    uint8_t rv = max_rrpv-1;
+    if (use_brrip(s))
+    {
+        brrip_cnt += 1;
+        if (brrip_cnt%brrip_period!=0)
+            rv = max_rrpv;
+    }
+
+    return rv;
+}
+
+bool RRIP::use_brrip(uint64_t s)
+{
+    bool rv = (mode==MODE_BRRIP);
+    if (mode==MODE_DRRIP)
+    {
+        if (s%duel_period==0)                   // SRRIP leader
+            rv = false;
+        else if (s%duel_period==duel_period/2)  // BRRIP leader
+            rv = true;
+        else                                    // follower
+            rv = (psel>(psel_max+1)/2);
+    }
+
+    return rv;
+}
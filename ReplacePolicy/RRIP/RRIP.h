@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2019 Computer Architecture and Paralllel Processing Lab, 
+ * Seoul National University, Republic of Korea. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     1. Redistribution of source code must retain the above copyright 
+ *        notice, this list of conditions and the follwoing disclaimer.
+ *     2. Redistributions in binary form must reproduce the above copyright 
+ *        notice, this list conditions and the following disclaimer in the 
+ *        documentation and/or other materials provided with the distirubtion.
+ *     3. Neither the name of the copyright holders nor the name of its 
+ *        contributors may be used to endorse or promote products derived from 
+ *        this software without specific prior written permission. 
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *
+ * Description: This is re-reference interval prediction (RRIP) policy
+ * that keeps an M-bit RRPV per way (O(MN) area for each set)
+ * > SRRIP: every fill is inserted with long re-reference interval
+ * > BRRIP: fills are inserted with distant interval, and long one
+ *   only once in a while (bimodal), which protects against scans
+ * > DRRIP: leader sets duel SRRIP against BRRIP with a saturating
+ *   PSEL counter and follower sets obey the winner
+ * Victim is a way with distant RRPV; the set is aged until one exists
+ */
+
+#ifndef __PCMCSIM_RRIP_H_
+#define __PCMCSIM_RRIP_H_
+
+#include "base/PCMCTypes.h"
+#include "ReplacePolicy/ReplacePolicy.h"
+
+namespace PCMCsim
+{
+    class RRIP : public ReplacePolicy
+    {
+      public:
+        enum _rrip_mode
+        {
+            MODE_SRRIP = 0,
+            MODE_BRRIP,
+            MODE_DRRIP,
+
+            NUM_RRIP_MODE
+        };
+
+        RRIP(uint64_t num_sets, uint64_t num_ways, int mode);
+        RRIP( ) = delete;
+        ~RRIP( );
+
+        void init_policy( ) override;
+        void update_victim(uint64_t set, int64_t way) override;
+        int64_t get_victim(uint64_t set) override;
+        int64_t peek_victim(uint64_t set) override;
+        void insert_victim(uint64_t set, int64_t way, uint64_t addr) override;
+
+      protected:
+        const static uint8_t max_rrpv = 3;          // 2-bit RRPV
+        const static uint64_t brrip_period = 32;    // 1/32 long insertion
+        const static int64_t psel_max = 1023;       // 10-bit PSEL
+
+        int mode;
+        std::vector<uint64_t> filled_ways;
+        std::vector<uint8_t> rrpv;      // [SET*WAY]
+        std::vector<bool> pending;      // conferred but not inserted yet
+
+        uint64_t brrip_cnt;
+        uint64_t duel_period;           // one leader of each kind per period
+        int64_t psel;
+
+        virtual uint8_t get_insert_rrpv(uint64_t set, int64_t way, uint64_t addr);
+        bool use_brrip(uint64_t set);
+    };
+};
+
+#endif 
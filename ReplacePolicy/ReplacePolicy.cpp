@@ -32,6 +32,12 @@ ReplacePolicy::~ReplacePolicy( )
 {
 }
 
+void ReplacePolicy::insert_victim(uint64_t set, int64_t way, uint64_t /*addr*/)
+{
+    /* Insertion is a plain touch unless the policy tells them apart */
+    update_victim(set, way);
+}
+
 void ReplacePolicy::set_rsvd(uint64_t set, int64_t way)
 {
     assert(set<num_sets && (uint64_t)way<num_ways);
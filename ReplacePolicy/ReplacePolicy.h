@@ -48,6 +48,12 @@ namespace PCMCsim
         virtual void init_policy( ) = 0;
         virtual void update_victim(uint64_t set, int64_t way) = 0;
         virtual int64_t get_victim(uint64_t set) = 0;
+
+        /* Way that get_victim would confer next, w/o updating the policy */
+        virtual int64_t peek_victim(uint64_t set) = 0;
+
+        /* Called when a way conferred by get_victim is filled with addr */
+        virtual void insert_victim(uint64_t set, int64_t way, uint64_t addr);
         
         void set_rsvd(uint64_t set, int64_t way);
         void unset_rsvd(uint64_t set, int64_t way);
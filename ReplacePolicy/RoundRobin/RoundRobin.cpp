@@ -51,3 +51,22 @@ int64_t RoundRobin::get_victim(uint64_t s)
 
     return curr_way;
 }
+
+int64_t RoundRobin::peek_victim(uint64_t s)
+{
+    if (filled_ways[s]<num_ways)
+        return (int64_t)filled_ways[s];
+
+    int64_t rv = -1;
+    for (uint64_t i=1; i<=num_ways; i++)
+    {
+        uint64_t tmp_way = (curr_way+i)%num_ways;
+        if (rsvd[s][tmp_way]==false)
+        {
+            rv = (int64_t)tmp_way;
+            break;
+        }
+    }
+
+    return rv;
+}
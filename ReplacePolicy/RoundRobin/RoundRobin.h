@@ -48,6 +48,7 @@ namespace PCMCsim
         void init_policy( ) override;
         void update_victim(uint64_t set, int64_t way) override;
         int64_t get_victim(uint64_t set) override;
+        int64_t peek_victim(uint64_t set) override;
 
       private:
         std::vector<uint64_t> filled_ways;
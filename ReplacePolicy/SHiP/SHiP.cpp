@@ -0,0 +1,58 @@
+#include "ReplacePolicy/SHiP/SHiP.h"
+
+using namespace PCMCsim;
+
+const uint64_t SHiP::sig_bits;
+const uint8_t SHiP::shct_max;
+
+SHiP::SHiP(uint64_t s, uint64_t w, uint64_t rb)
+: RRIP(s, w, MODE_SRRIP), region_bits(rb)
+{
+    init_policy( );
+}
+
+SHiP::~SHiP( )
+{
+}
+
+void SHiP::init_policy( )
+{
+    RRIP::init_policy( );
+    shct.resize(1ULL<<sig_bits, 1);
+    sig.resize(num_sets*num_ways, 0);
+    sig_valid.resize(num_sets*num_ways, false);
+    reref.resize(num_sets*num_ways, false);
+}
+
+void SHiP::update_victim(uint64_t s, int64_t w)
+{
+    RRIP::update_victim(s, w);
+
+    uint64_t idx = s*num_ways+w;
+    if (sig_valid[idx])
+    {
+        reref[idx] = true;
+        if (shct[sig[idx]]<shct_max)
+            shct[sig[idx]] += 1;
+    }
+}
+
+uint8_t SHiP::get_insert_rrpv(uint64_t s, int64_t w, uint64_t addr)
+{
+    /* Train with the evicted line, then bind the new signature */
+    uint64_t idx = s*num_ways+w;
+    if (sig_valid[idx] && reref[idx]==false && shct[sig[idx]]>0)
+        shct[sig[idx]] -= 1;
+
+    sig[idx] = get_sig(addr);
+    sig_valid[idx] = true;
+    reref[idx] = false;
+
+    return (shct[sig[idx]]==0)? max_rrpv : max_rrpv-1;
+}
+
+uint16_t SHiP::get_sig(uint64_t addr)
+{
+    uint64_t region = addr >> region_bits;
+    return (uint16_t)((region ^ (region>>sig_bits)) & ((1ULL<<sig_bits)-1));
+}
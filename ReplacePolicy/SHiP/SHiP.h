@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) 2019 Computer Architecture and Paralllel Processing Lab, 
+ * Seoul National University, Republic of Korea. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     1. Redistribution of source code must retain the above copyright 
+ *        notice, this list of conditions and the follwoing disclaimer.
+ *     2. Redistributions in binary form must reproduce the above copyright 
+ *        notice, this list conditions and the following disclaimer in the 
+ *        documentation and/or other materials provided with the distirubtion.
+ *     3. Neither the name of the copyright holders nor the name of its 
+ *        contributors may be used to endorse or promote products derived from 
+ *        this software without specific prior written permission. 
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *
+ * Description: This is signature-based hit predictor (SHiP) policy 
+ * built on top of SRRIP. As the controller does not see the PC, the
+ * signature is the memory region of the filled address (SHiP-Mem)
+ * > SHCT: table of saturating counters indexed by signature
+ * > hit: the line is marked re-referenced and its counter increases
+ * > eviction w/o re-reference: its counter decreases
+ * Fills whose counter is zero are inserted with distant RRPV
+ */
+
+#ifndef __PCMCSIM_SHIP_H_
+#define __PCMCSIM_SHIP_H_
+
+#include "base/PCMCTypes.h"
+#include "ReplacePolicy/RRIP/RRIP.h"
+
+namespace PCMCsim
+{
+    class SHiP : public RRIP
+    {
+      public:
+        SHiP(uint64_t num_sets, uint64_t num_ways, uint64_t region_bits=12);
+        SHiP( ) = delete;
+        ~SHiP( );
+
+        void init_policy( ) override;
+        void update_victim(uint64_t set, int64_t way) override;
+
+      private:
+        const static uint64_t sig_bits = 14;    // 16K-entry SHCT
+        const static uint8_t shct_max = 7;      // 3-bit counter
+
+        uint64_t region_bits;
+        std::vector<uint8_t> shct;
+        std::vector<uint16_t> sig;      // [SET*WAY]
+        std::vector<bool> sig_valid;
+        std::vector<bool> reref;
+
+        uint8_t get_insert_rrpv(uint64_t set, int64_t way, uint64_t addr) override;
+        uint16_t get_sig(uint64_t addr);
+    };
+};
+
+#endif 
@@ -14,43 +14,60 @@ TrueLRU::~TrueLRU( )
 
 void TrueLRU::init_policy( )
 {
-    tLRU.resize(num_sets);
+    filled_ways.resize(num_sets, 0);
+    stamp.resize(num_sets*num_ways, 0);
+    newest.resize(num_sets, 0);
+    oldest.resize(num_sets, 0);
 }
 
 void TrueLRU::update_victim(uint64_t s, int64_t w)
 {
-    std::list<uint64_t>::iterator it = tLRU[s].begin( );
-    for ( ; it!=tLRU[s].end( ); it++)
-    {
-        if ((*it)==(uint64_t)w)
-            break;
-    }
-    assert(it!=tLRU[s].end( ));
-    tLRU[s].splice(tLRU[s].end( ), tLRU[s], it);
+    assert((uint64_t)w<filled_ways[s]);
+    newest[s] += 1;
+    stamp[s*num_ways+w] = newest[s];
 }
 
 int64_t TrueLRU::get_victim(uint64_t s)
 {
     int64_t rv = -1;
-    if (tLRU[s].size( )<num_ways)
+    if (filled_ways[s]<num_ways)
     {
-        rv = tLRU[s].size( );
-        tLRU[s].push_front(rv);
+        /* Unfilled way enters as the LRU one */
+        rv = filled_ways[s];
+        filled_ways[s] += 1;
+        oldest[s] -= 1;
+        stamp[s*num_ways+rv] = oldest[s];
     }
     else
     {
-        std::list<uint64_t>::iterator it = tLRU[s].begin( );
-        for ( ; it!=tLRU[s].end( ); it++)
+        for (uint64_t w=0; w<num_ways; w++)
         {
-            if (rsvd[s][(*it)]==false)
-            {
-                rv = *it;
-                tLRU[s].splice(tLRU[s].end( ), tLRU[s], it);
-                break;
-            }
+            if (rsvd[s][w]) continue;
+
+            if (rv<0 || stamp[s*num_ways+w]<stamp[s*num_ways+rv])
+                rv = (int64_t)w;
         }
+
+        if (rv>=0)
+            update_victim(s, rv);
     }
     
     return rv;
 }
 
+int64_t TrueLRU::peek_victim(uint64_t s)
+{
+    if (filled_ways[s]<num_ways)
+        return (int64_t)filled_ways[s];
+
+    int64_t rv = -1;
+    for (uint64_t w=0; w<num_ways; w++)
+    {
+        if (rsvd[s][w]) continue;
+
+        if (rv<0 || stamp[s*num_ways+w]<stamp[s*num_ways+rv])
+            rv = (int64_t)w;
+    }
+
+    return rv;
+}
@@ -29,6 +29,8 @@
  *
  * Description: This is True (or ideal) LRU policy 
  * that requires O(logN!)~=O(NlogN) area for each set in the cache
+ * Recency is kept as per-way age stamps, so a touch is O(1) and
+ * victim search is a single scan over the ways of the set
  */
 
 #ifndef __PCMCSIM_TRUE_LRU_H_
@@ -49,9 +51,13 @@ namespace PCMCsim
         void init_policy( ) override;
         void update_victim(uint64_t set, int64_t way) override;
         int64_t get_victim(uint64_t set) override;
+        int64_t peek_victim(uint64_t set) override;
 
       private:
-        std::vector<std::list<uint64_t>> tLRU;
+        std::vector<uint64_t> filled_ways;
+        std::vector<int64_t> stamp;     // [SET*WAY], smaller is older
+        std::vector<int64_t> newest;    // stamp of MRU way in each set
+        std::vector<int64_t> oldest;    // stamp of LRU way in each set
     };
 };
 
@@ -1,7 +1,9 @@
 #include "base/MemoryControlSystem.h"
 #include "base/Packet.h"
 #include "base/EventQueue.h"
+#include "base/IDAllocator.h"
 #include "base/Stats.h"
+#include "base/ReqTracer.h"
 #include "Parsers/Parser.h"
 #include "RequestReceiver/RequestReceiver.h"
 #include "DataCache/DataCache.h"
@@ -10,8 +12,10 @@
 using namespace PCMCsim;
 
 RequestReceiver::RequestReceiver(MemoryControlSystem* memsys_, std::string cfg_header)
-:Component(memsys_), dcache(NULL), mux_st(PRIORITY_READ), wake_req_mux(0),
-last_wake_req_mux(0), wake_resp_mux(0), last_wake_resp_mux(0), free_resp(0)
+:Component(memsys_), dcache(NULL), arb_port(0), arb_cnt(0), 
+last_grant(std::numeric_limits<ncycle_t>::max( )), mux_st(PRIORITY_READ), cnt_rd(0), cnt_wr(0),
+wake_req_mux(0), last_wake_req_mux(0), wake_resp_mux(0), last_wake_resp_mux(0), 
+free_resp(0)
 {
     cp_name = cfg_header;
 
@@ -23,28 +27,40 @@ last_wake_req_mux(0), wake_resp_mux(0), last_wake_resp_mux(0), free_resp(0)
     buffer_size_bits = memsys->getParamUINT64(cp_name+".buffer_size_bits", 7);
     buffer_size = 1<<buffer_size_bits;
 
+    /* Each host port owns an equal share of the buffer credits */
+    num_ports = memsys->getParamUINT64("parser.num_ports", 1);
+    port_credit = buffer_size/num_ports;
+    if (port_credit==0)
+    {
+        std::cerr << "[ReqRecv] Error! Buffer size (" << buffer_size 
+            << ") is smaller than the number of host ports (" 
+            << num_ports << ")" << std::endl;
+        assert(0);
+        exit(1);
+    }
+
+    port_weight.resize(num_ports, 1);
+    for (uint64_t p=0; p<num_ports; p++)
+    {
+        port_weight[p] = memsys->getParamUINT64(
+            cp_name+".port_weight["+std::to_string(p)+"]", 1);
+        assert(port_weight[p]>0);
+    }
+    portq.resize(num_ports);
+    stalled_pkt.resize(num_ports, NULL);
+
     drain_mode = memsys->getParamBOOL(cp_name+".drain_mode", true);
     uint64_t num_qs = (drain_mode)? NUM_QTYPE:1;
-    credits.resize(num_qs, 0);
+    credits.resize(num_ports, std::vector<uint64_t>(num_qs, port_credit));
     FIFO.resize(num_qs);
-    if (drain_mode)
-    {
-        credits[RDQ] = buffer_size;
-        credits[WRQ] = buffer_size;
-    }
-    else
-        credits[0] = buffer_size;
 
     tCMD = memsys->getParamUINT64(cp_name+".tCMD", 1);
     tDATA = memsys->getParamUINT64(cp_name+".tDATA_MEM", 2);
     tRESP = memsys->getParamUINT64(cp_name+".tDATA_HOST", 1);
 
     /* Data structure init */
-    for (uint64_t id = 0 ; id < buffer_size; id++)
-    {
-        avail_RID.push_back( id );
-        avail_WID.push_back( (id|(1<<buffer_size_bits)) );
-    }
+    RID_alloc = new IDAllocator(buffer_size);
+    WID_alloc = new IDAllocator(buffer_size, (1<<buffer_size_bits));
 
     DataBlock e_data;
     entry_t e_init{0, 0, e_data};
@@ -52,25 +68,52 @@ last_wake_req_mux(0), wake_resp_mux(0), last_wake_resp_mux(0), free_resp(0)
     wbuffer.resize(buffer_size, e_init);
     rbuffer_WAR_wid.resize(buffer_size, e_init);
     wbuffer_WAR_rid.resize(buffer_size, e_init);
+    rbuffer_index.reserve(buffer_size);
+    wbuffer_index.reserve(buffer_size);
 
     /* Stats value setting */
+    port_grants = new uint64_t[num_ports];
+    port_reads = new uint64_t[num_ports];
+    port_writes = new uint64_t[num_ports];
+    port_credit_stalls = new uint64_t[num_ports];
+    port_avg_rd_lat = new double[num_ports];
+    port_avg_wr_lat = new double[num_ports];
+    port_avg_arb_wait = new double[num_ports];
     register_stats( );
 }
 
 RequestReceiver::~RequestReceiver( )
 {
-
+    delete RID_alloc;
+    delete WID_alloc;
+
+    delete [] port_grants;
+    delete [] port_reads;
+    delete [] port_writes;
+    delete [] port_credit_stalls;
+    delete [] port_avg_rd_lat;
+    delete [] port_avg_wr_lat;
+    delete [] port_avg_arb_wait;
 }
 
 void RequestReceiver::recvRequest(Packet* pkt, ncycle_t delay)
 {
-    credit_calc(pkt->cmd, true);
-    registerCallback((CallbackPtr)&RequestReceiver::ID_remap, 
-                     delay, 0, reinterpret_cast<void*>(pkt));
+    ncycle_t arrival = geq->getCurrentTick( )+delay*ticks_per_cycle;
+    PCMC_TRACE(pkt, TRC_RECVR, arrival);
+    credit_calc(pkt->cmd, true, get_port(pkt));
+    stalled_pkt[get_port(pkt)] = NULL;
+
+    /* 
+     * Requests wait in the port queue until granted by the arbiter,
+     * each request wakes the arbiter once so that no grant is lost
+     */
+    portq[get_port(pkt)].push_back(arb_entry_t(arrival, pkt));
+    registerCallback((CallbackPtr)&RequestReceiver::port_arb, delay);
 }
 
 void RequestReceiver::recvResponse(Packet* pkt, ncycle_t delay)
 {
+    PCMC_TRACE(pkt, TRC_RECVR, geq->getCurrentTick( )+delay*ticks_per_cycle);
     if (pkt->cmd==CMD_WRITE || pkt->cmd==CMD_WACK_ID)
         resp_handle(pkt);
     else if (pkt->cmd==CMD_READ)
@@ -82,18 +125,29 @@ void RequestReceiver::recvResponse(Packet* pkt, ncycle_t delay)
 bool RequestReceiver::isReady(Packet* pkt)
 {
     bool rv = true;
+    uint64_t port = get_port(pkt);
     uint64_t credit = std::numeric_limits<uint64_t>::max( );
     if (drain_mode==false)
-        credit = credits[0];
+        credit = credits[port][0];
     else if (pkt->cmd==CMD_READ)
-        credit = credits[RDQ];
+        credit = credits[port][RDQ];
     else if (pkt->cmd==CMD_WRITE)
-        credit = credits[WRQ];
+        credit = credits[port][WRQ];
     else
         assert(0);
     
     assert(credit < std::numeric_limits<uint64_t>::max( ));
-    if (credit == 0 || CAM_stalls.empty( )==false)
+    if (credit == 0)
+    {
+        /* Host polls every cycle, so count a stalled request only once */
+        if (stalled_pkt[port]!=pkt)
+        {
+            stalled_pkt[port] = pkt;
+            port_credit_stalls[port] += 1;
+        }
+        rv = false;
+    }
+    else if (CAM_stalls.empty( )==false)
         rv = false;
 
     return rv;
@@ -131,12 +185,14 @@ void RequestReceiver::insert_buffer(Packet* pkt)
     {
         rbuffer[get_bid(pkt)].addr = pkt->LADDR;
         rbuffer[get_bid(pkt)].valid = true;
+        index_insert(rbuffer_index, pkt->LADDR, get_bid(pkt));
     }
     else if (pkt->cmd == CMD_WRITE)
     {
         wbuffer[get_bid(pkt)].addr = pkt->LADDR;
         wbuffer[get_bid(pkt)].valid = true;
         wbuffer[get_bid(pkt)].wdata = pkt->buffer_data;
+        index_insert(wbuffer_index, pkt->LADDR, get_bid(pkt));
     }
     else
         assert(0);
@@ -172,7 +228,7 @@ void RequestReceiver::resp_handle(Packet* pkt)
 
         /* Push into respq for response */
         pkt->req_id = ID_unmap(pkt->req_id, CMD_READ, pkt);
-        credit_calc(CMD_READ, false);
+        credit_calc(CMD_READ, false, get_port(pkt));
         respq.push(pkt);
     }
     else if (pkt->cmd == CMD_WRITE) // can send data to dcache
@@ -191,7 +247,7 @@ void RequestReceiver::resp_handle(Packet* pkt)
         /* BID retirement */
         assert(pkt->buffer_idx>=0);
         ID_unmap(pkt->buffer_idx, CMD_WRITE, pkt);
-        credit_calc(CMD_WRITE, false);
+        credit_calc(CMD_WRITE, false, get_port(pkt));
         pkt->buffer_idx = -1;
     }
     else if (pkt->cmd==CMD_WACK_ID)
@@ -199,7 +255,7 @@ void RequestReceiver::resp_handle(Packet* pkt)
         assert(memsys->sys_name=="DRAM");
         assert(pkt->req_id>=0);
         ID_unmap(pkt->req_id, CMD_WRITE, pkt);
-        credit_calc(CMD_WRITE, false);
+        credit_calc(CMD_WRITE, false, get_port(pkt));
     }
     else
         assert(0);
@@ -215,51 +271,103 @@ void RequestReceiver::resp_handle(Packet* pkt)
     }
 }
 
-void RequestReceiver::credit_calc( cmd_t cmd, bool in )
+void RequestReceiver::credit_calc( cmd_t cmd, bool in, uint64_t port )
 {
+    std::vector<uint64_t>& credit = credits[port];
     if (drain_mode==false)
     {
         if (in)
-            credits[0]--;
+            credit[0]--;
         else
-            credits[0]++;
-        assert(credits[0]<=buffer_size);
+            credit[0]++;
+        assert(credit[0]<=port_credit);
     }
     else if (cmd == CMD_WRITE) // WRITE
     {
         if (in) // in
-            credits[WRQ]--;
+            credit[WRQ]--;
         else
-            credits[WRQ]++;
-        assert(credits[WRQ]<=buffer_size);
+            credit[WRQ]++;
+        assert(credit[WRQ]<=port_credit);
     }
     else
     {
         if (in)
-            credits[RDQ]--;
+            credit[RDQ]--;
         else
-            credits[RDQ]++;
-        assert(credits[RDQ]<=buffer_size);
+            credit[RDQ]++;
+        assert(credit[RDQ]<=port_credit);
     }
 }
 
+uint64_t RequestReceiver::get_port(Packet* pkt)
+{
+    return (num_ports==1)? 0:static_cast<Parser*>(parser)->get_port(pkt);
+}
+
+void RequestReceiver::port_arb( )
+{
+    /* Hazard checker accepts a request per cycle */
+    ncycle_t curr_tick = geq->getCurrentTick( );
+    if (last_grant==curr_tick)
+    {
+        registerCallback((CallbackPtr)&RequestReceiver::port_arb, 1);
+        return;
+    }
+
+    /* Weighted round-robin: the holder keeps the grant up to its weight */
+    for (uint64_t i=0; i<num_ports; i++)
+    {
+        uint64_t p = (arb_port+i)%num_ports;
+        if (portq[p].empty( ) || portq[p].front( ).first>curr_tick)
+            continue;
+
+        if (p!=arb_port)
+        {
+            arb_port = p;
+            arb_cnt = 0;
+        }
+
+        arb_cnt += 1;
+        if (arb_cnt>=port_weight[p])
+        {
+            arb_port = (p+1)%num_ports;
+            arb_cnt = 0;
+        }
+
+        Packet* pkt = portq[p].front( ).second;
+        ncycle_t tmp_wait = curr_tick-portq[p].front( ).first;
+        portq[p].pop_front( );
+
+        port_avg_arb_wait[p] = (port_avg_arb_wait[p]*port_grants[p]+tmp_wait)/
+                               (double)(port_grants[p]+1);
+        port_grants[p] += 1;
+
+        PCMC_DBG(dbg_msg, "[ReqRecv] Grant port-%lu [0x%lx, HostID=%lx, CMD=%c]\n",
+            p, pkt->LADDR, pkt->req_id, (pkt->cmd==CMD_READ)? 'R':'W');
+
+        last_grant = curr_tick;
+        ID_remap(pkt);
+        return;
+    }
+
+    /* No request has arrived yet, try again */
+    registerCallback((CallbackPtr)&RequestReceiver::port_arb, 1);
+}
+
 void RequestReceiver::ID_remap(Packet* pkt)
 {
     uint64_t newID = 0;
     uint64_t originID = 0;
     if (pkt->cmd == CMD_READ)
     {
-        assert(!avail_RID.empty( ));
-        newID = avail_RID.front( );
-        avail_RID.pop_front( );
-        alloc_RID.insert(std::pair<uint64_t, uint64_t>(newID, pkt->req_id));
+        assert(!RID_alloc->full( ));
+        newID = RID_alloc->alloc(pkt->req_id);
     }
     else if (pkt->cmd == CMD_WRITE)
     {
-        assert(!avail_WID.empty( ));
-        newID = avail_WID.front( );
-        avail_WID.pop_front( );
-        alloc_WID.insert(std::pair<uint64_t, uint64_t>(newID, pkt->req_id));
+        assert(!WID_alloc->full( ));
+        newID = WID_alloc->alloc(pkt->req_id);
     }
     else
         assert(0);
@@ -284,12 +392,9 @@ uint64_t RequestReceiver::ID_unmap(uint64_t ID, cmd_t type, Packet* pkt)
 
     if (type == CMD_READ)
     {
-        avail_RID.push_back( ID );
-        
-        if (alloc_RID.count(ID)==0)
-            assert(0);
-        hostID = alloc_RID[ID];
-        alloc_RID.erase(ID);
+        hostID = RID_alloc->release(ID);
+        if (rbuffer[ID].valid) // not inserted if served by RAW
+            index_erase(rbuffer_index, rbuffer[ID].addr, ID);
         rbuffer[ID].valid = false;
 
         /* Stats update */
@@ -300,15 +405,17 @@ uint64_t RequestReceiver::ID_unmap(uint64_t ID, cmd_t type, Packet* pkt)
 
         avg_rd_lat = (avg_rd_lat*num_reads+tmp_lat)/(double)(num_reads+1);
         num_reads += 1;
+
+        uint64_t port = get_port(pkt);
+        port_avg_rd_lat[port] = (port_avg_rd_lat[port]*port_reads[port]+tmp_lat)/
+                                (double)(port_reads[port]+1);
+        port_reads[port] += 1;
     }
     else if (type == CMD_WRITE)
     {
-        avail_WID.push_back( ID );
-
-        if (alloc_WID.count(ID)==0)
-            assert(0);
-        hostID = alloc_WID[ID];
-        alloc_WID.erase(ID);
+        hostID = WID_alloc->release(ID);
+        if (wbuffer[get_bid(ID)].valid) // not inserted if merged by WAW
+            index_erase(wbuffer_index, wbuffer[get_bid(ID)].addr, get_bid(ID));
         wbuffer[get_bid(ID)].valid = false;
 
         /* Stats update */
@@ -319,6 +426,11 @@ uint64_t RequestReceiver::ID_unmap(uint64_t ID, cmd_t type, Packet* pkt)
 
         avg_wr_lat = (avg_wr_lat*num_writes+tmp_lat)/(double)(num_writes+1);
         num_writes += 1;
+
+        uint64_t port = get_port(pkt);
+        port_avg_wr_lat[port] = (port_avg_wr_lat[port]*port_writes[port]+tmp_lat)/
+                                (double)(port_writes[port]+1);
+        port_writes[port] += 1;
     }
     else
         assert(0);
@@ -363,37 +475,22 @@ void RequestReceiver::CAM_check(Packet* pkt)
     
     if (pkt->cmd==CMD_WRITE)
     {
-        for (rbid=0; rbid<buffer_size; rbid++)
+        /* 
+         * Treat as WAW if there's already WCMD in WAR buffer 
+         * Hence, multiple WAR on same LA is impossible 
+         */
+        rbid = index_find(rbuffer_index, pkt->LADDR);
+        if (rbid<buffer_size && rbuffer_WAR_wid[rbid].valid)
         {
-            /* 
-             * Treat as WAW if there's already WCMD in WAR buffer 
-             * Hence, multiple WAR on same LA is impossible 
-             */
-            if (rbuffer[rbid].valid && rbuffer[rbid].addr==pkt->LADDR)
-            {
-                if (rbuffer_WAR_wid[rbid].valid)
-                {
-                    wasWAR = true;
-                    wbid = get_bid(rbuffer_WAR_wid[rbid].id);
-                    assert(wbuffer[wbid].addr==pkt->LADDR);
-                }
-                break;
-            }
+            wasWAR = true;
+            wbid = get_bid(rbuffer_WAR_wid[rbid].id);
+            assert(wbuffer[wbid].addr==pkt->LADDR);
         }
     }
 
+    /* MUST ensure all command addresses are unique */
     if (wasWAR==false && rbid==buffer_size)
-    {
-        for (wbid=0; wbid<buffer_size; wbid++)
-        {
-            /* MUST ensure all command addresses are unique */
-            if (wbuffer[wbid].valid && wbuffer[wbid].addr==pkt->LADDR)
-            {
-                assert(rbid==buffer_size);
-                break;
-            }
-        }
-    }
+        wbid = index_find(wbuffer_index, pkt->LADDR);
     
     if (dbg_msg && drain_mode)
     {
@@ -463,7 +560,7 @@ void RequestReceiver::hazard_handle(Packet* pkt, hzd_t hzd, uint64_t hit_bid)
 
         /* Retire input BID and response directly */
         ID_unmap(pkt->req_id, CMD_WRITE, pkt);
-        credit_calc(CMD_WRITE, false);
+        credit_calc(CMD_WRITE, false, get_port(pkt));
         
         pkt->cmd = CMD_PKT_DEL;
         pkt->owner->recvResponse(pkt);
@@ -479,7 +576,7 @@ void RequestReceiver::hazard_handle(Packet* pkt, hzd_t hzd, uint64_t hit_bid)
         /* Check whether directly served cmd can be responded now */
         CAM_stalls.push( pkt );
         pkt->req_id = ID_unmap(pkt->req_id, CMD_READ, pkt);
-        credit_calc(CMD_READ, false);
+        credit_calc(CMD_READ, false, get_port(pkt));
         
         num_RAW+=1;
     }
@@ -527,8 +624,6 @@ void RequestReceiver::req_mux( )
     bool is_issue = true;
     if (drain_mode)
     {
-        static uint64_t cnt_rd = 0;
-        static uint64_t cnt_wr = 0;
         bool wr_issuable = isIssuable(CMD_WRITE);
         bool rd_issuable = isIssuable(CMD_READ);
 
@@ -662,16 +757,9 @@ void RequestReceiver::unlink_WAR(uint64_t rbid, uint64_t LADDR)
     wbuffer_WAR_rid[get_bid(WAR_wid)].valid = false;
 
     /* Re-Check RD buffer whether RAR requests exist or not */
-    uint64_t i = 0;
-    for ( ; i<buffer_size; i++)
-    {
-        if (i==rbid) continue;
-        if (rbuffer[i].valid && rbuffer[i].addr==LADDR)
-        {
-            assert(rbuffer_WAR_wid[i].valid==false);
-            break;
-        }
-    }
+    uint64_t i = index_find(rbuffer_index, LADDR, rbid);
+    if (i<buffer_size)
+        assert(rbuffer_WAR_wid[i].valid==false);
 
     if (i<buffer_size)
     {
@@ -758,6 +846,13 @@ void RequestReceiver::register_stats( )
     num_issue = 0;
     num_rd_issue = 0;
     num_wr_issue = 0;
+    memset(port_grants, 0, num_ports*sizeof(uint64_t));
+    memset(port_reads, 0, num_ports*sizeof(uint64_t));
+    memset(port_writes, 0, num_ports*sizeof(uint64_t));
+    memset(port_credit_stalls, 0, num_ports*sizeof(uint64_t));
+    memset(port_avg_rd_lat, 0, num_ports*sizeof(double));
+    memset(port_avg_wr_lat, 0, num_ports*sizeof(double));
+    memset(port_avg_arb_wait, 0, num_ports*sizeof(double));
 
     /* Register phase */
     ADD_STATS(cp_name, num_WAR);
@@ -766,21 +861,35 @@ void RequestReceiver::register_stats( )
     ADD_STATS(cp_name, num_xHZD);
     ADD_STATS(cp_name, num_reads);
     ADD_STATS(cp_name, num_writes);
-    ADD_STATS_N_UNIT(cp_name, max_rd_lat, "cycles");
-    ADD_STATS_N_UNIT(cp_name, min_rd_lat, "cycles");
-    ADD_STATS_N_UNIT(cp_name, avg_rd_lat, "cycles");
-    ADD_STATS_N_UNIT(cp_name, max_wr_lat, "cycles");
-    ADD_STATS_N_UNIT(cp_name, min_wr_lat, "cycles");
-    ADD_STATS_N_UNIT(cp_name, avg_wr_lat, "cycles");
-    ADD_STATS_N_UNIT(cp_name, max_issue_lat, "cycles");
-    ADD_STATS_N_UNIT(cp_name, min_issue_lat, "cycles");
-    ADD_STATS_N_UNIT(cp_name, avg_issue_lat, "cycles");
-    ADD_STATS_N_UNIT(cp_name, max_rd_issue_lat, "cycles");
-    ADD_STATS_N_UNIT(cp_name, min_rd_issue_lat, "cycles");
-    ADD_STATS_N_UNIT(cp_name, avg_rd_issue_lat, "cycles");
-    ADD_STATS_N_UNIT(cp_name, max_wr_issue_lat, "cycles");
-    ADD_STATS_N_UNIT(cp_name, min_wr_issue_lat, "cycles");
-    ADD_STATS_N_UNIT(cp_name, avg_wr_issue_lat, "cycles");
+    ADD_STATS_LAT(cp_name, max_rd_lat);
+    ADD_STATS_LAT(cp_name, min_rd_lat);
+    ADD_STATS_LAT(cp_name, avg_rd_lat);
+    ADD_STATS_LAT(cp_name, max_wr_lat);
+    ADD_STATS_LAT(cp_name, min_wr_lat);
+    ADD_STATS_LAT(cp_name, avg_wr_lat);
+    ADD_STATS_LAT(cp_name, max_issue_lat);
+    ADD_STATS_LAT(cp_name, min_issue_lat);
+    ADD_STATS_LAT(cp_name, avg_issue_lat);
+    ADD_STATS_LAT(cp_name, max_rd_issue_lat);
+    ADD_STATS_LAT(cp_name, min_rd_issue_lat);
+    ADD_STATS_LAT(cp_name, avg_rd_issue_lat);
+    ADD_STATS_LAT(cp_name, max_wr_issue_lat);
+    ADD_STATS_LAT(cp_name, min_wr_issue_lat);
+    ADD_STATS_LAT(cp_name, avg_wr_issue_lat);
+
+    if (num_ports>1)
+    {
+        for (uint64_t p=0; p<num_ports; p++)
+        {
+            ADD_STATS_ITER(cp_name, port_grants, p);
+            ADD_STATS_ITER(cp_name, port_reads, p);
+            ADD_STATS_ITER(cp_name, port_writes, p);
+            ADD_STATS_ITER(cp_name, port_credit_stalls, p);
+            ADD_STATS_ITER_LAT(cp_name, port_avg_rd_lat, p);
+            ADD_STATS_ITER_LAT(cp_name, port_avg_wr_lat, p);
+            ADD_STATS_ITER_LAT(cp_name, port_avg_arb_wait, p);
+        }
+    }
 }
 
 void RequestReceiver::calculate_stats( )
@@ -819,5 +928,39 @@ void RequestReceiver::calculate_stats( )
         min_wr_issue_lat /= ticks_per_cycle;
         avg_wr_issue_lat /= ticks_per_cycle;
     }
+
+    for (uint64_t p=0; p<num_ports; p++)
+    {
+        port_avg_rd_lat[p] /= ticks_per_cycle;
+        port_avg_wr_lat[p] /= ticks_per_cycle;
+        port_avg_arb_wait[p] /= ticks_per_cycle;
+    }
+}
+
+void RequestReceiver::index_insert(cam_index_t& index, uint64_t addr, uint64_t bid)
+{
+    bool inserted = index[addr].insert(bid).second;
+    assert(inserted);
 }
 
+void RequestReceiver::index_erase(cam_index_t& index, uint64_t addr, uint64_t bid)
+{
+    cam_index_t::iterator it = index.find(addr);
+    assert(it!=index.end( ) && it->second.count(bid)==1);
+    it->second.erase(bid);
+    if (it->second.empty( ))
+        index.erase(it);
+}
+
+uint64_t RequestReceiver::index_find(cam_index_t& index, uint64_t addr, uint64_t except)
+{
+    /* The lowest BID wins as the CAM did with its priority encoder */
+    cam_index_t::iterator it = index.find(addr);
+    if (it==index.end( ))
+        return buffer_size;
+
+    std::set<uint64_t>::iterator b_it = it->second.begin( );
+    if (*b_it==except)
+        b_it++;
+    return (b_it==it->second.end( ))? buffer_size : *b_it;
+}
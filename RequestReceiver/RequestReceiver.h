@@ -43,6 +43,7 @@ namespace PCMCsim
     class MemoryControlSystem;
     class DataCache;
     class Parser;
+    class IDAllocator;
 
     class RequestReceiver : public Component
     {
@@ -96,22 +97,35 @@ namespace PCMCsim
             DataBlock wdata;    // user: wbuffer
         } entry_t;
 
-        /* Interface logics */
-        std::vector<uint64_t> credits;
+        /* Interface logics (credits are partitioned to host ports) */
+        std::vector<std::vector<uint64_t>> credits; // [port][qtype]
 
         bool drain_mode;
         uint64_t credit_RD;
         uint64_t credit_WR;
+        uint64_t port_credit;   // credits of each port per queue
 
         void insert_buffer(Packet* pkt);
         void resp_handle(Packet* pkt);
-        void credit_calc( cmd_t cmd, bool in );
+        void credit_calc( cmd_t cmd, bool in, uint64_t port );
+        uint64_t get_port(Packet* pkt);
+
+        /* Weighted round-robin arbiter of host ports (Stage-0) */
+        typedef std::pair<ncycle_t, Packet*> arb_entry_t; // <arrival, pkt>
+
+        uint64_t num_ports;
+        std::vector<uint64_t> port_weight;
+        std::vector<std::list<arb_entry_t>> portq;
+        std::vector<Packet*> stalled_pkt; // req already counted as credit-stalled
+        uint64_t arb_port;      // port holding the grant
+        uint64_t arb_cnt;       // consecutive grants of arb_port
+        ncycle_t last_grant;    // tick of the last grant (one grant/cycle)
+
+        void port_arb( );
 
         /* ID remap management (Stage-1) */
-        std::list<uint64_t> avail_RID;
-        std::list<uint64_t> avail_WID;
-        std::map<uint64_t, uint64_t> alloc_RID; // <ID, host ID>
-        std::map<uint64_t, uint64_t> alloc_WID;
+        IDAllocator* RID_alloc; // <ID, host ID>
+        IDAllocator* WID_alloc;
 
         void ID_remap( Packet* pkt );
         uint64_t ID_unmap( uint64_t ID, cmd_t type, Packet* pkt ); // return host ID
@@ -127,6 +141,8 @@ namespace PCMCsim
         uint64_t maxIssue_RD;
         uint64_t maxIssue_WR;
         uint64_t mux_st;
+        uint64_t cnt_rd;
+        uint64_t cnt_wr;
         ncycle_t wake_req_mux;
         ncycle_t last_wake_req_mux;
 
@@ -147,6 +163,16 @@ namespace PCMCsim
         void link_WAR(uint64_t rbid, uint64_t wbid);
         void unlink_WAR(uint64_t rbid, uint64_t LADDR);
 
+        /* Hash index of valid buffer entries (LADDR->BIDs) for CAM check */
+        typedef std::unordered_map<uint64_t, std::set<uint64_t>> cam_index_t;
+        cam_index_t rbuffer_index;
+        cam_index_t wbuffer_index;
+
+        void index_insert(cam_index_t& index, uint64_t addr, uint64_t bid);
+        void index_erase(cam_index_t& index, uint64_t addr, uint64_t bid);
+        uint64_t index_find(cam_index_t& index, uint64_t addr, 
+                            uint64_t except=std::numeric_limits<uint64_t>::max( ));
+
         /* FIFOs that stack requests */
         std::vector<std::list<Packet*>> FIFO;
 
@@ -196,6 +222,14 @@ namespace PCMCsim
         ncycle_t min_wr_issue_lat;
         double avg_wr_issue_lat;
         uint64_t num_wr_issue;
+
+        uint64_t* port_grants;
+        uint64_t* port_reads;
+        uint64_t* port_writes;
+        uint64_t* port_credit_stalls;
+        double* port_avg_rd_lat;
+        double* port_avg_wr_lat;
+        double* port_avg_arb_wait;
         
         void register_stats( ) override;
    };
@@ -0,0 +1,165 @@
+#include "TraceExec/SweepExec.h"
+#include "TraceExec/TraceExec.h"
+#include <thread>
+
+using namespace PCMCsim;
+
+SweepExec::SweepExec(int argc, char* argv[])
+: next_variant(0), num_threads(0), input_trace(""), config_path(""), 
+sweep_path(""), stat_prefix("sweep"), max_trc(0)
+{
+    config_path = "./configs/example_pcmc.cfg";
+
+    for (int i=1; i<argc; i+=2)
+    {
+        std::string arg_str(argv[i]);
+        if (i+1==argc || argv[i+1][0]=='-')
+        {
+            std::cerr << "Error getting option value! " 
+                << "The value of option is unavailable " 
+                << "(or do not name the value begun with '-')" 
+                << std::endl;
+            assert(0);
+            exit(1);
+        }
+
+        if (arg_str=="-i" || arg_str=="--input")
+            input_trace = argv[i+1];
+        else if (arg_str=="-c" || arg_str=="--config")
+            config_path = argv[i+1];
+        else if (arg_str=="-s" || arg_str=="--statout")
+            stat_prefix = argv[i+1];
+        else if (arg_str=="-n" || arg_str=="--numline")
+            max_trc = atoi(argv[i+1]);
+        else if (arg_str=="-w" || arg_str=="--sweep")
+            sweep_path = argv[i+1];
+        else if (arg_str=="-j" || arg_str=="--jobs")
+            num_threads = atoi(argv[i+1]);
+        else 
+        {
+            std::cerr << "Invalid option! See info with --help/-h" << std::endl;
+            assert(0);
+            exit(1);
+        }
+    }
+
+    if (input_trace=="")
+    {
+        std::cerr << "Please input trace file path with -i" << std::endl;
+        assert(0);
+        exit(1);
+    }
+
+    load_sweep( );
+
+    /* Decode the trace only once for all variants */
+    TraceGen* trc_gen = new TraceGen(input_trace);
+    trc_gen->load_trace(trc_buf, max_trc);
+    delete trc_gen;
+
+    if (num_threads==0)
+        num_threads = std::thread::hardware_concurrency( );
+    if (num_threads==0)
+        num_threads = 1;
+    if (num_threads>variants.size( ))
+        num_threads = variants.size( );
+}
+
+SweepExec::~SweepExec( )
+{
+}
+
+bool SweepExec::is_sweep(int argc, char* argv[])
+{
+    for (int i=1; i<argc; i++)
+    {
+        std::string arg_str(argv[i]);
+        if (arg_str=="-w" || arg_str=="--sweep")
+            return true;
+    }
+
+    return false;
+}
+
+void SweepExec::load_sweep( )
+{
+    std::ifstream fin(sweep_path.c_str( ));
+    if (fin.good( )==false)
+    {
+        std::cerr << "[SweepExec] Error! Sweep spec can't open!" << std::endl;
+        assert(0);
+        exit(1);
+    }
+
+    std::set<std::string> names;
+    std::string line, token;
+    while (getline(fin, line))
+    {
+        std::string::size_type pos = line.find("#");
+        if (pos!=std::string::npos)
+            line = line.substr(0, pos);
+
+        std::istringstream sline(line);
+        variant_t var;
+        if (!(sline >> var.name))
+            continue;
+
+        if (names.insert(var.name).second==false)
+        {
+            std::cerr << "[SweepExec] Error! Duplicated variant - " 
+                << var.name << std::endl;
+            assert(0);
+            exit(1);
+        }
+
+        /* Keep side outputs of variants apart (overridable per variant) */
+        std::string prefix = stat_prefix + "." + var.name;
+        var.overrides.push_back("global.epoch_path=" + prefix + ".epoch.csv");
+        var.overrides.push_back("global.req_trace.path=" + prefix + ".trace.json");
+        while (sline >> token)
+            var.overrides.push_back(token);
+
+        variants.push_back(var);
+    }
+    fin.close( );
+
+    if (variants.empty( ))
+    {
+        std::cerr << "[SweepExec] Error! No variant in sweep spec!" << std::endl;
+        assert(0);
+        exit(1);
+    }
+}
+
+int SweepExec::exec( )
+{
+    std::cout << "[SweepExec] " << variants.size( ) << " variants, " 
+        << num_threads << " threads, " << trc_buf.size( ) << " trace lines" 
+        << std::endl;
+
+    std::vector<std::thread> pool;
+    for (uint64_t t=0; t<num_threads; t++)
+        pool.push_back(std::thread(&SweepExec::worker, this));
+
+    for (uint64_t t=0; t<pool.size( ); t++)
+        pool[t].join( );
+
+    return 0;
+}
+
+void SweepExec::worker( )
+{
+    while (true)
+    {
+        uint64_t idx = next_variant++;
+        if (idx>=variants.size( ))
+            break;
+
+        variant_t& var = variants[idx];
+        TraceExec* te = new TraceExec(config_path, var.overrides, &trc_buf,
+                                      input_trace, stat_prefix+"."+var.name, max_trc);
+        te->exec( );
+        delete te;
+    }
+}
+
@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) 2019 Computer Architecture and Paralllel Processing Lab, 
+ * Seoul National University, Republic of Korea. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     1. Redistribution of source code must retain the above copyright 
+ *        notice, this list of conditions and the follwoing disclaimer.
+ *     2. Redistributions in binary form must reproduce the above copyright 
+ *        notice, this list conditions and the following disclaimer in the 
+ *        documentation and/or other materials provided with the distirubtion.
+ *     3. Neither the name of the copyright holders nor the name of its 
+ *        contributors may be used to endorse or promote products derived from 
+ *        this software without specific prior written permission. 
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Authors: Hyokeun Lee (hklee@capp.snu.ac.kr)
+ *
+ * Description: class for running a configuration sweep in one process.
+ * The trace is decoded once and shared (read-only) by all variants, and 
+ * each variant owns its MemoryControlSystem running on a worker thread.
+ *
+ * Sweep spec format (one variant per line, '#' for comments):
+ *   <variant_name> [key=value | override.cfg] ...
+ */
+
+#ifndef __PCMCSIM_SWEEP_EXEC_H_
+#define __PCMCSIM_SWEEP_EXEC_H_
+
+#include "base/PCMCTypes.h"
+#include "TraceGen/TraceGen.h"
+#include <atomic>
+
+namespace PCMCsim
+{
+    class SweepExec
+    {
+      public:
+        SweepExec( ) = delete;
+        SweepExec(int argc, char* argv[]);
+        ~SweepExec( );
+
+        int exec( );
+
+        static bool is_sweep(int argc, char* argv[]);
+
+      private:
+        typedef struct _variant_t
+        {
+            std::string name;
+            std::vector<std::string> overrides;
+        } variant_t;
+
+        std::vector<TraceGen::trc_line_t> trc_buf;
+        std::vector<variant_t> variants;
+        std::atomic<uint64_t> next_variant;
+        uint64_t num_threads;
+
+        void load_sweep( );
+        void worker( );
+
+        /* Argument information */
+        std::string input_trace;
+        std::string config_path;
+        std::string sweep_path;
+        std::string stat_prefix;
+        uint64_t max_trc;
+    };
+};
+
+#endif
@@ -5,12 +5,15 @@
 #include "base/EventQueue.h"
 #include "base/Component.h"
 #include "base/MemInfo.h"
+#include "base/ReqTracer.h"
+#include "Parsers/Parser.h"
 
 using namespace PCMCsim;
 
 TraceExec::TraceExec(int argc, char* argv[])
-: trc_gen(NULL), pendPkt(NULL), trc_end(false), issued_trc(0), 
-max_trc(0), input_trace(""), config_path(""), stat_path("")
+: trc_gen(NULL), trc_buf(NULL), nextPkt(NULL), trc_end(false), issued_trc(0), 
+max_trc(0), epoch_ticks(0), epoch_reqs(0), num_resp(0), epoch_delta(true),
+input_trace(""), config_path(""), stat_path("")
 {
     /* Setup according to arguments */
     input_trace = "";
@@ -26,6 +29,8 @@ max_trc(0), input_trace(""), config_path(""), stat_path("")
                 << "\t-c, --config: path of config file\n"
                 << "\t-s, --statout: directory path of statistics output\n" 
                 << "\t-n, --numline: number of lines to simulate\n"
+                << "\t-w, --sweep: path of sweep spec (runs variants in parallel)\n"
+                << "\t-j, --jobs: number of sweep threads (default: all cores)\n"
                 << std::endl;
             exit(1);
         }
@@ -76,8 +81,44 @@ max_trc(0), input_trace(""), config_path(""), stat_path("")
 
     /* Setup simulation objects */
     trc_gen = new TraceGen(input_trace);
+    setup_sim(std::vector<std::string>( ));
+}
+
+TraceExec::TraceExec(const std::string& cfg_path, 
+                     const std::vector<std::string>& overrides,
+                     const std::vector<TraceGen::trc_line_t>* shared_trc,
+                     const std::string& trc_path, const std::string& stat_out, 
+                     uint64_t max_lines)
+: trc_gen(NULL), trc_buf(shared_trc), nextPkt(NULL), trc_end(false), issued_trc(0), 
+max_trc(max_lines), epoch_ticks(0), epoch_reqs(0), num_resp(0), epoch_delta(true),
+input_trace(trc_path), config_path(cfg_path), stat_path(stat_out)
+{
+    assert(trc_buf!=NULL);
+    if (stat_path!="")
+    {
+        stat_os.open(stat_path.c_str( ), std::ofstream::out | std::ofstream::app);
+        if (stat_os.is_open( )==false)
+        {
+            std::cerr << "Unable to open statistics output file!" << std::endl;
+            assert(0);
+            exit(1);
+        }
+    }
+
+    setup_sim(overrides);
+}
+
+TraceExec::~TraceExec( )
+{
+    delete geq;
+    delete memsys;
+    delete trc_gen;
+}
+
+void TraceExec::setup_sim(const std::vector<std::string>& overrides)
+{
     geq = new GlobalEventQueue( );
-    memsys = new MemoryControlSystem(config_path, geq);
+    memsys = new MemoryControlSystem(config_path, geq, "", overrides);
     memsys->sys_name = memsys->getParamSTR("global.system", "PCM");
     if (memsys->sys_name=="PCM" || memsys->sys_name=="PRAM")
         memsys->setup_pcmc(dynamic_cast<Component*>(this));
@@ -91,13 +132,29 @@ max_trc(0), input_trace(""), config_path(""), stat_path("")
     }
 
     ticks_per_cycle= memsys->getParamUINT64("global.ticks_per_cycle", 1);
-}
 
-TraceExec::~TraceExec( )
-{
-    delete geq;
-    delete memsys;
-    delete trc_gen;
+    /* Each host port (agent) has its own pending request */
+    pendPkt.resize(memsys->parser->num_ports);
+    port_lookahead = memsys->getParamUINT64("global.port_lookahead", 4);
+    assert(port_lookahead>0);
+
+    /* Setup epoch stats dump (every N ticks and/or N requests) */
+    epoch_ticks = memsys->getParamUINT64("global.epoch_ticks", 0);
+    epoch_reqs = memsys->getParamUINT64("global.epoch_reqs", 0);
+    epoch_delta = memsys->getParamBOOL("global.epoch_delta", true);
+    if (epoch_ticks>0 || epoch_reqs>0)
+    {
+        std::string epoch_path = memsys->getParamSTR("global.epoch_path", 
+                                                     "epoch_stats.csv");
+        epoch_os.open(epoch_path.c_str( ), std::ofstream::out);
+        if (epoch_os.is_open( )==false)
+        {
+            std::cerr << "Unable to open epoch statistics output file!" << std::endl;
+            assert(0);
+            exit(1);
+        }
+        memsys->init_epoch_stats(epoch_os);
+    }
 }
 
 void TraceExec::recvResponse(Packet* pkt, ncycle_t /*delay*/)
@@ -105,8 +162,16 @@ void TraceExec::recvResponse(Packet* pkt, ncycle_t /*delay*/)
     std::set<Packet*>::iterator s_it = issued_pkt.find(pkt);
     if (s_it!=issued_pkt.end( ))
     {
+        /* Writes are retired directly to the owner (not via parser) */
+        if (memsys->tracer)
+            memsys->tracer->finish(pkt, geq->getCurrentTick( ));
+
         delete (*s_it);
         issued_pkt.erase(s_it);
+        num_resp++;
+
+        if (epoch_reqs>0 && num_resp%epoch_reqs==0)
+            registerCallback((CallbackPtr)&TraceExec::epoch_dump, 1);
         
         if (trc_end && issued_pkt.empty( ))
             geq->escape = true; 
@@ -126,58 +191,116 @@ void TraceExec::handle_events(ncycle_t curr_tick)
 int TraceExec::exec( )
 {
     registerCallback((CallbackPtr)&TraceExec::req_issue, 1);
+    if (epoch_ticks>0)
+        registerCallbackAt((CallbackPtr)&TraceExec::epoch_tick, epoch_ticks);
     geq->handle_events( );
 
+    /* Flush the last (partial) epoch before stats are finalized */
+    if (epoch_os.is_open( ))
+    {
+        memsys->print_epoch_stats(epoch_os, epoch_delta);
+        epoch_os.close( );
+    }
+
     /* Print out stats */
     std::ostream& ref_stream = (stat_os.is_open( ))? stat_os:std::cout;
-    ref_stream << "Input-trace-file=" << input_trace << std::endl;
-    ref_stream << "Config-path=" << config_path << std::endl;
+    if (memsys->getParamSTR("global.stats_format", "text")=="text")
+    {
+        ref_stream << "Input-trace-file=" << input_trace << std::endl;
+        ref_stream << "Config-path=" << config_path << std::endl;
+    }
     memsys->print_stats(ref_stream);
+    if (memsys->tracer)
+        memsys->tracer->print_chrome_trace( );
 
     return 0;
 }
 
 void TraceExec::req_issue( )
 {
-    if (pendPkt==NULL)
+    /* 
+     * Distribute trace lines to the per-port look-ahead queues in trace order
+     * until every port has a request, so a stalled port does not block others.
+     * Reading stops early only if the line's port queue is full
+     */
+    bool trc_drained = false;
+    while (true)
     {
-        if ((max_trc>0 && issued_trc>=max_trc) || trc_gen->getNextTrcLine( )==false)
+        bool all_pending = true;
+        for (uint64_t p=0; p<pendPkt.size( ) && all_pending; p++)
+            all_pending = (pendPkt[p].empty( )==false);
+        if (all_pending)
+            break;
+
+        if (nextPkt==NULL)
         {
-            std::cout << "Reached the pre-defined trace maximum number" << std::endl;
-            trc_end = true;
+            if ((max_trc>0 && issued_trc>=max_trc) || next_trc_line( )==false)
+            {
+                trc_drained = true;
+                break;
+            }
+            nextPkt = wrap_pkt( );
         }
-        else
-            pendPkt = wrap_pkt( );
+
+        uint64_t port = memsys->parser->get_port(nextPkt);
+        if (pendPkt[port].size( )>=port_lookahead)
+            break;
+        pendPkt[port].push_back(nextPkt);
+        nextPkt = NULL;
     }
 
-    if (trc_end) return;
+    bool all_issued = trc_drained;
+    for (uint64_t p=0; p<pendPkt.size( ) && all_issued; p++)
+        all_issued = pendPkt[p].empty( );
 
-    if (memsys->isReady(pendPkt))
+    if (all_issued)
     {
-        issued_pkt.insert(pendPkt);
-        memsys->recvRequest(pendPkt, 1);
-        pendPkt = NULL;
+        std::cout << "Reached the pre-defined trace maximum number" << std::endl;
+        trc_end = true;
+        return;
+    }
+
+    /* Ports are independent, so each can issue a request every cycle */
+    for (uint64_t p=0; p<pendPkt.size( ); p++)
+    {
+        if (pendPkt[p].empty( )==false && memsys->isReady(pendPkt[p].front( )))
+        {
+            issued_pkt.insert(pendPkt[p].front( ));
+            memsys->recvRequest(pendPkt[p].front( ), 1);
+            pendPkt[p].pop_front( );
+        }
     }
 
     registerCallback((CallbackPtr)&TraceExec::req_issue, 1);
 }
 
+bool TraceExec::next_trc_line( )
+{
+    if (trc_buf)
+        return (issued_trc<trc_buf->size( ));
+
+    return trc_gen->getNextTrcLine( );
+}
+
 Packet* TraceExec::wrap_pkt( )
 {
+    const TraceGen::trc_line_t& line_info = 
+        (trc_buf)? (*trc_buf)[issued_trc] : trc_gen->line_info;
+
     Packet* pkt = new Packet(memsys->info->PAGE_SIZE/memsys->info->HOST_TX_SIZE);
     assert(pkt!=NULL);
     pkt->owner = this;
     pkt->src_id = SRC_HOST;
     pkt->req_id = issued_trc;
-    pkt->cmd = trc_gen->line_info.cmd_type;
-    pkt->LADDR = trc_gen->line_info.LADDR;
-    pkt->tid = trc_gen->line_info.id;
+    pkt->cmd = line_info.cmd_type;
+    pkt->LADDR = line_info.LADDR;
+    pkt->tid = line_info.id;
 
     if (pkt->cmd==CMD_WRITE)
     {
         pkt->buffer_data.setSize(memsys->info->HOST_TX_SIZE);
 //        for (uint64_t i=0; i<memsys->info->HOST_TX_SIZE; i++)
-//            pkt->buffer_data.setByte(i, trc_gen->line_info.data[i]);
+//            pkt->buffer_data.setByte(i, line_info.data[i]);
     }
 
     if (pkt->LADDR>memsys->info->get_capacity_bits( ))
@@ -191,3 +314,20 @@ Packet* TraceExec::wrap_pkt( )
     return pkt;
 }
 
+void TraceExec::epoch_tick( )
+{
+    epoch_dump( );
+
+    /* Stop ticking if nothing remains to be simulated */
+    if (trc_end==false || issued_pkt.empty( )==false)
+    {
+        registerCallbackAt((CallbackPtr)&TraceExec::epoch_tick, 
+                           geq->getCurrentTick( )+epoch_ticks);
+    }
+}
+
+void TraceExec::epoch_dump( )
+{
+    memsys->print_epoch_stats(epoch_os, epoch_delta);
+}
+
@@ -35,11 +35,11 @@
 
 #include "base/PCMCTypes.h"
 #include "base/Component.h" 
+#include "TraceGen/TraceGen.h"
 
 namespace PCMCsim
 {
     class MemoryControlSystem;
-    class TraceGen;
     class GlobalEventQueue;
     class Packet;
 
@@ -48,6 +48,10 @@ namespace PCMCsim
       public:
         TraceExec( ) = delete;
         TraceExec(int argc, char* argv[]);
+        TraceExec(const std::string& cfg_path, const std::vector<std::string>& overrides,
+                  const std::vector<TraceGen::trc_line_t>* shared_trc, 
+                  const std::string& trc_path, const std::string& stat_out, 
+                  uint64_t max_lines=0);
         ~TraceExec( );
 
         void recvResponse(Packet* pkt, ncycle_t delay=1) override;
@@ -57,16 +61,31 @@ namespace PCMCsim
 
       private:
         TraceGen* trc_gen;
+        const std::vector<TraceGen::trc_line_t>* trc_buf; // decoded trace (shared)
         std::set<Packet*> issued_pkt;
-        Packet* pendPkt;
+        std::vector<std::deque<Packet*>> pendPkt; // look-ahead reqs of each host port
+        Packet* nextPkt;                // next trace line (its port queue is full)
+        uint64_t port_lookahead;        // max look-ahead reqs per port
 
         bool trc_end;
         uint64_t issued_trc;
         uint64_t max_trc;
 
+        void setup_sim(const std::vector<std::string>& overrides);
+        bool next_trc_line( );
         Packet* wrap_pkt( );
         void req_issue( );
 
+        /* Epoch (time-series) stats dump */
+        ncycle_t epoch_ticks;
+        uint64_t epoch_reqs;
+        uint64_t num_resp;
+        bool epoch_delta;
+        std::ofstream epoch_os;
+
+        void epoch_tick( );
+        void epoch_dump( );
+
         /* Argument information */
         std::string input_trace;
         std::string config_path;
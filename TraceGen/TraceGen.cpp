@@ -106,6 +106,19 @@ bool TraceGen::getNextTrcLine( )
 //    return true;
 }
 
+uint64_t TraceGen::load_trace(std::vector<trc_line_t>& trc_buf, uint64_t max_lines)
+{
+    while ((max_lines==0 || trc_buf.size( )<max_lines) && getNextTrcLine( ))
+    {
+        trc_line_t line = line_info;
+        line.data = NULL;
+        line.meta = NULL;
+        trc_buf.push_back(line);
+    }
+
+    return trc_buf.size( );
+}
+
 void TraceGen::printTrcLine( )
 {
     std::cout << line_info.cycle << " " << ((line_info.cmd_type==CMD_READ)? "R":"W") <<
@@ -72,6 +72,9 @@ namespace PCMCsim
         uint32_t getMetaSize( ) { return META_BYTE; }
         bool getNextTrcLine( );
         void printTrcLine( );
+
+        /* Decode whole trace into memory (data/meta are not kept) */
+        uint64_t load_trace(std::vector<trc_line_t>& trc_buf, uint64_t max_lines=0);
         
       private:
         uint64_t DATA_BYTE;
@@ -4,19 +4,26 @@
 #include "base/DataBlock.h"
 #include "base/Packet.h"
 #include "base/Stats.h"
+#include <atomic>
 
 using namespace PCMCsim;
 
+/* 
+ * Monotonic across all instances (and threads), so relative order 
+ * of components within a simulation is the order of declaration
+ */
+static std::atomic<uint64_t> decl_counter(0);
+
 Component::Component( )
 :id(0), dbg_msg(false),ready(false), ticks_per_cycle(1), 
-memsys(NULL), geq(NULL), parent(NULL), child(NULL)
+memsys(NULL), geq(NULL), decl_order(decl_counter++), parent(NULL), child(NULL)
 {
     stats = new Stats( );
 }
 
 Component::Component(MemoryControlSystem* memsys_)
 :id(0), dbg_msg(false), ready(false), ticks_per_cycle(1), 
-memsys(memsys_), geq(NULL), parent(NULL), child(NULL)
+memsys(memsys_), geq(NULL), decl_order(decl_counter++), parent(NULL), child(NULL)
 {
     if (memsys) 
         geq = memsys->getGlobalEventQueue( );
@@ -302,3 +309,8 @@ void Component::print_stats(std::ostream& os)
     stats->print(os);
 }
 
+void Component::collect_stats(std::vector<Stats*>& slist)
+{
+    slist.push_back(stats);
+}
+
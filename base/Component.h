@@ -91,10 +91,15 @@ namespace PCMCsim
         
         /* Stats */
         virtual void calculate_stats( ) { }
+        virtual void sync_stats( ) { }  // bring lazily-accounted stats up to date
         virtual void print_stats(std::ostream& os);
+        virtual void collect_stats(std::vector<Stats*>& slist);
 
         bool is_msg( ) { return dbg_msg; }
 
+        /* Declaration order (used for ordering events in the same tick) */
+        uint64_t get_decl_order( ) { return decl_order; }
+
       protected:
         uint32_t id;                // module id
         bool dbg_msg;
@@ -103,6 +108,7 @@ namespace PCMCsim
         MemoryControlSystem* memsys;        // PCM controller top module
         GlobalEventQueue* geq;      // event queue pointer (gotten from PCMC)
         std::string cp_name;        // component name
+        uint64_t decl_order;        // order of instantiation
 
         Component* parent;
         Component* child;
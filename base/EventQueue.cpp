@@ -31,7 +31,7 @@ void GlobalEventQueue::handle_events( )
 
         /* Events of components are executed as declaration order */
         curr_tick = eq_iter->first;
-        std::set<Component*>::iterator cp_iter = eq_iter->second.begin( );
+        tick_events_t::iterator cp_iter = eq_iter->second.begin( );
         for ( ; cp_iter != eq_iter->second.end( ); ) 
         {
             (*cp_iter)->handle_events(curr_tick);
@@ -57,7 +57,7 @@ void GlobalEventQueue::handle_events(ncycle_t goal_tick)
 
         /* Events of components are executed as declaration order */
         curr_tick = eq_iter->first;
-        std::set<Component*>::iterator cp_iter = eq_iter->second.begin( );
+        tick_events_t::iterator cp_iter = eq_iter->second.begin( );
         for ( ; cp_iter != eq_iter->second.end( ); ) 
         {
             (*cp_iter)->handle_events(curr_tick);
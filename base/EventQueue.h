@@ -43,7 +43,17 @@ namespace PCMCsim
 {
     class Packet;
 
-    typedef std::map<uint64_t, std::set<Component*>> event_queue_t;
+    /* Components in the same tick are handled in declaration order */
+    struct decl_order_less
+    {
+        bool operator()(Component* a, Component* b) const
+        {
+            return a->get_decl_order( )<b->get_decl_order( );
+        }
+    };
+
+    typedef std::set<Component*, decl_order_less> tick_events_t;
+    typedef std::map<uint64_t, tick_events_t> event_queue_t;
 
     class GlobalEventQueue
     {
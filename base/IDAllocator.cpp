@@ -0,0 +1,62 @@
+#include "base/IDAllocator.h"
+
+using namespace PCMCsim;
+
+IDAllocator::IDAllocator(uint64_t capacity_, uint64_t id_base_)
+:capacity(capacity_), id_base(id_base_), num_free(capacity_), free_hint(0)
+{
+    assert(capacity>0);
+    bitmap.resize((capacity+63)/64, 0);
+    values.resize(capacity, 0);
+
+    /* Bits beyond the capacity are never conferred */
+    if (capacity%64!=0)
+        bitmap.back( ) = ~((1ULL<<(capacity%64))-1);
+}
+
+uint64_t IDAllocator::alloc(uint64_t value)
+{
+    assert(num_free>0);
+    uint64_t w = free_hint;
+    while (bitmap[w]==~0ULL)
+        w++;
+
+    uint64_t idx = w*64+__builtin_ctzll(~bitmap[w]);
+    assert(idx<capacity);
+    bitmap[w] |= (1ULL<<(idx%64));
+    values[idx] = value;
+    num_free -= 1;
+    free_hint = w;
+
+    return id_base+idx;
+}
+
+uint64_t IDAllocator::release(uint64_t ID)
+{
+    uint64_t idx = get_idx(ID);
+    assert(is_alloc(ID));
+    bitmap[idx/64] &= ~(1ULL<<(idx%64));
+    num_free += 1;
+    if (idx/64<free_hint)
+        free_hint = idx/64;
+
+    return values[idx];
+}
+
+bool IDAllocator::is_alloc(uint64_t ID)
+{
+    uint64_t idx = get_idx(ID);
+    return (bitmap[idx/64]>>(idx%64))&0x1;
+}
+
+uint64_t IDAllocator::get_value(uint64_t ID)
+{
+    assert(is_alloc(ID));
+    return values[get_idx(ID)];
+}
+
+uint64_t IDAllocator::get_idx(uint64_t ID)
+{
+    assert(ID>=id_base && ID-id_base<capacity);
+    return ID-id_base;
+}
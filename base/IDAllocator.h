@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2019 Computer Architecture and Paralllel Processing Lab, 
+ * Seoul National University, Republic of Korea. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     1. Redistribution of source code must retain the above copyright 
+ *        notice, this list of conditions and the follwoing disclaimer.
+ *     2. Redistributions in binary form must reproduce the above copyright 
+ *        notice, this list conditions and the following disclaimer in the 
+ *        documentation and/or other materials provided with the distirubtion.
+ *     3. Neither the name of the copyright holders nor the name of its 
+ *        contributors may be used to endorse or promote products derived from 
+ *        this software without specific prior written permission. 
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Authors: Hyokeun Lee (hklee@capp.snu.ac.kr)
+ *
+ * Description: This is a fixed-capacity ID allocator. Free IDs are kept 
+ * in a bitmap and the lowest one is conferred (find-first-zero), while 
+ * the value tied to each ID (e.g., host ID) is kept in a flat array
+ */
+
+#ifndef __PCMCSIM_ID_ALLOCATOR_H_
+#define __PCMCSIM_ID_ALLOCATOR_H_
+
+#include "base/PCMCTypes.h"
+
+namespace PCMCsim
+{
+    class IDAllocator
+    {
+      public:
+        IDAllocator( ) = delete;
+        IDAllocator(uint64_t capacity_, uint64_t id_base_=0);
+        ~IDAllocator( ) { }
+
+        uint64_t alloc(uint64_t value=0);   // return the lowest free ID
+        uint64_t release(uint64_t ID);      // return the value tied to ID
+
+        bool is_alloc(uint64_t ID);
+        uint64_t get_value(uint64_t ID);
+
+        bool full( ) { return num_free==0; }   // every ID is conferred
+        uint64_t get_free( ) { return num_free; }
+        uint64_t get_capacity( ) { return capacity; }
+
+      private:
+        uint64_t capacity;
+        uint64_t id_base;       // IDs are [id_base, id_base+capacity)
+        uint64_t num_free;
+        uint64_t free_hint;     // no free ID in words before this
+
+        std::vector<uint64_t> bitmap;   // 1 bit per allocated ID
+        std::vector<uint64_t> values;
+
+        uint64_t get_idx(uint64_t ID);
+    };
+};
+
+#endif
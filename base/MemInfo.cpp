@@ -1,5 +1,6 @@
 #include "base/MemInfo.h"
 #include "base/MemoryControlSystem.h"
+#include "base/Packet.h"
 
 using namespace PCMCsim;
 
@@ -61,6 +62,33 @@ AddressDecoder::AddressDecoder(MemoryControlSystem* memsys, std::string cfg_head
         assert(0);
         exit(1);
     }
+
+    update_tables( );
+}
+
+void AddressDecoder::update_tables( )
+{
+    /* Shift of a field is the sum of widths of lower-ordered fields */
+    uint64_t ref_bit1 = 1;
+    for (uint64_t f=0; f<NUM_FIELDS; f++)
+    {
+        shifts[f] = 0;
+        for (uint64_t i=0; i<NUM_FIELDS; i++)
+        {
+            if (orders[i]<orders[f])
+                shifts[f] += widths[i];
+        }
+        masks[f] = (widths[f]>=64)? ~0ULL : ((ref_bit1<<widths[f])-1);
+    }
+
+    host_mask = (HOST_TX_OFFSET>=64)? 0 : ~((ref_bit1<<HOST_TX_OFFSET)-1);
+    page_mask = (PAGE_OFFSET>=64)? 0 : ~((ref_bit1<<PAGE_OFFSET)-1);
+}
+
+void AddressDecoder::set_width(addr_field_t field, uint64_t width)
+{
+    widths[field] = width;
+    update_tables( );
 }
 
 addr_field_t AddressDecoder::get_field(uint64_t order)
@@ -122,25 +150,22 @@ void AddressDecoder::print( )
     std::cout << "\n===================================================" << std::endl;
 }
 
-uint64_t AddressDecoder::decode_addr(uint64_t addr, addr_field_t field)
+void AddressDecoder::decode_all(uint64_t addr, addr_coord_t& coord)
 {
     uint64_t rv = addr>>PAGE_OFFSET; // truncate offset bits
-    uint64_t ref_bit1 = 1;
-    uint64_t shift_mod = 0;
-    uint64_t shift_div = 0;
-    for (uint64_t i=0; i<NUM_FIELDS; i++)
-    {
-        if (orders[i]<orders[field])
-        {
-            shift_div+=widths[i];
-            shift_mod+=widths[i];
-        }
-        else if (orders[i]==orders[field])
-            shift_mod+=widths[i];
-    }
-    rv = rv % (ref_bit1<<shift_mod);
-    rv = rv / (ref_bit1<<shift_div);
-    return rv;
+    for (uint64_t f=0; f<NUM_FIELDS; f++)
+        coord.fld[f] = (rv>>shifts[f]) & masks[f];
+    coord.addr = addr;
+    coord.adec = this;
+}
+
+const addr_coord_t& AddressDecoder::decode_pkt(Packet* pkt)
+{
+    /* Re-decode only if PADDR (or decoder) has changed since last time */
+    if (pkt->coord.addr!=pkt->PADDR || pkt->coord.adec!=this)
+        decode_all(pkt->PADDR, pkt->coord);
+
+    return pkt->coord;
 }
 
 uint64_t AddressDecoder::encode_addr(std::vector<uint64_t>& partial_bits)
@@ -175,35 +200,17 @@ uint64_t AddressDecoder::encode_addr(std::vector<uint64_t>& partial_bits)
 
 uint64_t AddressDecoder::mask_host_offset(uint64_t addr)
 {
-    uint64_t mask = 0;
-    uint64_t ref_bit1 = 1;
-    for (uint64_t i=0; i<HOST_TX_OFFSET; i++)
-        mask = mask | (ref_bit1<<i);
-    mask = ~mask;
-
-    return (addr&mask); 
+    return (addr&host_mask); 
 }
 
 uint64_t AddressDecoder::mask_page_offset(uint64_t addr)
 {
-    uint64_t mask = 0;
-    uint64_t ref_bit1 = 1;
-    for (uint64_t i=0; i<PAGE_OFFSET; i++)
-        mask = mask | (ref_bit1<<i);
-    mask = ~mask;
-
-    return (addr&mask); 
+    return (addr&page_mask); 
 }
 
 uint64_t AddressDecoder::mask_block_offset(uint64_t addr)
 {
-    uint64_t mask = 0;
-    uint64_t ref_bit1 = 1;
-    for (uint64_t i=0; i<PAGE_OFFSET; i++)
-        mask = mask | (ref_bit1<<i);
-    mask = ~mask;
-
-    return (addr&mask); 
+    return (addr&page_mask); 
 }
 
 MemInfo::MemInfo(MemoryControlSystem* memsys, std::string cfg_header, AddressDecoder* adec)
@@ -38,6 +38,7 @@
 namespace PCMCsim
 {
     class MemoryControlSystem;
+    class Packet;
     
     class AddressDecoder
     {
@@ -52,7 +53,12 @@ namespace PCMCsim
 
         uint64_t get_order(addr_field_t field) { return orders[field]; }
         uint64_t get_width(addr_field_t field) { return widths[field]; }
-        uint64_t decode_addr(uint64_t addr, addr_field_t field);
+        uint64_t decode_addr(uint64_t addr, addr_field_t field)
+        {
+            return ((addr>>PAGE_OFFSET)>>shifts[field]) & masks[field];
+        }
+        void decode_all(uint64_t addr, addr_coord_t& coord);
+        const addr_coord_t& decode_pkt(Packet* pkt);
         uint64_t encode_addr(std::vector<uint64_t>& bits);
         uint64_t mask_host_offset(uint64_t addr);
         uint64_t mask_page_offset(uint64_t addr);
@@ -61,12 +67,20 @@ namespace PCMCsim
         void print( );
 
         addr_field_t get_field(uint64_t order);
-        void set_width(addr_field_t field, uint64_t width) { widths[field] = width; }
+        void set_width(addr_field_t field, uint64_t width);
 
       private:
         std::string mem_name;
         uint64_t widths[NUM_FIELDS];
         uint64_t orders[NUM_FIELDS];
+
+        /* Decode tables derived from orders/widths */
+        uint64_t shifts[NUM_FIELDS];
+        uint64_t masks[NUM_FIELDS];
+        uint64_t host_mask;
+        uint64_t page_mask;
+
+        void update_tables( );
     };
 
     class MemInfo
@@ -4,6 +4,8 @@
 #include "base/Packet.h"
 #include "base/MemInfo.h"
 #include "base/PCMInfo.h"
+#include "base/Stats.h"
+#include "base/ReqTracer.h"
 #include "Parsers/Parser.h"
 #include "RequestReceiver/RequestReceiver.h"
 #include "DataCache/DataCache.h"
@@ -14,6 +16,7 @@
 #include "uCMDEngine/HynixEngine.h"
 #include "uCMDEngine/JedecPolicyFactory.h"
 #include "uCMDEngine/JedecEngine.h"
+#include "uCMDEngine/PCMEngine.h"
 #include "DataPathUnit/DataPathUnit.h"
 #include "MemoryModules/DummyMemory/DummyAIT.h"
 #include "MemoryModules/DummyMemory/DummyHynixPMEM.h"
@@ -25,10 +28,11 @@
 using namespace PCMCsim;
 
 MemoryControlSystem::MemoryControlSystem(const std::string& cfgfile, 
-                                         GlobalEventQueue* geq, std::string _path_prefix)
+                                         GlobalEventQueue* geq, std::string _path_prefix,
+                                         const std::vector<std::string>& overrides)
 :info(NULL), adec(NULL), mdec(NULL), tdec(NULL), host_itf(NULL), parser(NULL),
 recvr(NULL), dcache(NULL), aitm(NULL), rmw(NULL), xbar(NULL), 
-ait_mem(NULL), ait_adec(NULL), ait_info(NULL), ait_dmc(NULL)
+ait_mem(NULL), ait_adec(NULL), ait_info(NULL), ait_dmc(NULL), tracer(NULL)
 {
     if (!geq)
     {
@@ -39,6 +43,27 @@ ait_mem(NULL), ait_adec(NULL), ait_info(NULL), ait_dmc(NULL)
     else
         this->geq = geq;
 
+    load_config(cfgfile);
+
+    /* Overlay per-run overrides (key=value pairs or config files) */
+    for (uint64_t i=0; i<overrides.size( ); i++)
+    {
+        std::string::size_type pos = overrides[i].find("=");
+        if (pos!=std::string::npos)
+            setParam(overrides[i].substr(0, pos), overrides[i].substr(pos+1));
+        else
+            load_config(overrides[i]);
+    }
+
+    if (_path_prefix!="")
+        path_prefix = _path_prefix + "/";
+
+    if (getParamUINT64("global.req_trace.sample", 0)>0)
+        tracer = new ReqTracer(this, "global.req_trace");
+}
+
+void MemoryControlSystem::load_config(const std::string& cfgfile)
+{
     bool print_cfg = false;
     std::ifstream fin(cfgfile.c_str( ));
     if (fin.good( )==false)
@@ -77,9 +102,11 @@ ait_mem(NULL), ait_adec(NULL), ait_info(NULL), ait_dmc(NULL)
             fin.close( );
         }
     }
+}
 
-    if (_path_prefix!="")
-        path_prefix = _path_prefix + "/";
+void MemoryControlSystem::setParam(const std::string& key, const std::string& value)
+{
+    params[key] = value;
 }
 
 MemoryControlSystem::~MemoryControlSystem( )
@@ -110,6 +137,7 @@ MemoryControlSystem::~MemoryControlSystem( )
     delete ait_adec;
     delete ait_info;
     delete ait_dmc;
+    delete tracer;
 }
 
 void MemoryControlSystem::recvRequest(Packet* pkt, ncycle_t delay)
@@ -158,12 +186,33 @@ void MemoryControlSystem::setup_pcmc(Component* host_itf)
     media.resize(info->get_channels( ));
     if (getParamBOOL("global.ucmde.is_jedec", false))
     {
+        /* Each channel has its own uCMDE, DPU, and media */
         std::string jheader = "ucmde.jedec";
-        ucmde[0] = JedecPolicyFactory::create_engine_policy(
-                this, adec, info, jheader, global_freq);
+        for (uint64_t ch=0; ch<info->get_channels( ); ch++)
+        {
+            ucmde[ch] = JedecPolicyFactory::create_engine_policy(
+                    this, adec, info, jheader, global_freq, ch);
 
-        dpu[0] = new DataPathUnit(this, "dpu", global_freq);
-        media[0] = new DummyJedecMEM(this, "media.jedec[0]", info);
+            dpu[ch] = new DataPathUnit(this, "dpu", global_freq, ch);
+            media[ch] = new DummyJedecMEM(this, 
+                "media.jedec["+std::to_string(ch)+"]", info);
+        }
+    }
+    else if (getParamBOOL("global.ucmde.is_pcm", false))
+    {
+        /* PCM-native timings without DRAM ACT/PRE and refresh */
+        std::string pheader = "ucmde.pcm";
+        for (uint64_t ch=0; ch<info->get_channels( ); ch++)
+        {
+            PCMEngine* pe = new PCMEngine(this, adec, info, pheader, global_freq, ch);
+            ucmde[ch] = pe;
+
+            dpu[ch] = new DataPathUnit(this, "dpu", global_freq, ch);
+            if (pe->is_write_cancellable( ))
+                dpu[ch]->enable_retain_wdata( );
+            media[ch] = new DummyJedecMEM(this, 
+                "media.pcm["+std::to_string(ch)+"]", info);
+        }
     }
     else
     {
@@ -281,18 +330,21 @@ void MemoryControlSystem::setup_pcmc(Component* host_itf)
     }
 
     rmw->dcache = dcache;
-    rmw->ucmde = ucmde[0];
-    rmw->dpu = dpu[0];
     rmw->aitm = aitm;
-    ucmde[0]->setParent(rmw);
-    ucmde[0]->dpu = dpu[0];
-    dpu[0]->rmw = rmw;
-    dpu[0]->ucmde = ucmde[0];
+    for (uint64_t ch=0; ch<info->get_channels( ); ch++)
+    {
+        rmw->ucmde[ch] = ucmde[ch];
+        rmw->dpu[ch] = dpu[ch];
+        ucmde[ch]->setParent(rmw);
+        ucmde[ch]->dpu = dpu[ch];
+        dpu[ch]->rmw = rmw;
+        dpu[ch]->ucmde = ucmde[ch];
 
-    ucmde[0]->media = media[0];
-    dpu[0]->media = media[0];
+        ucmde[ch]->media = media[ch];
+        dpu[ch]->media = media[ch];
 
-    media[0]->setParent(dpu[0]);
+        media[ch]->setParent(dpu[ch]);
+    }
 }
 
 void MemoryControlSystem::setup_dmc(Component* host_itf)
@@ -344,23 +396,25 @@ void MemoryControlSystem::setup_dmc(Component* host_itf)
 
 double MemoryControlSystem::getParamFLOAT(const std::string& key, double def) const
 {
-    if (params.find(key)==params.end( ))
+    std::map<std::string, std::string>::const_iterator p_it = find_param(key);
+    if (p_it==params.end( ))
         return def;
     
     double rval = 0.0;
-    std::istringstream sstr(params.find(key)->second);
+    std::istringstream sstr(p_it->second);
     sstr >> rval;
     return rval;
 }
 
 uint64_t MemoryControlSystem::getParamUINT64(const std::string& key, uint64_t def) const
 {
-    if (params.find(key)==params.end( ))
+    std::map<std::string, std::string>::const_iterator p_it = find_param(key);
+    if (p_it==params.end( ))
         return def;
     else
     {
         uint64_t rval = 0;
-        const std::string& value = params.find(key)->second;
+        const std::string& value = p_it->second;
         if (value.find("0x", 0)!=std::string::npos || value.find("0X", 0)!=std::string::npos)
         {
             /* Convert HEX to DEC */
@@ -390,7 +444,7 @@ uint64_t MemoryControlSystem::getParamUINT64(const std::string& key, uint64_t de
         }
         else
         {
-            std::istringstream sstr(params.find(key)->second);
+            std::istringstream sstr(value);
             sstr >> rval;
         }
         return rval;
@@ -410,10 +464,37 @@ bool MemoryControlSystem::getParamBOOL(const std::string& key, bool def) const
 
 std::string MemoryControlSystem::getParamSTR(const std::string& key, std::string def) const
 {
-    if (params.find(key)==params.end( ))
+    std::map<std::string, std::string>::const_iterator p_it = find_param(key);
+    if (p_it==params.end( ))
         return def;
     else
-        return params.find(key)->second;
+        return p_it->second;
+}
+
+std::map<std::string, std::string>::const_iterator 
+MemoryControlSystem::find_param(const std::string& key) const
+{
+    std::map<std::string, std::string>::const_iterator p_it = params.find(key);
+    if (p_it!=params.end( ))
+        return p_it;
+
+    /* 
+     * Keys of a per-channel module (e.g., ucmde.jedec[1].policy) fall 
+     * back to channel 0, so a config only lists what differs per channel.
+     * Indexed params in the last level (e.g., port_weight[1]) do not
+     */
+    size_t name_end = key.rfind('.');
+    size_t idx_st = key.rfind('[', name_end);
+    if (name_end==std::string::npos || idx_st==std::string::npos)
+        return params.end( );
+
+    size_t idx_ed = key.find(']', idx_st);
+    if (idx_ed==std::string::npos || idx_ed>name_end || idx_ed==idx_st+1 ||
+        key.substr(idx_st+1, idx_ed-idx_st-1)=="0" ||
+        key.find_first_not_of("0123456789", idx_st+1)!=idx_ed)
+        return params.end( );
+
+    return params.find(key.substr(0, idx_st+1)+"0"+key.substr(idx_ed));
 }
 
 void MemoryControlSystem::getParamSRAM(const uint64_t num_sets, 
@@ -568,49 +649,164 @@ void MemoryControlSystem::setMemData(uint64_t PA, DataBlock& data, DataBlock& me
     }
 }
 
+void MemoryControlSystem::calculate_stats( )
+{
+    if (recvr)
+        recvr->calculate_stats( );
+    if (dcache)
+        dcache->calculate_stats( );
+    if (aitm)
+        aitm->calculate_stats( );
+    if (ait_dmc)
+        ait_dmc->calculate_stats( );
+    if (rmw)
+        rmw->calculate_stats( );
+    for (uint64_t ch=0; ch<info->get_channels( ); ch++)
+    {
+        if (dpu.size( )>0 && dpu[ch])
+            dpu[ch]->calculate_stats( );
+
+        if (ucmde[ch])
+            ucmde[ch]->calculate_stats( );
+    }
+}
+
+void MemoryControlSystem::sync_stats( )
+{
+    /* Only DRAM state machines account residency lazily for now */
+    if (ait_dmc)
+        ait_dmc->sync_stats( );
+    for (uint64_t ch=0; ch<info->get_channels( ); ch++)
+    {
+        if (ucmde[ch])
+            ucmde[ch]->sync_stats( );
+    }
+}
+
+void MemoryControlSystem::collect_stats(std::vector<Stats*>& slist)
+{
+    /* Gather stats in the same order of print_stats */
+    if (recvr)
+        recvr->collect_stats(slist);
+    if (dcache)
+        dcache->collect_stats(slist);
+    if (aitm)
+        aitm->collect_stats(slist);
+    if (ait_dmc)
+        ait_dmc->collect_stats(slist);
+    if (rmw)
+        rmw->collect_stats(slist);
+    for (uint64_t ch=0; ch<info->get_channels( ); ch++)
+    {
+        if (dpu.size( )>0 && dpu[ch])
+            dpu[ch]->collect_stats(slist);
+
+        if (ucmde[ch])
+            ucmde[ch]->collect_stats(slist);
+    }
+}
+
 void MemoryControlSystem::print_stats(std::ostream& os)
 {
+    std::string format = getParamSTR("global.stats_format", "text");
+    if (format=="json")
+    {
+        print_stats_json(os);
+        return;
+    }
+    else if (format=="csv")
+    {
+        print_stats_csv(os);
+        return;
+    }
+    else if (format!="text")
+    {
+        std::cerr << "[MemoryControlSystem] Error! Invalid stats format - "
+            << format << std::endl;
+        assert(0);
+        exit(1);
+    }
+
     os << "==========PCMCsim stats==========" << std::endl;
     os << "LastTick " << geq->getCurrentTick( ) <<std::endl;
 
+    calculate_stats( );
     if (recvr)
-    {
-        recvr->calculate_stats( );
         recvr->print_stats(os);
-    }
     if (dcache)
-    {
-        dcache->calculate_stats( );
         dcache->print_stats(os);
-    }
     if (aitm)
-    {
-        aitm->calculate_stats( );
         aitm->print_stats(os);
-    }
     if (ait_dmc)
-    {
-        ait_dmc->calculate_stats( );
         ait_dmc->print_stats(os);
-    }
     if (rmw)
-    {
-        rmw->calculate_stats( );
         rmw->print_stats(os);
-    }
     for (uint64_t ch=0; ch<info->get_channels( ); ch++)
     {
         if (dpu.size( )>0 && dpu[ch])
-        {
-            dpu[ch]->calculate_stats( );
             dpu[ch]->print_stats(os);
-        }
 
         if (ucmde[ch])
-        {
-            ucmde[ch]->calculate_stats( );
             ucmde[ch]->print_stats(os);
-        }
     }
+
+    if (tracer)
+        tracer->print_breakdown(os);
+}
+
+void MemoryControlSystem::print_stats_json(std::ostream& os)
+{
+    calculate_stats( );
+
+    std::vector<Stats*> slist;
+    collect_stats(slist);
+
+    StatsNode root("");
+    for (uint64_t i=0; i<slist.size( ); i++)
+        slist[i]->insert_tree(&root);
+
+    os << "{\n  \"LastTick\": " << geq->getCurrentTick( ) << ",\n";
+    os << "  \"stats\": ";
+    root.print_json(os, 1);
+    os << "\n}" << std::endl;
+}
+
+void MemoryControlSystem::print_stats_csv(std::ostream& os)
+{
+    calculate_stats( );
+
+    std::vector<Stats*> slist;
+    collect_stats(slist);
+
+    os << "name,unit,value\n";
+    os << "LastTick,ticks," << geq->getCurrentTick( ) << "\n";
+    for (uint64_t i=0; i<slist.size( ); i++)
+        slist[i]->print_csv(os);
+    os.flush( );
+}
+
+void MemoryControlSystem::init_epoch_stats(std::ostream& os)
+{
+    epoch_stats.clear( );
+    collect_stats(epoch_stats);
+    sync_stats( );
+
+    /* Levels in ticks (latencies) are scaled into cycles by their handles */
+    os << "Tick";
+    for (uint64_t i=0; i<epoch_stats.size( ); i++)
+    {
+        epoch_stats[i]->init_snapshot( );
+        epoch_stats[i]->print_csv_header(os);
+    }
+    os << std::endl;
+}
+
+void MemoryControlSystem::print_epoch_stats(std::ostream& os, bool delta)
+{
+    os << geq->getCurrentTick( );
+    sync_stats( );
+    for (uint64_t i=0; i<epoch_stats.size( ); i++)
+        epoch_stats[i]->print_csv_delta(os, delta);
+    os << "\n";
 }
 
@@ -56,6 +56,8 @@ namespace PCMCsim
     class MetaDecoder;
     class AITDecoder;
     class XBar;
+    class Stats;
+    class ReqTracer;
 
     typedef std::pair<DataBlock*, DataBlock*> MemoryPair; //<data, meta>
 
@@ -63,7 +65,8 @@ namespace PCMCsim
     {
       public:
         MemoryControlSystem(const std::string & cfgfile, 
-                            GlobalEventQueue* geq, std::string _path_prefix="");
+                            GlobalEventQueue* geq, std::string _path_prefix="",
+                            const std::vector<std::string>& overrides=std::vector<std::string>( ));
         ~MemoryControlSystem( );
 
         void recvRequest(Packet* pkt, ncycle_t delay=1);
@@ -78,6 +81,7 @@ namespace PCMCsim
         uint64_t getParamUINT64(const std::string& key, uint64_t def) const;
         bool getParamBOOL(const std::string& key, bool def) const; 
         std::string getParamSTR(const std::string& key, std::string def="") const;
+        void setParam(const std::string& key, const std::string& value);
         void getParamSRAM(const uint64_t num_sets, const uint64_t num_ways, 
                           double* Esr, double* Erd, double* Ewr);
 
@@ -116,14 +120,29 @@ namespace PCMCsim
 
         uint64_t op_rate;   // overprovision ratio in WLV
 
+        /* Sampled request lifecycle tracer (NULL if disabled) */
+        ReqTracer* tracer;
+
         /* Stats */ 
         void print_stats(std::ostream& os);
+        void print_stats_json(std::ostream& os);
+        void print_stats_csv(std::ostream& os);
+        void init_epoch_stats(std::ostream& os);
+        void print_epoch_stats(std::ostream& os, bool delta=true);
 
       private:
         /* Simulation-related variables */
         GlobalEventQueue* geq;
         std::map<std::string, std::string> params;
         std::string path_prefix;
+        std::vector<Stats*> epoch_stats;
+
+        void load_config(const std::string& cfgfile);
+        std::map<std::string, std::string>::const_iterator 
+            find_param(const std::string& key) const;
+        void calculate_stats( );
+        void sync_stats( );
+        void collect_stats(std::vector<Stats*>& slist);
 
         /* TODO : large size expansion -> file management */
         std::map<uint64_t, MemoryPair> memoryData;
@@ -48,6 +48,7 @@
 #include <deque>
 #include <map>
 #include <set>
+#include <unordered_map>
 
 #define PCMC_DBG(FLAG, msg, ...) \
     do { if (FLAG) std::fprintf(stdout, msg, ##__VA_ARGS__); } while (0)
@@ -118,6 +119,15 @@ typedef enum _addr_field_t
     NUM_FIELDS
 } addr_field_t;
 
+/* Decoded address fields cached in a packet (see AddressDecoder::decode_pkt) */
+class AddressDecoder;
+typedef struct _addr_coord_t
+{
+    uint64_t addr;              // address that fields are decoded from
+    AddressDecoder* adec;       // decoder that filled this coordinate
+    uint64_t fld[NUM_FIELDS];
+} addr_coord_t;
+
 typedef enum _pcm_meta_field_t
 {
     META_PWCNT=0,   // page write count
@@ -14,6 +14,8 @@ Packet::Packet( )
     PADDR = INVALID_ADDR; 
     LADDR_MAP = INVALID_ADDR;
     PADDR_MAP = INVALID_ADDR; 
+    coord.addr = INVALID_ADDR;
+    coord.adec = NULL;
 
     buffer_idx = -1;
 
@@ -40,6 +42,8 @@ Packet::Packet( )
     need_redirect = false;
     merge_end_tick = 0;
     wdcache_latency = 0;
+
+    trace_id = -1;
 }
 
 Packet::Packet(uint64_t num_data)
@@ -54,6 +58,8 @@ Packet::Packet(uint64_t num_data)
     PADDR = INVALID_ADDR; 
     LADDR_MAP = INVALID_ADDR;
     PADDR_MAP = INVALID_ADDR; 
+    coord.addr = INVALID_ADDR;
+    coord.adec = NULL;
 
     buffer_idx = -1;
 
@@ -81,6 +87,8 @@ Packet::Packet(uint64_t num_data)
     need_redirect = false;
     merge_end_tick = 0;
     wdcache_latency = 0;
+
+    trace_id = -1;
 }
 
 Packet::~Packet( )
@@ -106,6 +114,7 @@ Packet& Packet::operator=(Packet& rhs)
     PADDR = rhs.PADDR;
     LADDR_MAP = rhs.LADDR_MAP;
     PADDR_MAP = rhs.PADDR_MAP;
+    coord = rhs.coord;
 
     buffer_idx = rhs.buffer_idx;
     buffer_data = rhs.buffer_data;
@@ -137,6 +146,8 @@ Packet& Packet::operator=(Packet& rhs)
     merge_end_tick = rhs.merge_end_tick;
     wdcache_latency = rhs.wdcache_latency;
 
+    trace_id = rhs.trace_id;
+
     return (*this);
 }
 
@@ -62,6 +62,7 @@ namespace PCMCsim
         uint64_t PADDR;     // Physical address of LADDR
         uint64_t LADDR_MAP; // Logical address of newly mapped physical address. BLKMV/SWP has this
         uint64_t PADDR_MAP; // Physical address that is newly mapped to. BLKMV/SWP has this
+        addr_coord_t coord; // cached decode of PADDR (validated by addr/adec)
 
         /* Data path signals */
         int64_t buffer_idx;
@@ -96,6 +97,9 @@ namespace PCMCsim
         bool need_redirect;         // redirect data dpu->dcache directly
         ncycle_t merge_end_tick;    // need to merge data 
         ncycle_t wdcache_latency;
+
+        /* Signals used in ReqTracer */
+        int64_t trace_id;           // index of trace record (-1: not sampled)
     };
 };
 
@@ -0,0 +1,275 @@
+#include "base/MemoryControlSystem.h"
+#include "base/Packet.h"
+#include "base/EventQueue.h"
+#include "base/Stats.h"
+#include "base/Prefetcher.h"
+
+using namespace PCMCsim;
+
+Prefetcher::Prefetcher(MemoryControlSystem* memsys_, std::string cfg_header,
+                       uint64_t def_size_pb, uint64_t def_stream_window)
+:Component(memsys_), num_lines(std::numeric_limits<uint64_t>::max( )), pb_ptr(0),
+stream_clk(0), int_lookups(0), int_issued(0), int_useful(0)
+{
+    cp_name = cfg_header;
+
+    /* Parameter load */
+    dbg_msg = memsys->getParamBOOL(cp_name+".dbg_msg", false);
+    ticks_per_cycle= memsys->getParamUINT64("global.ticks_per_cycle", 1);
+    size_pb = memsys->getParamUINT64(cp_name+".size_pb", def_size_pb);
+    size_pfq = memsys->getParamUINT64(cp_name+".size_pfq", 8);
+    size_stream = memsys->getParamUINT64(cp_name+".size_stream", 4);
+    stream_window = memsys->getParamUINT64(cp_name+".stream_window", def_stream_window);
+    max_degree = memsys->getParamUINT64(cp_name+".degree", 4);
+    interval = memsys->getParamUINT64(cp_name+".interval", 256);
+    acc_high = memsys->getParamFLOAT(cp_name+".acc_high", 0.75);
+    acc_low = memsys->getParamFLOAT(cp_name+".acc_low", 0.40);
+
+    if (size_pb==0 || size_pfq==0 || size_stream==0 ||
+        max_degree==0 || interval==0 || acc_low>acc_high)
+    {
+        std::cerr << "[" << cp_name << "] Error! Invalid prefetcher configuration"
+            << std::endl;
+        assert(0);
+        exit(1);
+    }
+
+    /* Data structure init */
+    degree = max_degree;
+    pbe_t pb_init{false, false, false, false, 0, 0, DataBlock( ), std::vector<Packet*>( )};
+    pb.resize(size_pb, pb_init);
+    stream_t s_init{false, 0, 0, 0, 0, 0};
+    streams.resize(size_stream, s_init);
+
+    /* Stats registration */
+    register_stats( );
+}
+
+Prefetcher::~Prefetcher( )
+{
+}
+
+void Prefetcher::handle_events(ncycle_t curr_tick)
+{
+    prepare_events(curr_tick);
+
+    if (!await_cb.empty( ))
+        handle_await_callbacks( );
+}
+
+bool Prefetcher::has_candidate( )
+{
+    return (pfq.empty( )==false && get_pb_victim( )>=0);
+}
+
+int64_t Prefetcher::find_pb(uint64_t line)
+{
+    int64_t rv = -1;
+    for (uint64_t i=0; i<size_pb; i++)
+    {
+        if (pb[i].valid && pb[i].stale==false && pb[i].line==line)
+        {
+            rv = (int64_t)i;
+            break;
+        }
+    }
+
+    return rv;
+}
+
+int64_t Prefetcher::get_pb_victim( )
+{
+    /* FIFO from pb_ptr, skipping lines still in flight */
+    int64_t rv = -1;
+    for (uint64_t i=0; i<size_pb; i++)
+    {
+        uint64_t idx = (pb_ptr+i) % size_pb;
+        if (pb[idx].valid==false || pb[idx].inflight==false)
+        {
+            rv = (int64_t)idx;
+            break;
+        }
+    }
+
+    return rv;
+}
+
+int64_t Prefetcher::alloc_pb(uint64_t& line)
+{
+    assert(has_candidate( ));
+    line = pfq.front( );
+    pfq.pop_front( );
+
+    /* Allocate PB entry for the line */
+    int64_t idx = get_pb_victim( );
+    if (pb[idx].valid && pb[idx].useful==false)
+        num_pf_unused += 1;
+
+    pb[idx].valid = true;
+    pb[idx].inflight = true;
+    pb[idx].stale = false;
+    pb[idx].useful = false;
+    pb[idx].line = line;
+    pb_ptr = (idx+1) % size_pb;
+
+    num_pf_issued += 1;
+    int_issued += 1;
+
+    return idx;
+}
+
+void Prefetcher::count_lookup(int64_t idx)
+{
+    if (idx>=0 && pb[idx].useful==false)
+    {
+        pb[idx].useful = true;
+        num_pf_useful += 1;
+        int_useful += 1;
+    }
+
+    num_lookup += 1;
+    int_lookups += 1;
+    if (int_lookups==interval)
+        throttle( );
+}
+
+Prefetcher::stream_t* Prefetcher::train_stream(uint64_t addr)
+{
+    /* Find the stream around the address, or replace the LRU one */
+    int64_t sidx = -1;
+    int64_t lru_idx = 0;
+    for (uint64_t i=0; i<size_stream; i++)
+    {
+        uint64_t dist = (streams[i].last_addr>addr)?
+                        streams[i].last_addr-addr : addr-streams[i].last_addr;
+        if (streams[i].valid && dist<=stream_window)
+        {
+            sidx = (int64_t)i;
+            break;
+        }
+
+        if (streams[i].valid==false ||
+            (streams[lru_idx].valid && streams[i].lru<streams[lru_idx].lru))
+        {
+            lru_idx = (int64_t)i;
+        }
+    }
+
+    stream_clk += 1;
+    if (sidx<0)
+    {
+        /* A lone access does not trigger prefetch until it is followed */
+        stream_t new_stream{true, addr, 0, 0, addr, stream_clk};
+        streams[lru_idx] = new_stream;
+        return NULL;
+    }
+
+    /* Confirm the stride */
+    stream_t& s = streams[sidx];
+    int64_t stride = (int64_t)(addr-s.last_addr);
+    s.lru = stream_clk;
+    if (stride==0)
+        return NULL;
+
+    if (stride==s.stride)
+        s.conf = std::min(s.conf+1, (uint64_t)3);
+    else if (s.conf>0)
+        s.conf -= 1;
+    else
+        s.stride = stride;
+    s.last_addr = addr;
+
+    return &s;
+}
+
+void Prefetcher::push_candidate(uint64_t line)
+{
+    if (line>=num_lines || find_pb(line)>=0 ||
+        std::find(pfq.begin( ), pfq.end( ), line)!=pfq.end( ))
+        return;
+
+    /* Newer candidates are more timely */
+    if (pfq.size( )>=size_pfq)
+    {
+        pfq.pop_front( );
+        num_pf_dropped += 1;
+    }
+    pfq.push_back(line);
+}
+
+void Prefetcher::throttle( )
+{
+    /* Adjust degree by the accuracy of the interval */
+    if (int_issued==0)
+    {
+        if (degree==0)
+        {
+            degree = 1;
+            num_degree_up += 1;
+        }
+    }
+    else
+    {
+        double acc = (double)int_useful / int_issued;
+        if (acc>=acc_high && degree<max_degree)
+        {
+            degree += 1;
+            num_degree_up += 1;
+        }
+        else if (acc<acc_low && degree>0)
+        {
+            degree -= 1;
+            num_degree_down += 1;
+
+            /* Throttled off: drop candidates not issued yet */
+            if (degree==0)
+                pfq.clear( );
+        }
+    }
+
+    PCMC_DBG(dbg_msg, "[%s] Interval end: issued=%lu, useful=%lu, degree=%lu\n",
+        cp_name.c_str( ), int_issued, int_useful, degree);
+
+    int_lookups = 0;
+    int_issued = 0;
+    int_useful = 0;
+}
+
+/*========== Below is stats setting ==========*/
+void Prefetcher::register_stats( )
+{
+    uint64_t u64_zero = 0;
+    double df_init = 0.0;
+
+    RESET_STATS(num_lookup, u64_zero);
+    RESET_STATS(num_pb_hit, u64_zero);
+    RESET_STATS(num_pb_wait, u64_zero);
+    RESET_STATS(num_pf_issued, u64_zero);
+    RESET_STATS(num_pf_useful, u64_zero);
+    RESET_STATS(num_pf_unused, u64_zero);
+    RESET_STATS(num_pf_dropped, u64_zero);
+    RESET_STATS(num_pf_stale, u64_zero);
+    RESET_STATS(num_degree_up, u64_zero);
+    RESET_STATS(num_degree_down, u64_zero);
+    RESET_STATS(accuracy, df_init);
+    RESET_STATS(coverage, df_init);
+
+    ADD_STATS(cp_name, num_lookup);
+    ADD_STATS(cp_name, num_pb_hit);
+    ADD_STATS(cp_name, num_pb_wait);
+    ADD_STATS(cp_name, num_pf_issued);
+    ADD_STATS(cp_name, num_pf_useful);
+    ADD_STATS(cp_name, num_pf_unused);
+    ADD_STATS(cp_name, num_pf_dropped);
+    ADD_STATS(cp_name, num_pf_stale);
+    ADD_STATS(cp_name, num_degree_up);
+    ADD_STATS(cp_name, num_degree_down);
+    ADD_STATS_LEVEL(cp_name, accuracy);
+    ADD_STATS_LEVEL(cp_name, coverage);
+}
+
+void Prefetcher::calculate_stats( )
+{
+    accuracy = (num_pf_issued==0)? 0.0 : (double)num_pf_useful/num_pf_issued;
+    coverage = (num_lookup==0)? 0.0 : (double)(num_pb_hit+num_pb_wait)/num_lookup;
+}
@@ -0,0 +1,151 @@
+/*
+ * Copyright (c) 2019 Computer Architecture and Paralllel Processing Lab, 
+ * Seoul National University, Republic of Korea. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     1. Redistribution of source code must retain the above copyright 
+ *        notice, this list of conditions and the follwoing disclaimer.
+ *     2. Redistributions in binary form must reproduce the above copyright 
+ *        notice, this list conditions and the following disclaimer in the 
+ *        documentation and/or other materials provided with the distirubtion.
+ *     3. Neither the name of the copyright holders nor the name of its 
+ *        contributors may be used to endorse or promote products derived from 
+ *        this software without specific prior written permission. 
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *
+ * Description: This is a base class of the prefetchers with a prefetch
+ * buffer (PB). It holds what AITPrefetcher and DataPrefetcher share:
+ * > PB: FIFO buffer of prefetched lines, a line still in flight keeps
+ *   the lookups waiting for it
+ * > stream table: streams are tracked by address proximity and a stride
+ *   is confirmed by a saturating counter
+ * > throttling: degree is adjusted every interval of lookups by the
+ *   accuracy (useful/issued) of the interval
+ * A line is the unit of prefetch (AIT$ line or page). Derived classes
+ * define the geometry, the candidates of a stream and the issue path
+ */
+
+#ifndef __PCMCSIM_PREFETCHER_H_
+#define __PCMCSIM_PREFETCHER_H_
+
+#include "base/PCMCTypes.h"
+#include "base/Component.h"
+
+namespace PCMCsim
+{
+    class MemoryControlSystem;
+    class Packet;
+
+    class Prefetcher : public Component
+    {
+      public:
+        Prefetcher( ) = delete;
+        Prefetcher(MemoryControlSystem* memsys_, std::string cfg_header,
+                   uint64_t def_size_pb, uint64_t def_stream_window);
+        ~Prefetcher( );
+
+        enum _pb_lookup
+        {
+            PB_MISS = 0,
+            PB_HIT,         // data is copied to the lookup
+            PB_WAIT,        // lookup is parked until prefetch returns
+
+            NUM_PB_LOOKUP
+        };
+
+        void handle_events(ncycle_t curr_tick) override;
+
+        bool has_candidate( );
+
+        void calculate_stats( ) override;
+
+      protected:
+        typedef struct _pbe_t
+        {
+            bool valid;
+            bool inflight;
+            bool stale;     // invalidated in flight, freed when it returns
+            bool useful;
+            uint64_t line;
+            uint64_t pf_id;
+            DataBlock data;
+            std::vector<Packet*> waiters;
+        } pbe_t;
+
+        typedef struct _stream_t
+        {
+            bool valid;
+            uint64_t last_addr;
+            int64_t stride;
+            uint64_t conf;
+            uint64_t pf_addr;       // last address queued along the stride
+            uint64_t lru;
+        } stream_t;
+
+        uint64_t num_lines;         // lines in range of prefetch
+
+        /* Prefetch buffer */
+        uint64_t size_pb;
+        uint64_t pb_ptr;            // FIFO replacement pointer
+        std::vector<pbe_t> pb;
+
+        int64_t find_pb(uint64_t line);
+        int64_t get_pb_victim( );
+        int64_t alloc_pb(uint64_t& line);
+        void count_lookup(int64_t idx);
+
+        /* Candidate generation */
+        uint64_t size_pfq;
+        uint64_t size_stream;
+        uint64_t stream_window;     // address distance to match a stream
+        uint64_t stream_clk;
+        std::deque<uint64_t> pfq;   // candidate lines
+        std::vector<stream_t> streams;
+
+        stream_t* train_stream(uint64_t addr);
+        void push_candidate(uint64_t line);
+
+        /* Throttling */
+        uint64_t degree;
+        uint64_t max_degree;
+        uint64_t interval;
+        double acc_high;
+        double acc_low;
+        uint64_t int_lookups;
+        uint64_t int_issued;
+        uint64_t int_useful;
+
+        void throttle( );
+
+        /* Stats */
+        uint64_t num_lookup;
+        uint64_t num_pb_hit;
+        uint64_t num_pb_wait;
+        uint64_t num_pf_issued;
+        uint64_t num_pf_useful;
+        uint64_t num_pf_unused;
+        uint64_t num_pf_dropped;
+        uint64_t num_pf_stale;
+        uint64_t num_degree_up;
+        uint64_t num_degree_down;
+        double accuracy;
+        double coverage;
+
+        void register_stats( ) override;
+    };
+};
+
+#endif
@@ -0,0 +1,216 @@
+#include "base/ReqTracer.h"
+#include "base/MemoryControlSystem.h"
+#include "base/Packet.h"
+#include <iomanip>
+
+using namespace PCMCsim;
+
+const char* ReqTracer::stage_name[NUM_TRC_STAGES] = 
+{
+    "Parser", "RequestReceiver", "DataCache", "AITManager",
+    "ReadModifyWrite", "JedecEngine", "DataPathUnit", "Media"
+};
+
+ReqTracer::ReqTracer(MemoryControlSystem* memsys_, std::string cfg_header)
+: cp_name(cfg_header), num_seen(0)
+{
+    sample_rate = memsys_->getParamUINT64(cp_name+".sample", 0);
+    max_reqs = memsys_->getParamUINT64(cp_name+".max_reqs", 10000);
+    trace_path = memsys_->getParamSTR(cp_name+".path", "req_trace.json");
+    ticks_per_cycle = memsys_->getParamUINT64("global.ticks_per_cycle", 1);
+    assert(sample_rate>0);
+
+    records.reserve(max_reqs);
+}
+
+ReqTracer::~ReqTracer( )
+{
+}
+
+void ReqTracer::sample(Packet* pkt, ncycle_t tick)
+{
+    assert(pkt->src_id==SRC_HOST);
+    pkt->trace_id = -1;
+    
+    num_seen += 1;
+    if ((num_seen-1)%sample_rate!=0 || records.size( )>=max_reqs)
+        return;
+
+    trc_record_t new_rec;
+    new_rec.req_id = pkt->req_id;
+    new_rec.tid = pkt->tid;
+    new_rec.cmd = pkt->cmd;
+    new_rec.LADDR = pkt->LADDR;
+    new_rec.start = tick;
+    new_rec.end = tick;
+    new_rec.done = false;
+    new_rec.events.reserve(4*NUM_TRC_STAGES);
+
+    pkt->trace_id = records.size( );
+    records.push_back(new_rec);
+    touch(pkt, TRC_PARSER, tick);
+}
+
+void ReqTracer::touch(Packet* pkt, trc_stage_t stage, ncycle_t tick)
+{
+    /* Packets copied from the traced request inherit trace_id */
+    if (pkt->trace_id<0)
+        return;
+
+    assert((uint64_t)pkt->trace_id<records.size( ));
+    trc_record_t& rec = records[pkt->trace_id];
+    if (rec.done)
+        return;
+
+    rec.events.push_back(trc_event_t(tick, stage));
+}
+
+void ReqTracer::finish(Packet* pkt, ncycle_t tick)
+{
+    if (pkt->trace_id<0)
+        return;
+
+    trc_record_t& rec = records[pkt->trace_id];
+    if (rec.done)
+        return;
+
+    rec.end = tick;
+    rec.done = true;
+    std::stable_sort(rec.events.begin( ), rec.events.end( ),
+        [](const trc_event_t& a, const trc_event_t& b) { return a.first<b.first; });
+}
+
+void ReqTracer::get_breakdown(trc_record_t& rec, std::vector<ncycle_t>& stage_ticks)
+{
+    stage_ticks.assign(NUM_TRC_STAGES, 0);
+    for (uint64_t i=0; i<rec.events.size( ); i++)
+    {
+        ncycle_t st = std::max(rec.events[i].first, rec.start);
+        ncycle_t ed = (i+1<rec.events.size( ))? rec.events[i+1].first : rec.end;
+        ed = std::min(ed, rec.end);
+        if (ed>st)
+            stage_ticks[rec.events[i].second] += ed-st;
+    }
+}
+
+void ReqTracer::print_chrome_trace( )
+{
+    std::ofstream os(trace_path.c_str( ), std::ofstream::out);
+    if (os.is_open( )==false)
+    {
+        std::cerr << "[ReqTracer] Error! Unable to open request trace file!" << std::endl;
+        assert(0);
+        exit(1);
+    }
+
+    /* 1 tick is 1ps while 'ts' and 'dur' are in us */
+    os << std::fixed << std::setprecision(6);
+    os << "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [\n";
+    bool first = true;
+    for (uint64_t r=0; r<records.size( ); r++)
+    {
+        trc_record_t& rec = records[r];
+        if (rec.done==false)
+            continue;
+
+        os << ((first)? "" : ",\n");
+        os << "{\"name\": \"" << ((rec.cmd==CMD_READ)? "RD":"WR") 
+            << "\", \"cat\": \"request\", \"ph\": \"X\", \"pid\": 0, \"tid\": " << r 
+            << ", \"ts\": " << rec.start/1e6 << ", \"dur\": " << (rec.end-rec.start)/1e6
+            << ", \"args\": {\"req_id\": " << rec.req_id << ", \"tid\": " << rec.tid
+            << ", \"LADDR\": \"0x" << std::hex << rec.LADDR << std::dec << "\"}}";
+        first = false;
+
+        for (uint64_t i=0; i<rec.events.size( ); i++)
+        {
+            ncycle_t st = std::max(rec.events[i].first, rec.start);
+            ncycle_t ed = (i+1<rec.events.size( ))? rec.events[i+1].first : rec.end;
+            ed = std::min(ed, rec.end);
+            if (ed<=st)
+                continue;
+
+            os << ",\n{\"name\": \"" << stage_name[rec.events[i].second]
+                << "\", \"cat\": \"stage\", \"ph\": \"X\", \"pid\": 0, \"tid\": " << r
+                << ", \"ts\": " << st/1e6 << ", \"dur\": " << (ed-st)/1e6 << "}";
+        }
+    }
+    os << "\n]}" << std::endl;
+    os.close( );
+}
+
+void ReqTracer::print_breakdown(std::ostream& os)
+{
+    print_breakdown_cmd(os, CMD_READ);
+    print_breakdown_cmd(os, CMD_WRITE);
+}
+
+void ReqTracer::print_breakdown_cmd(std::ostream& os, cmd_t cmd)
+{
+    /* Gather per-stage latency of completed requests */
+    std::vector<std::vector<ncycle_t>> lat(NUM_TRC_STAGES);
+    std::vector<ncycle_t> total;
+    std::vector<ncycle_t> stage_ticks;
+    for (uint64_t r=0; r<records.size( ); r++)
+    {
+        if (records[r].done==false || records[r].cmd!=cmd)
+            continue;
+
+        get_breakdown(records[r], stage_ticks);
+        for (uint64_t s=0; s<NUM_TRC_STAGES; s++)
+            lat[s].push_back(stage_ticks[s]);
+        total.push_back(records[r].end-records[r].start);
+    }
+
+    uint64_t num_reqs = total.size( );
+    os << "==========Latency breakdown of " << ((cmd==CMD_READ)? "RD":"WR")
+        << " (sampled 1/" << sample_rate << ", " << num_reqs << " reqs)==========" 
+        << std::endl;
+    if (num_reqs==0)
+        return;
+
+    /* Tail requests: total latency is not less than p99 */
+    std::vector<ncycle_t> sorted_total(total);
+    std::sort(sorted_total.begin( ), sorted_total.end( ));
+    ncycle_t p99_total = sorted_total[(num_reqs-1)*99/100];
+
+    double sum_total = 0.0;
+    for (uint64_t i=0; i<num_reqs; i++)
+        sum_total += total[i];
+
+    os << std::left << std::setw(18) << "stage[cycles]" << std::right
+        << std::setw(12) << "avg" << std::setw(12) << "p50" 
+        << std::setw(12) << "p99" << std::setw(12) << "max"
+        << std::setw(12) << "tail-avg" << std::setw(10) << "share[%]" << std::endl;
+    os << std::fixed << std::setprecision(1);
+    for (uint64_t s=0; s<=NUM_TRC_STAGES; s++)
+    {
+        std::vector<ncycle_t>& vals = (s<NUM_TRC_STAGES)? lat[s] : total;
+        double sum = 0.0;
+        double sum_tail = 0.0;
+        uint64_t num_tail = 0;
+        for (uint64_t i=0; i<num_reqs; i++)
+        {
+            sum += vals[i];
+            if (total[i]>=p99_total)
+            {
+                sum_tail += vals[i];
+                num_tail += 1;
+            }
+        }
+
+        std::vector<ncycle_t> sorted(vals);
+        std::sort(sorted.begin( ), sorted.end( ));
+
+        double tpc = (double)ticks_per_cycle;
+        os << std::left << std::setw(18) 
+            << ((s<NUM_TRC_STAGES)? stage_name[s] : "Total") << std::right
+            << std::setw(12) << sum/num_reqs/tpc
+            << std::setw(12) << sorted[(num_reqs-1)/2]/tpc
+            << std::setw(12) << sorted[(num_reqs-1)*99/100]/tpc
+            << std::setw(12) << sorted[num_reqs-1]/tpc
+            << std::setw(12) << sum_tail/num_tail/tpc
+            << std::setw(10) << ((sum_total>0)? 100.0*sum/sum_total : 0.0) << std::endl;
+    }
+    os.unsetf(std::ios_base::floatfield);
+    os << std::setprecision(6);
+}
@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2019 Computer Architecture and Paralllel Processing Lab, 
+ * Seoul National University, Republic of Korea. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     1. Redistribution of source code must retain the above copyright 
+ *        notice, this list of conditions and the follwoing disclaimer.
+ *     2. Redistributions in binary form must reproduce the above copyright 
+ *        notice, this list conditions and the following disclaimer in the 
+ *        documentation and/or other materials provided with the distirubtion.
+ *     3. Neither the name of the copyright holders nor the name of its 
+ *        contributors may be used to endorse or promote products derived from 
+ *        this software without specific prior written permission. 
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Authors: Hyokeun Lee (hklee@capp.snu.ac.kr)
+ *
+ * Description: Sampled request lifecycle tracer. One of every N host 
+ * requests is tagged at the parser and each module records the tick 
+ * when the request (or a packet copied from it) arrives. The time 
+ * between two consecutive arrivals is charged to the earlier stage.
+ * Results are exported as Chrome/Perfetto trace-event JSON and 
+ * summarized as a per-stage latency breakdown table.
+ */
+
+#ifndef __PCMCSIM_REQ_TRACER_H_
+#define __PCMCSIM_REQ_TRACER_H_
+
+#include "base/PCMCTypes.h"
+
+#define PCMC_TRACE(PKT, STAGE, TICK) \
+    do { if (memsys->tracer && (PKT)->trace_id>=0) \
+        memsys->tracer->touch((PKT), (STAGE), (TICK)); } while (0)
+
+namespace PCMCsim
+{
+    class MemoryControlSystem;
+    class Packet;
+
+    typedef enum _trc_stage_t
+    {
+        TRC_PARSER = 0,
+        TRC_RECVR,
+        TRC_DCACHE,
+        TRC_AITM,
+        TRC_RMW,
+        TRC_UCMDE,
+        TRC_DPU,
+        TRC_MEDIA,
+
+        NUM_TRC_STAGES
+    } trc_stage_t;
+
+    class ReqTracer
+    {
+      public:
+        ReqTracer( ) = delete;
+        ReqTracer(MemoryControlSystem* memsys_, std::string cfg_header);
+        ~ReqTracer( );
+
+        void sample(Packet* pkt, ncycle_t tick);
+        void touch(Packet* pkt, trc_stage_t stage, ncycle_t tick);
+        void finish(Packet* pkt, ncycle_t tick);
+
+        void print_chrome_trace( );
+        void print_breakdown(std::ostream& os);
+
+      private:
+        typedef std::pair<ncycle_t, int> trc_event_t; // <arrival tick, stage>
+        typedef struct _trc_record_t
+        {
+            id_t req_id;
+            id_t tid;
+            cmd_t cmd;
+            uint64_t LADDR;
+            ncycle_t start;
+            ncycle_t end;
+            bool done;
+            std::vector<trc_event_t> events;
+        } trc_record_t;
+
+        std::string cp_name;
+        std::string trace_path;
+        uint64_t sample_rate;   // trace 1 of sample_rate requests
+        uint64_t max_reqs;      // max # of traced requests
+        uint64_t num_seen;
+        ncycle_t ticks_per_cycle;
+
+        std::vector<trc_record_t> records;
+
+        static const char* stage_name[NUM_TRC_STAGES];
+        void get_breakdown(trc_record_t& rec, std::vector<ncycle_t>& stage_ticks);
+        void print_breakdown_cmd(std::ostream& os, cmd_t cmd);
+    };
+};
+
+#endif
@@ -2,10 +2,83 @@
 
 using namespace PCMCsim;
 
-StatsContainer::StatsContainer(void* stat_ptr, std::string tname,
-                      size_t tsize, std::string stat_name, std::string unit)
-: name(stat_name), unit_name(unit), type_name(tname), type_size(tsize), sptr(stat_ptr)
+double StatsContainer::getEpochValue( )
 {
+    /* Before calculate_stats, a value kept in ticks is shown in cycles */
+    double rv = getValue( );
+    if (tick_scale && *tick_scale>0)
+        rv /= (double)(*tick_scale);
+
+    return rv;
+}
+
+StatsNode::~StatsNode( )
+{
+    for (uint64_t i=0; i<children.size( ); i++)
+        delete children[i];
+}
+
+StatsNode* StatsNode::get_child(const std::string& child_key)
+{
+    /* Linear search to keep the registration order */
+    for (uint64_t i=0; i<children.size( ); i++)
+    {
+        if (children[i]->key==child_key)
+            return children[i];
+    }
+
+    StatsNode* new_node = new StatsNode(child_key);
+    children.push_back(new_node);
+    return new_node;
+}
+
+void StatsNode::insert(StatsContainer* stat)
+{
+    std::string stat_name = stat->getStatName( );
+    StatsNode* curr = this;
+    size_t st = 0;
+    size_t ed = stat_name.find('.');
+    while (ed!=std::string::npos)
+    {
+        curr = curr->get_child(stat_name.substr(st, ed-st));
+        st = ed+1;
+        ed = stat_name.find('.', st);
+    }
+    curr = curr->get_child(stat_name.substr(st));
+    curr->leaf = stat;
+}
+
+void StatsNode::print_json(std::ostream& os, uint64_t depth)
+{
+    std::string indent(2*(depth+1), ' ');
+    if (children.empty( ))
+    {
+        if (leaf)
+            leaf->printJSON(os);
+        else
+            os << "null";
+        return;
+    }
+
+    os << "{\n";
+    bool first = true;
+    if (leaf)
+    {
+        /* A stat whose name is also a prefix of other stats */
+        os << indent << "\"_value\": ";
+        leaf->printJSON(os);
+        first = false;
+    }
+
+    for (uint64_t i=0; i<children.size( ); i++)
+    {
+        if (first==false)
+            os << ",\n";
+        os << indent << "\"" << children[i]->key << "\": ";
+        children[i]->print_json(os, depth+1);
+        first = false;
+    }
+    os << "\n" << std::string(2*depth, ' ') << "}";
 }
 
 Stats::~Stats( )
@@ -18,14 +91,6 @@ Stats::~Stats( )
     }
 }
 
-void Stats::add_stat(void* stat_ptr, std::string type_name, 
-              size_t type_size, std::string stat_name, std::string unit)
-{
-    StatsContainer* new_stat = new StatsContainer(stat_ptr, type_name,
-                                                type_size, stat_name, unit);
-    slist.push_back(new_stat);
-}
-
 void Stats::remove_stat(void* stat_ptr)
 {
     std::list<StatsContainer*>::iterator s_it = slist.begin( );
@@ -54,25 +119,72 @@ void Stats::print(std::ostream& os)
             os << " ";
         else
             os << "[" << (*s_it)->getUnit( ) << "] ";
-        if ((*s_it)->getTypeName( )==typeid(int).name( ))
-            os << *(static_cast<int*>((*s_it)->getStatPtr( )));
-        else if ((*s_it)->getTypeName( )==typeid(float).name( ))
-            os << *(static_cast<float*>((*s_it)->getStatPtr( )));
-        else if ((*s_it)->getTypeName( )==typeid(double).name( ))
-            os << *(static_cast<double*>((*s_it)->getStatPtr( )));
-        else if ((*s_it)->getTypeName( )==typeid(uint64_t).name( ))
-            os << *(static_cast<uint64_t*>((*s_it)->getStatPtr( )));
-        else if ((*s_it)->getTypeName( )==typeid(std::string).name( ))
-            os << *(static_cast<std::string*>((*s_it)->getStatPtr( )));
-        else if ((*s_it)->getTypeName( )==typeid(ncycle_t).name( ))
-            os << *(static_cast<ncycle_t*>((*s_it)->getStatPtr( )));
-        else if ((*s_it)->getTypeName( )==typeid(nbyte_t).name( ))
-            os << *(static_cast<nbyte_t*>((*s_it)->getStatPtr( )));
-        else if ((*s_it)->getTypeName( )==typeid(id_t).name( ))
-            os << *(static_cast<id_t*>((*s_it)->getStatPtr( )));
-        else
-            os << "UNIDENTIFIED type";
+        (*s_it)->printValue(os);
         os << std::endl;
     }
 }
 
+void Stats::print_csv(std::ostream& os)
+{
+    std::list<StatsContainer*>::iterator s_it = slist.begin( );
+    for ( ; s_it!=slist.end( ); s_it++)
+    {
+        os << (*s_it)->getStatName( ) << "," << (*s_it)->getUnit( ) << ",";
+        (*s_it)->printJSON(os);
+        os << "\n";
+    }
+}
+
+void Stats::insert_tree(StatsNode* root)
+{
+    std::list<StatsContainer*>::iterator s_it = slist.begin( );
+    for ( ; s_it!=slist.end( ); s_it++)
+        root->insert(*s_it);
+}
+
+void Stats::init_snapshot( )
+{
+    /* Buffer is allocated only once, epoch dumps only overwrite it */
+    snapshot.clear( );
+    snapshot.resize(slist.size( ), 0.0);
+
+    uint64_t idx = 0;
+    std::list<StatsContainer*>::iterator s_it = slist.begin( );
+    for ( ; s_it!=slist.end( ); s_it++, idx++)
+    {
+        if ((*s_it)->isNumeric( ))
+            snapshot[idx] = (*s_it)->getEpochValue( );
+    }
+}
+
+void Stats::print_csv_header(std::ostream& os)
+{
+    std::list<StatsContainer*>::iterator s_it = slist.begin( );
+    for ( ; s_it!=slist.end( ); s_it++)
+    {
+        if ((*s_it)->isNumeric( )==false)
+            continue;
+
+        os << "," << (*s_it)->getStatName( );
+        if ((*s_it)->getUnit( )!="")
+            os << "[" << (*s_it)->getUnit( ) << "]";
+    }
+}
+
+void Stats::print_csv_delta(std::ostream& os, bool delta)
+{
+    assert(snapshot.size( )==slist.size( ));
+
+    uint64_t idx = 0;
+    std::list<StatsContainer*>::iterator s_it = slist.begin( );
+    for ( ; s_it!=slist.end( ); s_it++, idx++)
+    {
+        if ((*s_it)->isNumeric( )==false)
+            continue;
+
+        /* Levels are printed as their current values */
+        double curr = (*s_it)->getEpochValue( );
+        os << "," << ((delta && (*s_it)->isCumulative( ))? (curr-snapshot[idx]) : curr);
+        snapshot[idx] = curr;
+    }
+}
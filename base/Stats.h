@@ -29,91 +29,209 @@
 
  * Description: Statistics recording macros, which is modified
  * from NVMain (https://github.com/SEAL-UCSB/NVmain.git)
+ * Stats are kept as typed handles and exported as text, CSV, or JSON,
+ * where the JSON object is built from the hierarchical (dotted) names
  */
 
 #ifndef __PCMCSIM_STATS_H_
 #define __PCMCSIM_STATS_H_
 
-#include <typeinfo>
+#include <type_traits>
 #include "base/PCMCTypes.h"
 
 /* Usage available for users */
 #define RESET_STATS(STAT, resetVal)                    \
     do {                                                \
-        if (typeid(STAT)!=typeid(resetVal))             \
-        {                                               \
-            std::cerr << "Error! Cannot reset ["        \
-                << #STAT << "] due to unmatched types"  \
-                << " compared with the reset value."    \
-                << std::endl;                           \
-            assert(0);                                  \
-            exit(1);                                    \
-        }                                               \
-        memcpy((void*)&STAT, &resetVal, sizeof(STAT));  \
+        PCMCsim::reset_stat(STAT, resetVal);            \
     } while(0);
 
-#define ADD_STATS(MASTER_NAME, STAT)                   \
-    do {                                                \
-        _ADD_STATS_CORE(MASTER_NAME, STAT, "")         \
+#define ADD_STATS(MASTER_NAME, STAT)                                        \
+    do {                                                                    \
+        _ADD_STATS_CORE(MASTER_NAME, STAT, "", PCMCsim::STAT_ACCUM, NULL)   \
     } while(0);
 
-#define ADD_STATS_N_UNIT(MASTER_NAME, STAT, UNIT)      \
-    do {                                                \
-        _ADD_STATS_CORE(MASTER_NAME, STAT, UNIT)       \
+#define ADD_STATS_N_UNIT(MASTER_NAME, STAT, UNIT)                           \
+    do {                                                                    \
+        _ADD_STATS_CORE(MASTER_NAME, STAT, UNIT, PCMCsim::STAT_ACCUM, NULL) \
+    } while(0);
+
+#define ADD_STATS_ITER(MASTER_NAME, STATBASE, ITER_IDX)                     \
+    do {                                                                    \
+        _ADD_STATS_ITER_CORE(MASTER_NAME, STATBASE, ITER_IDX, "",           \
+                             PCMCsim::STAT_ACCUM, NULL)                     \
+    } while(0);
+
+#define ADD_STATS_ITER_UNIT(MASTER_NAME, STATBASE, ITER_IDX, UNIT)          \
+    do {                                                                    \
+        _ADD_STATS_ITER_CORE(MASTER_NAME, STATBASE, ITER_IDX, UNIT,         \
+                             PCMCsim::STAT_ACCUM, NULL)                     \
+    } while(0);
+
+/* Levels (extremes, averages, ratios) are not accumulated over epochs */
+#define ADD_STATS_LEVEL(MASTER_NAME, STAT)                                  \
+    do {                                                                    \
+        _ADD_STATS_CORE(MASTER_NAME, STAT, "", PCMCsim::STAT_LEVEL, NULL)   \
     } while(0);
 
-#define ADD_STATS_ITER(MASTER_NAME, STATBASE, ITER_IDX)            \
-    do {                                                            \
-        _ADD_STATS_ITER_CORE(MASTER_NAME, STATBASE, ITER_IDX, "")  \
+#define ADD_STATS_LEVEL_N_UNIT(MASTER_NAME, STAT, UNIT)                     \
+    do {                                                                    \
+        _ADD_STATS_CORE(MASTER_NAME, STAT, UNIT, PCMCsim::STAT_LEVEL, NULL) \
     } while(0);
 
-#define ADD_STATS_ITER_UNIT(MASTER_NAME, STATBASE, ITER_IDX, UNIT) \
-    do {                                                            \
-        _ADD_STATS_ITER_CORE(MASTER_NAME, STATBASE, ITER_IDX, UNIT)\
+#define ADD_STATS_ITER_LEVEL(MASTER_NAME, STATBASE, ITER_IDX)               \
+    do {                                                                    \
+        _ADD_STATS_ITER_CORE(MASTER_NAME, STATBASE, ITER_IDX, "",           \
+                             PCMCsim::STAT_LEVEL, NULL)                     \
+    } while(0);
+
+#define ADD_STATS_ITER_LEVEL_UNIT(MASTER_NAME, STATBASE, ITER_IDX, UNIT)    \
+    do {                                                                    \
+        _ADD_STATS_ITER_CORE(MASTER_NAME, STATBASE, ITER_IDX, UNIT,         \
+                             PCMCsim::STAT_LEVEL, NULL)                     \
+    } while(0);
+
+/* 
+ * Latencies are levels kept in ticks until calculate_stats converts
+ * them into cycles, so epoch dumps scale them by ticks_per_cycle 
+ */
+#define ADD_STATS_LAT(MASTER_NAME, STAT)                                    \
+    do {                                                                    \
+        _ADD_STATS_CORE(MASTER_NAME, STAT, "cycles",                        \
+                        PCMCsim::STAT_LEVEL, &this->ticks_per_cycle)        \
+    } while(0);
+
+#define ADD_STATS_ITER_LAT(MASTER_NAME, STATBASE, ITER_IDX)                 \
+    do {                                                                    \
+        _ADD_STATS_ITER_CORE(MASTER_NAME, STATBASE, ITER_IDX, "cycles",     \
+                             PCMCsim::STAT_LEVEL, &this->ticks_per_cycle)   \
     } while(0);
 
 /* Not for users (core macros) */
-#define _ADD_STATS_CORE(MASTER_NAME, STAT, UNIT)        \
-    do {                                                \
-        std::string tmp_name = MASTER_NAME;             \
-        this->stats->add_stat((void*)&STAT,             \
-               typeid(STAT).name( ),                    \
-               sizeof(STAT),                            \
-               tmp_name+"."+#STAT, UNIT);               \
+#define _ADD_STATS_CORE(MASTER_NAME, STAT, UNIT, KIND, SCALE)               \
+    do {                                                                    \
+        std::string tmp_name = MASTER_NAME;                                 \
+        this->stats->add_stat(&STAT,                                        \
+               tmp_name+"."+#STAT, UNIT, KIND, SCALE);                      \
     } while(0);
 
-#define _ADD_STATS_ITER_CORE(MASTER_NAME, STATBASE, ITER_IDX, UNIT)        \
+#define _ADD_STATS_ITER_CORE(MASTER_NAME, STATBASE, ITER_IDX, UNIT, KIND, SCALE)\
     do {                                                                    \
         std::string tmp_name = MASTER_NAME;                                 \
-        this->stats->add_stat((void*)(STATBASE+ITER_IDX),                   \
-            typeid(*STATBASE).name( ),                                      \
-            sizeof(*STATBASE),                                              \
-            tmp_name+"."+#STATBASE+"["+std::to_string(ITER_IDX)+"]", UNIT); \
+        this->stats->add_stat((STATBASE+ITER_IDX),                          \
+            tmp_name+"."+#STATBASE+"["+std::to_string(ITER_IDX)+"]", UNIT,  \
+            KIND, SCALE);                                                   \
     } while(0);
 
 namespace PCMCsim
 {
+    /* Type of reset value must be exactly same with the stat */
+    template<typename T, typename U>
+    inline void reset_stat(T& stat, const U& resetVal)
+    {
+        static_assert(std::is_same<T, U>::value, "Cannot reset a stat "
+            "due to unmatched types compared with the reset value.");
+        stat = resetVal;
+    }
+
+    /* Conversions of a stat value for numeric/machine-readable output */
+    template<typename T>
+    inline typename std::enable_if<std::is_arithmetic<T>::value, double>::type
+    stat_to_double(const T& val) { return (double)val; }
+
+    template<typename T>
+    inline typename std::enable_if<!std::is_arithmetic<T>::value, double>::type
+    stat_to_double(const T& /*val*/) { return 0.0; }
+
+    template<typename T>
+    inline typename std::enable_if<std::is_arithmetic<T>::value>::type
+    stat_to_json(std::ostream& os, const T& val) 
+    { 
+        if (std::isfinite((double)val))
+            os << +val;
+        else
+            os << "null";
+    }
+
+    template<typename T>
+    inline typename std::enable_if<!std::is_arithmetic<T>::value>::type
+    stat_to_json(std::ostream& os, const T& val) { os << "\"" << val << "\""; }
+
+    /* How a stat evolves over time, declared at the registration */
+    enum stat_kind_t
+    {
+        STAT_ACCUM = 0, // counter/accumulation, epoch dumps print the delta
+        STAT_LEVEL,     // extreme/average/ratio, epoch dumps print the value
+
+        NUM_STAT_KINDS
+    };
+
     class StatsContainer
     {
       public:
         StatsContainer( ) = delete;
-        StatsContainer(void* stat_ptr, std::string type_name,
-                      size_t type_size, std::string stat_name, std::string unit);
-        ~StatsContainer( ) { }
+        StatsContainer(std::string stat_name, std::string unit,
+                       stat_kind_t kind_, const ncycle_t* tick_scale_)
+        : name(stat_name), unit_name(unit), kind(kind_), tick_scale(tick_scale_) { }
+        virtual ~StatsContainer( ) { }
 
-        void* getStatPtr( ) { return sptr; }
         std::string getStatName( ) { return name; }
         std::string getUnit( ) { return unit_name; }
-        std::string getTypeName( ) { return type_name; }
-        size_t getTypeSize( ) { return type_size; }
+        bool isCumulative( ) { return (kind==STAT_ACCUM); }
+        double getEpochValue( );
+
+        virtual const void* getStatPtr( ) = 0;
+        virtual bool isNumeric( ) = 0;
+        virtual double getValue( ) = 0;
+        virtual void printValue(std::ostream& os) = 0;
+        virtual void printJSON(std::ostream& os) = 0;
         
-      private:
+      protected:
         std::string name;
         std::string unit_name;
-        std::string type_name;
-        size_t type_size;
-        
-        void* sptr;
+        stat_kind_t kind;
+        const ncycle_t* tick_scale; // ticks per cycle if kept in ticks
+    };
+
+    /* Typed handle of a stat variable owned by the master class */
+    template<typename T>
+    class StatHandle : public StatsContainer
+    {
+      public:
+        StatHandle( ) = delete;
+        StatHandle(T* stat_ptr, std::string stat_name, std::string unit,
+                   stat_kind_t kind_, const ncycle_t* tick_scale_)
+        : StatsContainer(stat_name, unit, kind_, tick_scale_), sptr(stat_ptr) { }
+        ~StatHandle( ) { }
+
+        T& get( ) { return *sptr; }
+
+        const void* getStatPtr( ) override { return sptr; }
+        bool isNumeric( ) override { return std::is_arithmetic<T>::value; }
+        double getValue( ) override { return stat_to_double(*sptr); }
+        void printValue(std::ostream& os) override { os << *sptr; }
+        void printJSON(std::ostream& os) override { stat_to_json(os, *sptr); }
+
+      private:
+        T* sptr;
+    };
+
+    /* Name tree of stats whose levels are separated by '.' */
+    class StatsNode
+    {
+      public:
+        StatsNode( ) = delete;
+        StatsNode(std::string key_) : key(key_), leaf(NULL) { }
+        ~StatsNode( );
+
+        void insert(StatsContainer* stat);
+        void print_json(std::ostream& os, uint64_t depth=0);
+
+      private:
+        std::string key;
+        StatsContainer* leaf;
+        std::vector<StatsNode*> children;
+
+        StatsNode* get_child(const std::string& child_key);
     };
 
     class Stats
@@ -122,15 +240,32 @@ namespace PCMCsim
         Stats( ) { }
         ~Stats( );
 
-        void add_stat(void* stat_ptr, std::string type_name, 
-                      size_t type_size, std::string stat_name, std::string unit);
+        template<typename T>
+        StatHandle<T>* add_stat(T* stat_ptr, std::string stat_name, std::string unit,
+                                stat_kind_t kind=STAT_ACCUM, const ncycle_t* tick_scale=NULL)
+        {
+            StatHandle<T>* new_stat = new StatHandle<T>(stat_ptr, stat_name, unit,
+                                                        kind, tick_scale);
+            slist.push_back(new_stat);
+            return new_stat;
+        }
+
         void remove_stat(void* stat_ptr);
         void print(std::ostream& os);
 
+        /* Machine-readable output */
+        void print_csv(std::ostream& os);
+        void insert_tree(StatsNode* root);
+
+        /* Epoch (time-series) dump in CSV */
+        void init_snapshot( );
+        void print_csv_header(std::ostream& os);
+        void print_csv_delta(std::ostream& os, bool delta=true);
+
       private:
         std::list<StatsContainer*> slist;
+        std::vector<double> snapshot; // values at the last epoch
     };
 };
 
 #endif
-
@@ -0,0 +1,41 @@
+#include "base/TagArray.h"
+
+using namespace PCMCsim;
+
+TagArray::TagArray(uint64_t num_sets_, uint64_t num_ways_)
+:num_sets(num_sets_), num_ways(num_ways_), words_per_set((num_ways_+63)/64)
+{
+    tags.resize(num_sets*num_ways, 0);
+    valid.resize(num_sets*words_per_set, 0);
+    dirty.resize(num_sets*words_per_set, 0);
+}
+
+int64_t TagArray::find(uint64_t set, uint64_t tag)
+{
+    const uint64_t* set_tags = &tags[set*num_ways];
+    for (uint64_t wd = 0; wd < words_per_set; wd++)
+    {
+        /* Compare every way of the word w/o branching, then mask invalids */
+        uint64_t base = wd*64;
+        uint64_t nway = std::min(num_ways-base, (uint64_t)64);
+        uint64_t hit = 0;
+        for (uint64_t i = 0; i < nway; i++)
+            hit |= (uint64_t)(set_tags[base+i]==tag) << i;
+
+        hit &= valid[set*words_per_set+wd];
+        if (hit)
+            return (int64_t)(base+__builtin_ctzll(hit));
+    }
+
+    return -1;
+}
+
+void TagArray::set_bit(std::vector<uint64_t>& mask, uint64_t set, 
+                       uint64_t way, bool val)
+{
+    uint64_t& word = mask[set*words_per_set+way/64];
+    if (val)
+        word |= (1ULL<<(way%64));
+    else
+        word &= ~(1ULL<<(way%64));
+}
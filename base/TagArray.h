@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) 2019 Computer Architecture and Paralllel Processing Lab, 
+ * Seoul National University, Republic of Korea. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     1. Redistribution of source code must retain the above copyright 
+ *        notice, this list of conditions and the follwoing disclaimer.
+ *     2. Redistributions in binary form must reproduce the above copyright 
+ *        notice, this list conditions and the following disclaimer in the 
+ *        documentation and/or other materials provided with the distirubtion.
+ *     3. Neither the name of the copyright holders nor the name of its 
+ *        contributors may be used to endorse or promote products derived from 
+ *        this software without specific prior written permission. 
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *
+ * Description: This is a tag store shared by set-associative caches. 
+ * Tags of a set are packed contiguously (SoA) and valid/dirty bits are 
+ * kept in per-set bitmasks, so a lookup compares all ways of a set in a 
+ * branch-free loop and picks the lowest valid match from the hit mask
+ */
+
+#ifndef __PCMCSIM_TAG_ARRAY_H_
+#define __PCMCSIM_TAG_ARRAY_H_
+
+#include "base/PCMCTypes.h"
+
+namespace PCMCsim
+{
+    class TagArray
+    {
+      public:
+        TagArray( ) = delete;
+        TagArray(uint64_t num_sets_, uint64_t num_ways_);
+        ~TagArray( ) { }
+
+        int64_t find(uint64_t set, uint64_t tag);   // -1 on miss
+
+        uint64_t get_tag(uint64_t set, uint64_t way) 
+        { return tags[set*num_ways+way]; }
+        void set_tag(uint64_t set, uint64_t way, uint64_t tag) 
+        { tags[set*num_ways+way] = tag; }
+
+        bool is_valid(uint64_t set, uint64_t way) 
+        { return get_bit(valid, set, way); }
+        void set_valid(uint64_t set, uint64_t way, bool val) 
+        { set_bit(valid, set, way, val); }
+
+        bool is_dirty(uint64_t set, uint64_t way) 
+        { return get_bit(dirty, set, way); }
+        void set_dirty(uint64_t set, uint64_t way, bool val) 
+        { set_bit(dirty, set, way, val); }
+
+      private:
+        uint64_t num_sets;
+        uint64_t num_ways;
+        uint64_t words_per_set;         // 64 ways per bitmask word
+
+        std::vector<uint64_t> tags;     // [SET*WAY]
+        std::vector<uint64_t> valid;    // [SET*words_per_set]
+        std::vector<uint64_t> dirty;
+
+        bool get_bit(std::vector<uint64_t>& mask, uint64_t set, uint64_t way)
+        { return (mask[set*words_per_set+way/64]>>(way%64))&0x1; }
+        void set_bit(std::vector<uint64_t>& mask, uint64_t set, 
+                     uint64_t way, bool val);
+    };
+};
+
+#endif
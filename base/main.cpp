@@ -1,10 +1,22 @@
 #include "base/PCMCTypes.h"
 #include "TraceExec/TraceExec.h"
+#include "TraceExec/SweepExec.h"
 
 using namespace PCMCsim;
 
 int main(int argc, char* argv[])
 {
+    if (SweepExec::is_sweep(argc, argv))
+    {
+        SweepExec* se = new SweepExec(argc, argv);
+
+        se->exec( );
+
+        delete se;
+
+        return 0;
+    }
+
     TraceExec* te = new TraceExec(argc, argv);
 
     te->exec( );
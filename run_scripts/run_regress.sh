@@ -0,0 +1,74 @@
+#!/bin/bash
+
+# Regression checks on the small traces of test_trace/
+# Each case runs a trace with config overrides (sweep spec of one variant)
+# and compares a stat with the expected value: N (equal) or >N, <N
+# Usage: run_scripts/run_regress.sh [binary]
+
+RUN_PATH=$(cd $(dirname $0)/.. && pwd)
+RUN_BIN=${1:-$RUN_PATH"/pcmcsim_run.fast"}
+LOG_PATH=$RUN_PATH'/trace_logs/regress/'
+
+# Configs have paths relative to the root
+cd $RUN_PATH
+mkdir -p $LOG_PATH
+
+NUM_FAIL=0
+
+# run_case <name> <trace> <config> <stat> <expected> [key=value ...]
+run_case()
+{
+    local name=$1 trace=$2 config=$3 stat=$4 expected=$5
+    shift 5
+
+    echo "$name $*" > $LOG_PATH/$name.spec
+    rm -f $LOG_PATH/out.$name
+    $RUN_BIN -i test_trace/$trace -c configs/$config \
+        -w $LOG_PATH/$name.spec -s $LOG_PATH/out > $LOG_PATH/$name.log 2>&1
+
+    local actual=$(awk -v s="$stat" '$1==s {print $2; exit}' $LOG_PATH/out.$name 2>/dev/null)
+    local pass=0
+    if [ -n "$actual" ]; then
+        case $expected in
+            \>*) pass=$(awk -v a=$actual -v e=${expected#>} 'BEGIN {print (a>e)}') ;;
+            \<*) pass=$(awk -v a=$actual -v e=${expected#<} 'BEGIN {print (a<e)}') ;;
+            *)   pass=$(awk -v a=$actual -v e=$expected 'BEGIN {print (a==e)}') ;;
+        esac
+    fi
+
+    if [ "$pass" == "1" ]; then
+        echo "PASS $name ($stat=$actual)"
+    else
+        echo "FAIL $name ($stat=${actual:-none}, expected $expected)"
+        NUM_FAIL=$((NUM_FAIL+1))
+    fi
+}
+
+# Read after a write buffered by write drain waits for the write (RAW)
+run_case raw_write_drain raw_write_drain.input example_dmc_ddr4.cfg \
+    "dram.ucmde[0].raw_holds" 1 \
+    "dram.ucmde[0].write_drain=true" "dram.reqRecv[0].drain_mode=false"
+
+# Combined full-page write keeps the stored metadata (page write count):
+# 2nd RMW write of the page must see pwcnt=1 and trigger WLV (th=2)
+run_case meta_full_page meta_full_page.input pcmcsim_base_public.cfg \
+    "rmw.num_WLV" 1 \
+    "rmw.wcb_size=8" "rmw.intr_th_WLV=2" "mcu=true" \
+    "media.pcm[0].data_enable=true" "media.pcm[0].meta_enable=true" \
+    "media.jedec[0].data_enable=true" "media.jedec[0].meta_enable=true"
+
+# Two PCM channels w/o channel-1 keys: they fall back to channel 0, and
+# reads to consecutive pages (channel bit right above the page) split
+run_case two_channels two_channels.input pcmcsim_base_public.cfg \
+    "ucmde.jedec[1].req_reads" 8 \
+    "pcm.channel_bits=1" "pcm.channel_order=0" "pcm.bankgroup_order=7"
+
+# SHiP keeps a reused set against scans: a scan of a coarse region learns
+# distant insertion, so every pass of the hot set after a scan hits
+# (SRRIP and line-tag signatures lose the hot set: read_hit=7)
+run_case ship_scan ship_scan.input pcmcsim_base_public.cfg \
+    "dcache.read_hit" 71 \
+    "dcache.bypass=false" "dcache.policy=SHIP"
+
+echo "$NUM_FAIL case(s) failed"
+exit $NUM_FAIL
@@ -0,0 +1,88 @@
+#include "base/MemoryControlSystem.h"
+#include "base/EventQueue.h"
+#include "base/Packet.h"
+#include "base/Stats.h"
+#include "uCMDEngine/ATLAS.h"
+
+#include <algorithm>
+
+using namespace PCMCsim;
+
+ATLAS::ATLAS(MemoryControlSystem* memsys_, AddressDecoder* adec_,
+    MemInfo* info_, std::string cfg_header, ncycle_t ticks_per_cycle_, uint64_t id_)
+:JedecEngine(memsys_, adec_, info_, cfg_header, ticks_per_cycle_, id_)
+{
+    quantum = memsys->getParamUINT64(cp_name+".ATLAS.quantum", 100000);
+    th_age = memsys->getParamUINT64(cp_name+".ATLAS.threshold_age", 100000);
+    alpha = memsys->getParamFLOAT(cp_name+".ATLAS.alpha", 0.875);
+    next_quantum_tick = quantum*ticks_per_cycle;
+
+    attained.resize(num_srcs, 0.0);
+    total_as.resize(num_srcs, 0.0);
+    src_rank.resize(num_srcs, 0);
+
+    num_quanta = 0;
+    num_over_threshold = 0;
+    ADD_STATS(cp_name, num_quanta);
+    ADD_STATS(cp_name, num_over_threshold);
+}
+
+void ATLAS::cycle_reqlist( )
+{
+    if (geq->getCurrentTick( )>=next_quantum_tick)
+        update_ranks( );
+
+    req_entry_t found;
+    if (find_prior(found))
+    {
+        /* Service is estimated before the bank state is changed */
+        attained[found.src] += get_service_est(found);
+        if (is_over_threshold(found))
+            num_over_threshold += 1;
+
+        insert_ucmdq(found.pkt);
+    }
+
+    JedecEngine::cycle_reqlist( );
+}
+
+void ATLAS::update_ranks( )
+{
+    /* Least attained service first, history is decayed by alpha */
+    std::vector<uint64_t> order(num_srcs);
+    for (uint64_t s=0; s<num_srcs; s++)
+    {
+        total_as[s] = alpha*total_as[s] + (1.0-alpha)*attained[s];
+        attained[s] = 0.0;
+        order[s] = s;
+    }
+
+    std::stable_sort(order.begin( ), order.end( ), 
+        [&](uint64_t a, uint64_t b) { return (total_as[a]<total_as[b]); });
+
+    for (uint64_t r=0; r<num_srcs; r++)
+        src_rank[order[r]] = r;
+
+    next_quantum_tick = geq->getCurrentTick( ) + quantum*ticks_per_cycle;
+    num_quanta += 1;
+}
+
+bool ATLAS::is_over_threshold(req_entry_t& entry)
+{
+    return ((geq->getCurrentTick( )-entry.pkt->recvTick_ucmde)>=
+            th_age*ticks_per_cycle);
+}
+
+bool ATLAS::is_prior(req_entry_t& lhs, req_entry_t& rhs)
+{
+    /* Over-threshold first, higher-ranked first, then FRFCFS */
+    bool lhs_old = is_over_threshold(lhs);
+    bool rhs_old = is_over_threshold(rhs);
+    if (lhs_old!=rhs_old)
+        return lhs_old;
+
+    if (src_rank[lhs.src]!=src_rank[rhs.src])
+        return (src_rank[lhs.src]<src_rank[rhs.src]);
+
+    return JedecEngine::is_prior(lhs, rhs);
+}
@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) 2019 Computer Architecture and Paralllel Processing Lab, 
+ * Seoul National University, Republic of Korea. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     1. Redistribution of source code must retain the above copyright 
+ *        notice, this list of conditions and the follwoing disclaimer.
+ *     2. Redistributions in binary form must reproduce the above copyright 
+ *        notice, this list conditions and the following disclaimer in the 
+ *        documentation and/or other materials provided with the distirubtion.
+ *     3. Neither the name of the copyright holders nor the name of its 
+ *        contributors may be used to endorse or promote products derived from 
+ *        this software without specific prior written permission. 
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * Authors: Hyokeun Lee (hklee@capp.snu.ac.kr)
+ *
+ * Decription: ATLAS (adaptive per-thread least-attained-service) scheduler
+ * based on JedecEngine. Sources are ranked by attained service at every 
+ * quantum, and requests waiting over a threshold are served first
+ */
+
+#ifndef __PCMCSIM_JEDEC_ATLAS_H_
+#define __PCMCSIM_JEDEC_ATLAS_H_
+
+#include "uCMDEngine/JedecEngine.h"
+
+namespace PCMCsim
+{
+    class ATLAS : public JedecEngine
+    {
+      public:
+        ATLAS( ) = delete;
+        ATLAS(MemoryControlSystem* memsys_, AddressDecoder* adec_,
+             MemInfo* info_, std::string cfg_header, 
+             ncycle_t ticks_per_cycle_=0, uint64_t id_=0);
+        ~ATLAS( ) { }
+
+        void cycle_reqlist( ) override;
+
+      private:
+        bool is_prior(req_entry_t& lhs, req_entry_t& rhs) override;
+        bool is_over_threshold(req_entry_t& entry);
+        void update_ranks( );
+
+        ncycle_t quantum;
+        ncycle_t next_quantum_tick;
+        ncycle_t th_age;        // age to be served regardless of rank 
+        double alpha;           // history weight of attained service
+        std::vector<double> attained;   // service in current quantum
+        std::vector<double> total_as;   // total attained service 
+        std::vector<uint64_t> src_rank; // lower is prior
+
+        /* Stats */
+        uint64_t num_quanta;
+        uint64_t num_over_threshold;
+    };
+};
+
+#endif
@@ -0,0 +1,69 @@
+#include "base/MemoryControlSystem.h"
+#include "base/EventQueue.h"
+#include "base/Packet.h"
+#include "base/Stats.h"
+#include "uCMDEngine/BLISS.h"
+
+using namespace PCMCsim;
+
+BLISS::BLISS(MemoryControlSystem* memsys_, AddressDecoder* adec_,
+    MemInfo* info_, std::string cfg_header, ncycle_t ticks_per_cycle_, uint64_t id_)
+:JedecEngine(memsys_, adec_, info_, cfg_header, ticks_per_cycle_, id_),
+last_src(0), cntr_served(0)
+{
+    th_blacklist = memsys->getParamUINT64(cp_name+".BLISS.threshold", 4);
+    clearing_interval = memsys->getParamUINT64(cp_name+".BLISS.clearing_interval", 10000);
+    next_clearing_tick = clearing_interval*ticks_per_cycle;
+    blacklist.resize(num_srcs, false);
+
+    num_blacklisted = 0;
+    num_clearings = 0;
+    ADD_STATS(cp_name, num_blacklisted);
+    ADD_STATS(cp_name, num_clearings);
+}
+
+void BLISS::cycle_reqlist( )
+{
+    /* Clear blacklist periodically */
+    if (geq->getCurrentTick( )>=next_clearing_tick)
+    {
+        std::fill(blacklist.begin( ), blacklist.end( ), false);
+        next_clearing_tick = geq->getCurrentTick( ) + 
+                             clearing_interval*ticks_per_cycle;
+        num_clearings += 1;
+    }
+
+    req_entry_t found;
+    if (find_prior(found))
+    {
+        /* Blacklist a source served consecutively over the threshold */
+        if (found.src==last_src)
+            cntr_served += 1;
+        else
+        {
+            last_src = found.src;
+            cntr_served = 1;
+        }
+
+        if (cntr_served>=th_blacklist && blacklist[found.src]==false)
+        {
+            blacklist[found.src] = true;
+            num_blacklisted += 1;
+
+            PCMC_DBG(dbg_msg, "[BLISS] Source %lu is blacklisted\n", found.src);
+        }
+
+        insert_ucmdq(found.pkt);
+    }
+
+    JedecEngine::cycle_reqlist( );
+}
+
+bool BLISS::is_prior(req_entry_t& lhs, req_entry_t& rhs)
+{
+    /* Non-blacklisted first, then row-hit first, then older first */
+    if (blacklist[lhs.src]!=blacklist[rhs.src])
+        return (blacklist[lhs.src]==false);
+
+    return JedecEngine::is_prior(lhs, rhs);
+}
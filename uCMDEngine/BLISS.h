@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) 2019 Computer Architecture and Paralllel Processing Lab, 
+ * Seoul National University, Republic of Korea. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     1. Redistribution of source code must retain the above copyright 
+ *        notice, this list of conditions and the follwoing disclaimer.
+ *     2. Redistributions in binary form must reproduce the above copyright 
+ *        notice, this list conditions and the following disclaimer in the 
+ *        documentation and/or other materials provided with the distirubtion.
+ *     3. Neither the name of the copyright holders nor the name of its 
+ *        contributors may be used to endorse or promote products derived from 
+ *        this software without specific prior written permission. 
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * Authors: Hyokeun Lee (hklee@capp.snu.ac.kr)
+ *
+ * Decription: BLISS (blacklisting memory scheduler) based on JedecEngine
+ * Sources served consecutively over a threshold are blacklisted (i.e., 
+ * deprioritized) until the blacklist is cleared periodically
+ */
+
+#ifndef __PCMCSIM_JEDEC_BLISS_H_
+#define __PCMCSIM_JEDEC_BLISS_H_
+
+#include "uCMDEngine/JedecEngine.h"
+
+namespace PCMCsim
+{
+    class BLISS : public JedecEngine
+    {
+      public:
+        BLISS( ) = delete;
+        BLISS(MemoryControlSystem* memsys_, AddressDecoder* adec_,
+             MemInfo* info_, std::string cfg_header, 
+             ncycle_t ticks_per_cycle_=0, uint64_t id_=0);
+        ~BLISS( ) { }
+
+        void cycle_reqlist( ) override;
+
+      private:
+        bool is_prior(req_entry_t& lhs, req_entry_t& rhs) override;
+
+        std::vector<bool> blacklist;
+        uint64_t th_blacklist;      // consecutive serves to be blacklisted
+        ncycle_t clearing_interval; 
+        ncycle_t next_clearing_tick;
+        uint64_t last_src;
+        uint64_t cntr_served;
+
+        /* Stats */
+        uint64_t num_blacklisted;
+        uint64_t num_clearings;
+    };
+};
+
+#endif
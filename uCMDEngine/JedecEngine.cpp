@@ -3,6 +3,7 @@
 #include "base/Packet.h"
 #include "base/Stats.h"
 #include "base/MemInfo.h"
+#include "base/ReqTracer.h"
 #include "uCMDEngine/JedecEngine.h"
 #include "uCMDEngine/StateMachines.h"
 
@@ -25,10 +26,11 @@ typedef struct _refresh_pulse_t
 
 JedecEngine::JedecEngine(MemoryControlSystem* memsys_, AddressDecoder* adec_, 
     MemInfo* info_, std::string cfg_header, ncycle_t ticks_per_cycle_, uint64_t id_)
-:uCMDEngine(memsys_), adec(adec_), info(info_), wake_reqlist(0), 
-last_wake_reqlist(0), wake_ucmdq(0), last_wake_ucmdq(0), ucmdq_ptr(0),
+:uCMDEngine(memsys_), adec(adec_), info(info_), num_reqlist(0), seq_reqlist(0),
+wake_reqlist(0), last_wake_reqlist(0), drain_mode(false), drain_forced(false), 
+num_wrlist(0), drain_start_tick(0), num_rawlist(0), wake_ucmdq(0), last_wake_ucmdq(0), ucmdq_ptr(0),
 wake_lp(0), last_wake_lp(0), last_wake_respq(0), wake_respq(0), 
-free_respq(0), last_updated_tick(0)
+free_respq(0)
 {
     id = id_;
     cp_name = cfg_header + "[" + std::to_string(id) + "]";
@@ -62,15 +64,50 @@ free_respq(0), last_updated_tick(0)
         page_policy = CLOSED_PAGE;
     else if (read_str=="OPEN_PAGE")
         page_policy = OPEN_PAGE;
+    else if (read_str=="ADAPTIVE_PAGE")
+        page_policy = ADAPTIVE_PAGE;
     else
         assert(0);
 
+    uint64_t pred_bits = memsys->getParamUINT64(cp_name+".page_pred_bits", 2);
+    if (pred_bits==0 || pred_bits>8)
+    {
+        std::cerr << "[JedecEngine] Error! Invalid bits of page predictor!" 
+            << std::endl;
+        assert(0);
+        exit(1);
+    }
+    pred_max = ((uint64_t)1<<pred_bits) - 1;
+    pred_th = (pred_max+1)/2;
+
     size_reqlist = memsys->getParamUINT64(cp_name+".size_reqlist", 2);
     use_pd = memsys->getParamBOOL(cp_name+".powerdown", false);
     use_refresh = memsys->getParamBOOL(cp_name+".AR", false);
     use_sref = memsys->getParamBOOL(cp_name+".SR", false);
     th_starv = memsys->getParamUINT64(cp_name+".threshold_starvation", 4);
 
+    use_write_drain = memsys->getParamBOOL(cp_name+".write_drain", false);
+    wr_high_watermark = memsys->getParamUINT64(
+        cp_name+".write_drain.high_watermark", size_reqlist*3/4);
+    wr_low_watermark = memsys->getParamUINT64(
+        cp_name+".write_drain.low_watermark", size_reqlist/4);
+    if (use_write_drain && 
+        (wr_low_watermark>=wr_high_watermark || wr_high_watermark>size_reqlist))
+    {
+        std::cerr << "[JedecEngine] Error! Invalid watermarks of write drain!" 
+            << std::endl;
+        assert(0);
+        exit(1);
+    }
+
+    /* Per-source (thread) accounting; the last one is for others */
+    num_srcs = memsys->getParamUINT64(cp_name+".num_sources", 4) + 1;
+    src_lat_sum = new double[num_srcs];
+    src_alone_sum = new double[num_srcs];
+    src_reqs = new uint64_t[num_srcs];
+    src_avg_lat = new double[num_srcs];
+    src_slowdown = new double[num_srcs];
+
     tBURST_RESP = memsys->getParamUINT64(cp_name+".tBURST_RESP", 4);
 
     if (use_pd)
@@ -110,12 +147,20 @@ free_respq(0), last_updated_tick(0)
     open_parts.resize(num_ranks);
     open_rows.resize(num_ranks);
     cntr_starv.resize(num_ranks);
+    hist_parts.resize(num_ranks);
+    hist_rows.resize(num_ranks);
+    pred_cntrs.resize(num_ranks);
+    pred_open.resize(num_ranks);
     for (uint64_t r=0; r<num_ranks; r++)
     {
         open_banks[r].resize(num_banks*num_bgs, false);
         open_parts[r].resize(num_banks*num_bgs);
         open_rows[r].resize(num_banks*num_bgs);
         cntr_starv[r].resize(num_banks*num_bgs);
+        hist_parts[r].resize(num_banks*num_bgs, 0);
+        hist_rows[r].resize(num_banks*num_bgs, num_rows);
+        pred_cntrs[r].resize(num_banks*num_bgs, pred_th);
+        pred_open[r].resize(num_banks*num_bgs, true);
         for (uint64_t b=0; b<num_banks*num_bgs; b++)
         {
             open_parts[r][b].resize(num_parts, false);
@@ -169,7 +214,27 @@ free_respq(0), last_updated_tick(0)
     if (use_sref)
         sref_ranks.resize(num_ranks, false);
 
-    ucmdq.resize(num_ranks*num_bgs*num_banks);
+    ucmdq.resize(num_ucmdq);
+    reqlist.resize(num_ucmdq);
+    wrlist.resize(num_ucmdq);
+    rawlist.resize(num_ucmdq);
+    req_row_hits.resize(num_ucmdq, 0);
+    wr_row_hits.resize(num_ucmdq, 0);
+
+    /* Non-empty bitmap and tournament tree over ucmdq heads */
+    ucmdq_bitmap.resize((num_ucmdq+63)/64, 0);
+    ucmdq_rank.resize(num_ucmdq);
+    for (uint64_t r=0; r<num_ranks; r++)
+    {
+        for (uint64_t b=0; b<num_all_banks; b++)
+            ucmdq_rank[get_ucmdq_idx(r, b)] = r;
+    }
+    rank_busy_ucmdqs.resize(num_ranks, 0);
+    ucmdq_busy = 0;
+    num_tree_leaves = 1;
+    while (num_tree_leaves<num_ucmdq)
+        num_tree_leaves <<= 1;
+    issuable_tree.resize(2*num_tree_leaves, std::numeric_limits<uint64_t>::max( ));
 
     register_stats( );
 }
@@ -178,6 +243,12 @@ JedecEngine::~JedecEngine( )
 {
     delete sm;
 
+    delete [] src_lat_sum;
+    delete [] src_alone_sum;
+    delete [] src_reqs;
+    delete [] src_avg_lat;
+    delete [] src_slowdown;
+
     for (uint64_t i=0; i<refresh_pulses.size( ); i++)
         delete (refresh_pulse_t*)(refresh_pulses[i]);
     refresh_pulses.clear( );
@@ -186,18 +257,23 @@ JedecEngine::~JedecEngine( )
 bool JedecEngine::isReady(Packet* /*pkt*/) 
 {
     bool rv = true;
-    uint64_t num_reqs = reqlist.size( )+req_events.size( )+await_req.size( );
-    if (num_reqs>=size_reqlist)
+    if (get_num_reqs( )>=size_reqlist)
         rv = false;
     return rv;
 }
 
+uint64_t JedecEngine::get_num_reqs( )
+{
+    return num_reqlist+req_events.size( )+await_req.size( );
+}
+
 void JedecEngine::recvRequest(Packet* pkt, ncycle_t delay)
 {
     assert(isReady(pkt));
     
     pkt->recvTick = geq->getCurrentTick( )+delay*ticks_per_cycle;
     pkt->recvTick_ucmde = geq->getCurrentTick( )+delay*ticks_per_cycle;
+    PCMC_TRACE(pkt, TRC_UCMDE, pkt->recvTick);
     Component::recvRequest(pkt, delay);
 
     /* Update Stats */
@@ -217,6 +293,7 @@ void JedecEngine::recvResponse(Packet* pkt, ncycle_t delay)
     else
     {
         assert(pkt->cmd==CMD_READ && master);
+        PCMC_TRACE(pkt, TRC_UCMDE, geq->getCurrentTick( )+delay*ticks_per_cycle);
         pkt->isDATA = true;
         pkt->from = this;
         Component::recvResponse(pkt, delay);
@@ -261,11 +338,11 @@ void JedecEngine::handle_await_reqs( )
             }
         }
 
-        reqlist.push_back(pkt);
+        push_reqlist(pkt);
 
         PCMC_DBG(dbg_msg, "[JE] Push req [0x%lx, ID=%lx, CMD=%s](%p)"
             " in request list (size=%lu/%lu)\n", pkt->LADDR, pkt->req_id, 
-            get_cmd_str(pkt).c_str( ), pkt, reqlist.size( ), size_reqlist); 
+            get_cmd_str(pkt).c_str( ), pkt, num_reqlist, size_reqlist); 
 
         /* Free event */
         delete (*e_it);
@@ -273,14 +350,11 @@ void JedecEngine::handle_await_reqs( )
     }
 
     /* Schedule event of request list */
-    if (last_wake_reqlist==wake_reqlist && reqlist.empty( )==false)
+    if (last_wake_reqlist==wake_reqlist && num_reqlist>0)
     {
-        std::list<Packet*>::iterator l_it = reqlist.begin( );
-        for ( ; l_it!=reqlist.end( ); l_it++)
+        for (uint64_t i=0; i<num_ucmdq; i++)
         {
-            uint64_t rank = adec->decode_addr((*l_it)->PADDR, FLD_RANK);
-            uint64_t bank = get_bank_idx(*l_it);
-            if (is_ucmdq_empty(rank, bank))
+            if (is_ucmdq_empty(i) && is_req_schedulable(i))
             {
                 wake_reqlist = geq->getCurrentTick( )+1*ticks_per_cycle; 
                 registerCallback((CallbackPtr)&JedecEngine::cycle_reqlist,
@@ -327,7 +401,7 @@ void JedecEngine::cycle_respq( )
 
     PCMC_DBG(dbg_msg, "[JE] RD data of req [0x%lx, ID=%lx, CMD=%s](%p)"
         " is responded to XBAR (size=%lu/%lu)\n", pkt->LADDR, pkt->req_id, 
-        get_cmd_str(pkt).c_str( ), pkt, reqlist.size( ), size_reqlist); 
+        get_cmd_str(pkt).c_str( ), pkt, num_reqlist, size_reqlist); 
 
     if (memsys->sys_name=="DRAM" || // MC only
         parent->isReady(pkt))       // AIT's DMC
@@ -374,22 +448,168 @@ void JedecEngine::cycle_reqlist( )
 
 bool JedecEngine::is_req_schedulable(uint64_t ucmdq_idx)
 {
+    bool rv = (get_sched_list( )[ucmdq_idx].empty( )==false)? true : false;
+    return rv;
+}
+
+void JedecEngine::push_reqlist(Packet* pkt)
+{
+    /* Decode coordinates once when a request enters the list */
+    const addr_coord_t& crd = adec->decode_pkt(pkt);
+    req_entry_t entry;
+    entry.pkt = pkt;
+    entry.seq = seq_reqlist++;
+    entry.rank = crd.fld[FLD_RANK];
+    entry.bank = get_bank_idx(pkt);
+    entry.row = crd.fld[FLD_ROW];
+    entry.part = crd.fld[FLD_HALF] * info->get_partitions( ) + 
+                 crd.fld[FLD_PART];
+    entry.src = get_src_idx(pkt);
+    entry.marked = false;
+
+    /* Track read-write turnarounds if served in arrival order */
+    int dir = (pkt->cmd==CMD_WRITE)? 1 : 0;
+    if (last_arrival_dir!=-1 && last_arrival_dir!=dir)
+        arrival_rw_switches += 1;
+    last_arrival_dir = dir;
+
+    uint64_t q = get_ucmdq_idx(entry.rank, entry.bank);
+    if (pkt->cmd==CMD_READ && is_raw_hazard(q, pkt))
+    {
+        /* Writes are acked already, so the read must not overtake them */
+        rawlist[q].push_back(entry);
+        num_rawlist += 1;
+        raw_holds += 1;
+
+        PCMC_DBG(dbg_msg, "[JE] Hold RD [0x%lx, ID=%lx] behind a buffered "
+            "WR to the same address\n", pkt->LADDR, pkt->req_id);
+    }
+    else if (use_write_drain && pkt->cmd==CMD_WRITE)
+    {
+        wrlist[q].push_back(entry);
+        num_wrlist += 1;
+        if (is_row_hit(entry))
+            wr_row_hits[q] += 1;
+    }
+    else
+    {
+        reqlist[q].push_back(entry);
+        if (is_row_hit(entry))
+            req_row_hits[q] += 1;
+    }
+    num_reqlist += 1;
+    update_qdepth(num_reqlist);
+
+    update_drain_mode( );
+}
+
+void JedecEngine::pop_reqlist(uint64_t q, std::list<req_entry_t>::iterator it)
+{
+    Packet* pkt = it->pkt;
+    if (is_row_hit(*it))
+        get_sched_row_hits( )[q] -= 1;
+    get_sched_list( )[q].erase(it);
+    num_reqlist -= 1;
+    update_qdepth(num_reqlist);
+    if (drain_mode)
+        num_wrlist -= 1;
+
+    /* ucmdq keeps the order, so held reads may follow the write from now */
+    if (pkt->cmd==CMD_WRITE && rawlist[q].empty( )==false)
+        release_raw(q, pkt->PADDR);
+
+    update_drain_mode( );
+}
+
+bool JedecEngine::is_raw_hazard(uint64_t q, Packet* pkt)
+{
+    /* Any write to the address still waiting in the list of writes */
     bool rv = false;
-    std::list<Packet*>::iterator l_it = reqlist.begin( );
-    for ( ; l_it!=reqlist.end( ); l_it++)
+    std::list<req_entry_t>& sublist = (use_write_drain)? wrlist[q] : reqlist[q];
+    std::list<req_entry_t>::iterator l_it = sublist.begin( );
+    for ( ; l_it!=sublist.end( ); l_it++)
     {
-        uint64_t rank = adec->decode_addr((*l_it)->PADDR, FLD_RANK);
-        uint64_t bank = get_bank_idx(*l_it);
-        if (get_ucmdq_idx(rank, bank)==ucmdq_idx)
+        if (l_it->pkt->cmd==CMD_WRITE && l_it->pkt->PADDR==pkt->PADDR)
         {
             rv = true;
             break;
         }
     }
-
     return rv;
 }
 
+void JedecEngine::release_raw(uint64_t q, uint64_t addr)
+{
+    std::list<req_entry_t>::iterator r_it = rawlist[q].begin( );
+    for ( ; r_it!=rawlist[q].end( ); )
+    {
+        if (r_it->pkt->PADDR!=addr || is_raw_hazard(q, r_it->pkt))
+        {
+            r_it++;
+            continue;
+        }
+
+        /* Sub-lists are kept in arrival order */
+        std::list<req_entry_t>::iterator l_it = reqlist[q].begin( );
+        while (l_it!=reqlist[q].end( ) && l_it->seq<r_it->seq)
+            l_it++;
+        reqlist[q].insert(l_it, *r_it);
+        num_rawlist -= 1;
+        if (is_row_hit(*r_it))
+            req_row_hits[q] += 1;
+
+        PCMC_DBG(dbg_msg, "[JE] Release RD [0x%lx, ID=%lx] after the "
+            "buffered WR is issued\n", r_it->pkt->LADDR, r_it->pkt->req_id);
+        r_it = rawlist[q].erase(r_it);
+    }
+}
+
+void JedecEngine::update_drain_mode( )
+{
+    if (use_write_drain==false)
+        return;
+
+    uint64_t num_rdlist = num_reqlist - num_wrlist - num_rawlist;
+    if (drain_mode==false)
+    {
+        /* Drain by high watermark, or opportunistically if no read to serve */
+        if (num_wrlist>=wr_high_watermark ||
+            ((num_rdlist==0 || num_rawlist>0) && num_wrlist>0))
+        {
+            drain_mode = true;
+            drain_forced = (num_wrlist>=wr_high_watermark);
+            drain_start_tick = geq->getCurrentTick( );
+            num_drains += 1;
+            if (drain_forced==false)
+                num_opp_drains += 1;
+
+            PCMC_DBG(dbg_msg, "[JE] Enter %s write drain (rd=%lu, wr=%lu)\n",
+                (drain_forced)? "forced":"opportunistic", num_rdlist, num_wrlist); 
+        }
+    }
+    else
+    {
+        if (num_wrlist>=wr_high_watermark)
+            drain_forced = true;
+
+        /* 
+         * Forced drain lasts until low watermark, others until read comes.
+         * Both go on while a read is held behind a write
+         */
+        if (num_wrlist==0 ||
+            (num_rawlist==0 && drain_forced && num_wrlist<=wr_low_watermark) ||
+            (num_rawlist==0 && drain_forced==false && num_rdlist>0))
+        {
+            drain_mode = false;
+            drain_cycles += 
+                (geq->getCurrentTick( )-drain_start_tick) / ticks_per_cycle;
+
+            PCMC_DBG(dbg_msg, "[JE] Exit write drain (rd=%lu, wr=%lu)\n",
+                num_rdlist, num_wrlist); 
+        }
+    }
+}
+
 bool JedecEngine::is_just_arrived(Packet* pkt)
 {
     bool rv = false;
@@ -412,18 +632,7 @@ bool JedecEngine::is_ucmdq_empty(uint64_t rank, uint64_t bank)
 
 bool JedecEngine::is_rank_ucmdqs_empty(uint64_t rank)
 {
-    bool rv = true;
-    for (uint64_t i=0; i<num_all_banks; i++)
-    {
-        uint64_t qidx = get_ucmdq_idx(rank, i);
-        if (is_ucmdq_empty(qidx)==false)
-        {
-            rv = false;
-            break;
-        }
-    }
-
-    return rv;
+    return (rank_busy_ucmdqs[rank]==0);
 }
 
 bool JedecEngine::is_refresh_needed(uint64_t rank, uint64_t bank)
@@ -487,16 +696,27 @@ bool JedecEngine::is_row_hit(uint64_t rank, uint64_t bank, uint64_t part, uint64
 
 void JedecEngine::insert_ucmdq(Packet* pkt)
 {
-    uint64_t PADDR = pkt->PADDR;
-    uint64_t rank = adec->decode_addr(PADDR, FLD_RANK);
+    const addr_coord_t& crd = adec->decode_pkt(pkt);
+    uint64_t rank = crd.fld[FLD_RANK];
     uint64_t bank = get_bank_idx(pkt);
-    uint64_t row = adec->decode_addr(PADDR, FLD_ROW);
-    uint64_t part = adec->decode_addr(PADDR, FLD_HALF) * 
-                    info->get_partitions( ) + 
-                    adec->decode_addr(PADDR, FLD_PART);
+    uint64_t row = crd.fld[FLD_ROW];
+    uint64_t part = crd.fld[FLD_HALF] * info->get_partitions( ) + 
+                    crd.fld[FLD_PART];
     uint64_t qidx = get_ucmdq_idx(rank, bank);
 
     assert(is_ucmdq_empty(qidx));
+    src_alone_sum[get_src_idx(pkt)] += 
+        get_service_est(rank, bank, part, row, pkt->cmd);
+
+    /* Close the row after the access unless it is predicted to hit again */
+    bool close_after = (page_policy==CLOSED_PAGE);
+    if (page_policy==ADAPTIVE_PAGE)
+    {
+        close_after = (predict_row_hit(rank, bank, part, row)==false);
+        if (close_after)
+            page_pred_closes += 1;
+    }
+
     if (open_banks[rank][bank]==false)
     {
         /* Access closed bank - open it */
@@ -507,17 +727,20 @@ void JedecEngine::insert_ucmdq(Packet* pkt)
         
         /* Insert ACT */
         Packet* act_pkt = gen_ucmd(pkt, CMD_ACT);
-        ucmdq[qidx].push(act_pkt);
+        push_ucmdq(qidx, act_pkt);
 
         /* Insert implicit cmd (performs auto-PRE) or original cmd */
-        if (page_policy==CLOSED_PAGE)
+        if (close_after)
         {
             Packet* converted_pkt = gen_ucmd(pkt, CMD_IMPLICIT);
-            ucmdq[qidx].push(converted_pkt);
+            push_ucmdq(qidx, converted_pkt);
             close_bank(rank, bank, part);
         }
         else
-            ucmdq[qidx].push(pkt);
+        {
+            push_ucmdq(qidx, pkt);
+            index_row_hits(rank, bank);
+        }
 
         row_miss += 1;
     }
@@ -529,17 +752,23 @@ void JedecEngine::insert_ucmdq(Packet* pkt)
 
         /* Insert PRE */
         Packet* pre_pkt = gen_ucmd(pkt, CMD_PRE);
-        ucmdq[qidx].push(pre_pkt);
+        push_ucmdq(qidx, pre_pkt);
         close_bank(rank, bank);
 
         /* Insert ACT & original - open bank */
         Packet* act_pkt = gen_ucmd(pkt, CMD_ACT);
-        ucmdq[qidx].push(act_pkt);
-        ucmdq[qidx].push(pkt);
+        push_ucmdq(qidx, act_pkt);
+        if (close_after)
+            push_ucmdq(qidx, gen_ucmd(pkt, CMD_IMPLICIT));
+        else
+        {
+            push_ucmdq(qidx, pkt);
 
-        open_banks[rank][bank] = true;
-        open_parts[rank][bank][part] = true;
-        open_rows[rank][bank][part] = row;
+            open_banks[rank][bank] = true;
+            open_parts[rank][bank][part] = true;
+            open_rows[rank][bank][part] = row;
+            index_row_hits(rank, bank);
+        }
         
         row_miss += 1;
     }
@@ -547,9 +776,15 @@ void JedecEngine::insert_ucmdq(Packet* pkt)
         is_row_hit(rank, bank, part, row))
     {
         /* Row hit */
-        assert(page_policy==OPEN_PAGE);
+        assert(page_policy!=CLOSED_PAGE);
         cntr_starv[rank][bank][part] += 1;
-        ucmdq[qidx].push(pkt);
+        if (close_after)
+        {
+            push_ucmdq(qidx, gen_ucmd(pkt, CMD_IMPLICIT));
+            close_bank(rank, bank, part);
+        }
+        else
+            push_ucmdq(qidx, pkt);
         
         row_hits += 1;
     }
@@ -575,6 +810,64 @@ void JedecEngine::insert_ucmdq(Packet* pkt)
     }
 }
 
+bool JedecEngine::predict_row_hit(uint64_t rank, uint64_t bank, 
+                                  uint64_t part, uint64_t row)
+{
+    /* Train the predictor with the outcome of its last prediction */
+    if (hist_rows[rank][bank]<info->get_rowsPerMAT( ))
+    {
+        /*
+         * Row left open: this access really hits it (FR-FCFS already took
+         * any queued hit). Row closed: it would have hit if this access or 
+         * a queued one, which FR-FCFS would have taken first, targets it
+         */
+        bool actual_hit = false;
+        if (pred_open[rank][bank])
+            actual_hit = is_row_hit(rank, bank, part, row);
+        else
+        {
+            actual_hit = (hist_parts[rank][bank]==part && 
+                          hist_rows[rank][bank]==row) ||
+                is_row_queued(rank, bank, hist_parts[rank][bank], 
+                              hist_rows[rank][bank]);
+        }
+
+        page_preds += 1;
+        if (actual_hit==pred_open[rank][bank])
+            page_preds_correct += 1;
+
+        if (actual_hit && pred_cntrs[rank][bank]<pred_max)
+            pred_cntrs[rank][bank] += 1;
+        else if (actual_hit==false && pred_cntrs[rank][bank]>0)
+            pred_cntrs[rank][bank] -= 1;
+    }
+
+    /* A queued req to the row is taken next by FR-FCFS, so keep it open */
+    hist_parts[rank][bank] = part;
+    hist_rows[rank][bank] = row;
+    pred_open[rank][bank] = (pred_cntrs[rank][bank]>=pred_th ||
+                             is_row_queued(rank, bank, part, row));
+    return pred_open[rank][bank];
+}
+
+bool JedecEngine::is_row_queued(uint64_t rank, uint64_t bank, 
+                                uint64_t part, uint64_t row)
+{
+    bool rv = false;
+    std::list<req_entry_t>& sublist = 
+        get_sched_list( )[get_ucmdq_idx(rank, bank)];
+    std::list<req_entry_t>::iterator l_it = sublist.begin( );
+    for ( ; l_it!=sublist.end( ); l_it++)
+    {
+        if (l_it->part==part && l_it->row==row)
+        {
+            rv = true;
+            break;
+        }
+    }
+    return rv;
+}
+
 void JedecEngine::schedule_postupdate(Packet* pkt)
 {
     ncycle_t latency = sm->get_postupdate_latency(pkt);
@@ -594,6 +887,7 @@ void JedecEngine::postupdate_states_cb(Packet* pkt)
 {
     assert(pkt->owner==this);
     sm->postupdate_states(pkt);
+    update_issuable(pkt);
     delete pkt;
 
     /* Lower power handling after state update */
@@ -602,142 +896,199 @@ void JedecEngine::postupdate_states_cb(Packet* pkt)
 
 bool JedecEngine::find_starved(Packet*& found_req)
 {
-    bool rv = false;
-    found_req = NULL;
+    return find_req(found_req, FIND_STARVED);
+}
 
-    std::list<Packet*>::iterator l_it = reqlist.begin( );
-    for ( ; l_it!=reqlist.end( ); l_it++)
-    {
-        uint64_t PADDR = (*l_it)->PADDR;
-        uint64_t rank = adec->decode_addr(PADDR, FLD_RANK);
-        uint64_t bank = get_bank_idx(*l_it);
-        uint64_t row = adec->decode_addr(PADDR, FLD_ROW);
-        uint64_t part = adec->decode_addr(PADDR, FLD_HALF) * 
-                        info->get_partitions( ) + 
-                        adec->decode_addr(PADDR, FLD_PART);
-
-        if (is_ucmdq_empty(rank, bank)==false) continue;
-
-        if (open_banks[rank][bank] &&
-            is_row_hit(rank, bank, part, row)==false &&
-            is_refresh_needed(rank, bank)==false &&
-            cntr_starv[rank][bank][part]>=th_starv &&
-            is_just_arrived(*l_it)==false)
-        {
-            found_req = (*l_it);
-            reqlist.erase(l_it);
-            rv = true;
-            break;
-        }
-    }
+bool JedecEngine::find_row_hit(Packet*& found_req)
+{
+    return find_req(found_req, FIND_ROW_HIT);
+}
 
-    return rv;
+bool JedecEngine::find_open_bank(Packet*& found_req)
+{
+    return find_req(found_req, FIND_OPEN_BANK);
 }
 
-bool JedecEngine::find_row_hit(Packet*& found_req)
+bool JedecEngine::find_closed_bank(Packet*& found_req)
 {
+    return find_req(found_req, FIND_CLOSED_BANK);
+}
+
+bool JedecEngine::find_req(Packet*& found_req, int cond)
+{
+    /* 
+     * Returns the oldest request (in arrival order) satisfying the condition.
+     * Bank-wide conditions are checked once per sub-list, and the scan of 
+     * each sub-list stops as soon as it cannot beat the current candidate
+     */
     bool rv = false;
     found_req = NULL;
 
-    std::list<Packet*>::iterator l_it = reqlist.begin( );
-    for ( ; l_it!=reqlist.end( ); l_it++)
+    reqlist_t& rlist = get_sched_list( );
+
+    uint64_t found_q = 0;
+    std::list<req_entry_t>::iterator found_it;
+    for (uint64_t q=0; q<num_ucmdq; q++)
     {
-        uint64_t PADDR = (*l_it)->PADDR;
-        uint64_t rank = adec->decode_addr(PADDR, FLD_RANK);
-        uint64_t bank = get_bank_idx(*l_it);
-        uint64_t row = adec->decode_addr(PADDR, FLD_ROW);
-        uint64_t part = adec->decode_addr(PADDR, FLD_HALF) * 
-                        info->get_partitions( ) + 
-                        adec->decode_addr(PADDR, FLD_PART);
-
-        if (is_ucmdq_empty(rank, bank)==false) continue;
-
-        if (open_banks[rank][bank] &&
-            is_row_hit(rank, bank, part, row) &&
-            is_refresh_needed(rank, bank)==false &&
-            is_just_arrived(*l_it)==false)
+        if (rlist[q].empty( ) || is_ucmdq_empty(q)==false) 
+            continue;
+
+        uint64_t rank = rlist[q].front( ).rank;
+        uint64_t bank = rlist[q].front( ).bank;
+        bool is_open = open_banks[rank][bank];
+        if (is_refresh_needed(rank, bank) ||
+            (cond==FIND_CLOSED_BANK && is_open) ||
+            (cond!=FIND_CLOSED_BANK && is_open==false))
+            continue;
+
+        /* Banks without a request to the open row are not walked */
+        if (cond==FIND_ROW_HIT && get_sched_row_hits( )[q]==0)
+            continue;
+
+        std::list<req_entry_t>::iterator l_it = rlist[q].begin( );
+        for ( ; l_it!=rlist[q].end( ); l_it++)
         {
-            found_req = (*l_it);
-            reqlist.erase(l_it);
-            rv = true;
-            break;
+            if (rv && l_it->seq>found_it->seq)
+                break;
+
+            if (cond==FIND_STARVED &&
+                (is_row_hit(rank, bank, l_it->part, l_it->row) ||
+                 cntr_starv[rank][bank][l_it->part]<th_starv))
+                continue;
+            else if (cond==FIND_ROW_HIT &&
+                is_row_hit(rank, bank, l_it->part, l_it->row)==false)
+                continue;
+
+            if (is_just_arrived(l_it->pkt)==false)
+            {
+                found_q = q;
+                found_it = l_it;
+                rv = true;
+                break;
+            }
         }
     }
 
+    if (rv)
+    {
+        found_req = found_it->pkt;
+        pop_reqlist(found_q, found_it);
+    }
+
     return rv;
 }
 
-bool JedecEngine::find_open_bank(Packet*& found_req)
+bool JedecEngine::is_prior(req_entry_t& lhs, req_entry_t& rhs)
+{
+    /* Default priority: row-hit first, then older first (FRFCFS) */
+    bool lhs_hit = is_row_hit(lhs);
+    bool rhs_hit = is_row_hit(rhs);
+    if (lhs_hit!=rhs_hit)
+        return lhs_hit;
+
+    return (lhs.seq<rhs.seq);
+}
+
+bool JedecEngine::find_prior(req_entry_t& found_entry)
 {
+    /* Returns the request of the highest priority defined by is_prior */
     bool rv = false;
-    found_req = NULL;
+    reqlist_t& rlist = get_sched_list( );
 
-    std::list<Packet*>::iterator l_it = reqlist.begin( );
-    for ( ; l_it!=reqlist.end( ); l_it++)
+    uint64_t found_q = 0;
+    std::list<req_entry_t>::iterator found_it;
+    for (uint64_t q=0; q<num_ucmdq; q++)
     {
-        uint64_t PADDR = (*l_it)->PADDR;
-        uint64_t rank = adec->decode_addr(PADDR, FLD_RANK);
-        uint64_t bank = get_bank_idx(*l_it);
+        if (rlist[q].empty( ) || is_ucmdq_empty(q)==false) 
+            continue;
 
-        if (is_ucmdq_empty(rank, bank)==false) continue;
+        if (is_refresh_needed(rlist[q].front( ).rank, rlist[q].front( ).bank))
+            continue;
 
-        if (open_banks[rank][bank] &&
-            is_refresh_needed(rank, bank)==false &&
-            is_just_arrived(*l_it)==false)
+        std::list<req_entry_t>::iterator l_it = rlist[q].begin( );
+        for ( ; l_it!=rlist[q].end( ); l_it++)
         {
-            found_req = (*l_it);
-            reqlist.erase(l_it);
-            rv = true;
-            break;
+            if (is_just_arrived(l_it->pkt))
+                continue;
+
+            if (rv==false || is_prior(*l_it, *found_it))
+            {
+                found_q = q;
+                found_it = l_it;
+                rv = true;
+            }
         }
     }
 
+    if (rv)
+    {
+        found_entry = *found_it;
+        pop_reqlist(found_q, found_it);
+    }
+
     return rv;
 }
 
-bool JedecEngine::find_closed_bank(Packet*& found_req)
+bool JedecEngine::is_row_hit(req_entry_t& entry)
 {
-    bool rv = false;
-    found_req = NULL;
+    return is_row_hit(entry.rank, entry.bank, entry.part, entry.row);
+}
 
-    std::list<Packet*>::iterator l_it = reqlist.begin( );
-    for ( ; l_it!=reqlist.end( ); l_it++)
-    {
-        uint64_t PADDR = (*l_it)->PADDR;
-        uint64_t rank = adec->decode_addr(PADDR, FLD_RANK);
-        uint64_t bank = get_bank_idx(*l_it);
+void JedecEngine::index_row_hits(uint64_t rank, uint64_t bank)
+{
+    /* Recount the sub-lists of the bank against its newly opened row */
+    uint64_t q = get_ucmdq_idx(rank, bank);
+    std::list<req_entry_t>::iterator l_it;
 
-        if (is_ucmdq_empty(rank, bank)==false) continue;
+    req_row_hits[q] = 0;
+    for (l_it=reqlist[q].begin( ); l_it!=reqlist[q].end( ); l_it++)
+    {
+        if (is_row_hit(*l_it))
+            req_row_hits[q] += 1;
+    }
 
-        if (open_banks[rank][bank]==false &&
-            is_refresh_needed(rank, bank)==false &&
-            is_just_arrived(*l_it)==false)
-        {
-            found_req = (*l_it);
-            reqlist.erase(l_it);
-            rv = true;
-            break;
-        }
+    wr_row_hits[q] = 0;
+    for (l_it=wrlist[q].begin( ); l_it!=wrlist[q].end( ); l_it++)
+    {
+        if (is_row_hit(*l_it))
+            wr_row_hits[q] += 1;
     }
+}
 
+uint64_t JedecEngine::get_src_idx(Packet* pkt)
+{
+    /* Host requests are classified by thread ID, others share the last */
+    uint64_t rv = num_srcs-1;
+    if (pkt->src_id==SRC_HOST && pkt->tid>=0)
+        rv = (uint64_t)pkt->tid % (num_srcs-1);
     return rv;
 }
 
+ncycle_t JedecEngine::get_service_est(uint64_t rank, uint64_t bank, 
+    uint64_t part, uint64_t row, cmd_t cmd)
+{
+    /* Latency of a request if the bank were dedicated to its source */
+    ncycle_t rv = (cmd==CMD_READ)? sm->tCL : sm->tCWL;
+    rv += sm->tBURST;
+    if (open_banks[rank][bank]==false)
+        rv += sm->tRCD;
+    else if (is_row_hit(rank, bank, part, row)==false)
+        rv += sm->tRP + sm->tRCD;
+    return rv;
+}
+
+ncycle_t JedecEngine::get_service_est(req_entry_t& entry)
+{
+    return get_service_est(entry.rank, entry.bank, entry.part, 
+                           entry.row, entry.pkt->cmd);
+}
+
 std::pair<bool, ncycle_t> JedecEngine::timely_issuable( )
 {
     bool issuable = false;
-    ncycle_t free_tick = std::numeric_limits<uint64_t>::max( );
-    for (uint64_t r=0; r<num_ranks; r++)
-    {
-        for (uint64_t b=0; b<num_all_banks; b++)
-        {
-            uint64_t qidx = get_ucmdq_idx(r, b);
-            if (is_ucmdq_empty(r, b)) continue;
 
-            Packet* head_pkt = ucmdq[qidx].front( );
-            free_tick = MIN(free_tick, sm->timely_issuable(head_pkt));
-        }
-    }
+    /* Root of the tree is the earliest tick over all ucmdq heads */
+    ncycle_t free_tick = issuable_tree[1];
 
     if (free_tick!=std::numeric_limits<uint64_t>::max( ))
         issuable = true;
@@ -754,20 +1105,15 @@ void JedecEngine::cycle_ucmdq( )
     /* Function for issuing ucmds to media */
     bool issued = false;
 
-    /* Update stats before changing to the next state */
-    ncycle_t sync_cycles = 
-        (geq->getCurrentTick( )-last_updated_tick) / ticks_per_cycle;
-    last_updated_tick = geq->getCurrentTick( );
-    sm->update_stats(sync_cycles);
-
     /* Prepare refresh ucmds */
     if (use_refresh)
         prepare_refresh( );
 
-    /* Ready to issue ucmds to media */
-    for (uint64_t i=0; i<num_ucmdq; i++)
+    /* Ready to issue ucmds to media (visit non-empty ucmdqs only) */
+    uint64_t num_busy = ucmdq_busy;
+    uint64_t qidx = find_ucmdq(ucmdq_ptr);
+    for (uint64_t i=0; i<num_busy; i++, qidx=find_ucmdq(qidx+1))
     {
-        uint64_t qidx = (ucmdq_ptr+i) % num_ucmdq;
         if (ucmdq[qidx].empty( )==false)
         {
             Packet* pkt = ucmdq[qidx].front( );
@@ -783,6 +1129,7 @@ void JedecEngine::cycle_ucmdq( )
             
             /* ucmds are issuable in this cycle */
             ncycle_t latency = sm->update_states(pkt);
+            update_issuable(pkt);
             schedule_postupdate(pkt);
 
             PCMC_DBG(dbg_msg, "[JE] Issue ucmd of req [0x%lx, ID=%lx,"
@@ -802,6 +1149,19 @@ void JedecEngine::cycle_ucmdq( )
                 avg_issue_lat = 
                     (avg_issue_lat*num_issue+tmp_lat)/(double)(num_issue+1);
                 num_issue += 1;
+
+                /* Shared latency: wait in engine plus data transfer */
+                uint64_t src = get_src_idx(pkt);
+                ncycle_t cas_lat = (pkt->cmd==CMD_READ || pkt->cmd==CMD_READ_PRE)?
+                    sm->tCL : sm->tCWL;
+                src_lat_sum[src] += (double)(geq->getCurrentTick( )-
+                    pkt->recvTick_ucmde)/ticks_per_cycle + cas_lat + sm->tBURST;
+                src_reqs[src] += 1;
+
+                int dir = (pkt->cmd==CMD_WRITE || pkt->cmd==CMD_WRITE_PRE)? 1 : 0;
+                if (last_cas_dir!=-1 && last_cas_dir!=dir)
+                    rw_switches += 1;
+                last_cas_dir = dir;
             }
 
             pkt->from = this;
@@ -831,12 +1191,12 @@ void JedecEngine::cycle_ucmdq( )
             }
             else if (pkt->cmd==CMD_REFRESH)
             {
-                uint64_t rank = adec->decode_addr(pkt->PADDR, FLD_RANK);
+                uint64_t rank = adec->decode_pkt(pkt).fld[FLD_RANK];
                 uint64_t bank = get_bank_idx(pkt);
                 rst_refresh_ucmdq_standby(rank, bank);
             }
 
-            ucmdq[qidx].pop( );
+            pop_ucmdq(qidx);
             update_ucmdq_ptr(qidx);
 
             issued = true;
@@ -845,7 +1205,7 @@ void JedecEngine::cycle_ucmdq( )
             bool can_schedule = false;
             if (pkt->cmd==CMD_REFRESH)
             {
-                uint64_t rank = adec->decode_addr(pkt->PADDR, FLD_RANK);
+                uint64_t rank = adec->decode_pkt(pkt).fld[FLD_RANK];
                 uint64_t bk_head = (get_bank_idx(pkt)/
                         sm->banks_per_refresh) * sm->banks_per_refresh;
 
@@ -937,6 +1297,89 @@ void JedecEngine::update_ucmdq_ptr(uint64_t curr_idx)
     ucmdq_ptr = (curr_idx+1) % num_ucmdq;
 }
 
+void JedecEngine::push_ucmdq(uint64_t qidx, Packet* pkt)
+{
+    ucmdq[qidx].push(pkt);
+    if (ucmdq[qidx].size( )==1)
+    {
+        /* ucmdq becomes non-empty and pkt is its new head */
+        ucmdq_bitmap[qidx/64] |= (1ULL<<(qidx%64));
+        rank_busy_ucmdqs[ucmdq_rank[qidx]] += 1;
+        ucmdq_busy += 1;
+        update_issuable(qidx);
+    }
+}
+
+void JedecEngine::pop_ucmdq(uint64_t qidx)
+{
+    ucmdq[qidx].pop( );
+    if (ucmdq[qidx].empty( ))
+    {
+        ucmdq_bitmap[qidx/64] &= ~(1ULL<<(qidx%64));
+        rank_busy_ucmdqs[ucmdq_rank[qidx]] -= 1;
+        ucmdq_busy -= 1;
+    }
+    update_issuable(qidx);
+}
+
+uint64_t JedecEngine::find_ucmdq(uint64_t from)
+{
+    /* First non-empty ucmdq at or after 'from' in circular order */
+    uint64_t num_words = ucmdq_bitmap.size( );
+    for (uint64_t i=0; i<=num_words; i++)
+    {
+        uint64_t w = (from/64+i) % num_words;
+        uint64_t bits = ucmdq_bitmap[w];
+        if (i==0)
+            bits &= (from%64==0)? ~0ULL : ~((1ULL<<(from%64))-1);
+        if (bits!=0)
+            return (w*64+__builtin_ctzll(bits));
+    }
+    return num_ucmdq;
+}
+
+void JedecEngine::update_issuable(uint64_t qidx)
+{
+    uint64_t node = num_tree_leaves+qidx;
+    issuable_tree[node] = (ucmdq[qidx].empty( ))? 
+        std::numeric_limits<uint64_t>::max( ) : 
+        sm->timely_issuable(ucmdq[qidx].front( ));
+    for (node=node/2; node>0; node=node/2)
+        issuable_tree[node] = MIN(issuable_tree[2*node], issuable_tree[2*node+1]);
+}
+
+void JedecEngine::update_issuable(Packet* pkt)
+{
+    /* 
+     * A ucmd shifts the timings of its own rank only, except that a CAS
+     * also constrains CAS of the other ranks (e.g., tRTRS). Only the leaves
+     * of those non-empty ucmdqs are updated
+     */
+    uint64_t rank = adec->decode_pkt(pkt).fld[FLD_RANK];
+    bool is_cas = (pkt->cmd==CMD_READ || pkt->cmd==CMD_READ_PRE ||
+                   pkt->cmd==CMD_WRITE || pkt->cmd==CMD_WRITE_PRE);
+
+    for (uint64_t r=0; r<num_ranks; r++)
+    {
+        if (rank_busy_ucmdqs[r]==0 || (r!=rank && is_cas==false))
+            continue;
+
+        for (uint64_t b=0; b<num_all_banks; b++)
+        {
+            uint64_t q = get_ucmdq_idx(r, b);
+            if (ucmdq[q].empty( ))
+                continue;
+
+            cmd_t head_cmd = ucmdq[q].front( )->cmd;
+            if (r!=rank && head_cmd!=CMD_READ && head_cmd!=CMD_READ_PRE &&
+                head_cmd!=CMD_WRITE && head_cmd!=CMD_WRITE_PRE)
+                continue;
+
+            update_issuable(q);
+        }
+    }
+}
+
 void JedecEngine::refresh_cb(void* pulse)
 {
     mark_refresh(pulse);
@@ -1007,7 +1450,7 @@ void JedecEngine::gen_refresh_ucmds( )
 
                         close_bank(ridx, bidx);
                         Packet* pre_ucmd = gen_ucmd(ridx, bidx, CMD_PRE);
-                        ucmdq[qidx].push(pre_ucmd);
+                        push_ucmdq(qidx, pre_ucmd);
                     }
                 }
             }
@@ -1024,14 +1467,14 @@ void JedecEngine::gen_refresh_ucmds( )
 
                     close_bank(ridx, bidx);
                     Packet* pre_ucmd = gen_ucmd(ridx, bidx, CMD_PRE);
-                    ucmdq[qidx].push(pre_ucmd);
+                    push_ucmdq(qidx, pre_ucmd);
                 }
             }
 
             /* Generate refresh ucmd for dispatch */
             Packet* refresh_ucmd = gen_ucmd(ridx, bk_head, CMD_REFRESH);
             uint64_t qidx = get_ucmdq_idx(ridx, bk_head);
-            ucmdq[qidx].push(refresh_ucmd);
+            push_ucmdq(qidx, refresh_ucmd);
 
             /* Update refresh states */
             set_refresh_ucmdq_standby(ridx, bk_head);
@@ -1065,7 +1508,7 @@ void JedecEngine::gen_refresh_ucmds( )
                 " qidx=%lu, qsize=%lu, listsize=%lu\n", 
                 (sm->sb_refresh)? "true":"false", ridx, bk_head, 
                 refresh_ucmd->LADDR, get_cmd_str(refresh_ucmd).c_str( ), 
-                qidx, ucmdq[qidx].size( ), reqlist.size( )); 
+                qidx, ucmdq[qidx].size( ), num_reqlist); 
             
             gen = true;
             break;
@@ -1140,12 +1583,6 @@ bool JedecEngine::reach_postpone_threshold(uint64_t rank, uint64_t bank)
 
 void JedecEngine::lp_handle( )
 {
-    /* Update stats before changing to the next state */
-    ncycle_t sync_cycles = 
-        (geq->getCurrentTick( )-last_updated_tick) / ticks_per_cycle;
-    last_updated_tick = geq->getCurrentTick( );
-    sm->update_stats(sync_cycles);
-
     /* 
      * Low-power operation handling 
      * A logic that checks idleness of a rank or ucmdqs
@@ -1203,6 +1640,7 @@ ncycle_t JedecEngine::lp_handle_pd( )
                 sm->is_issuable(powerup_pkt))
             {
                 ncycle_t latency = sm->update_states(powerup_pkt);
+                update_issuable(powerup_pkt);
                 schedule_postupdate(powerup_pkt);
                 media->recvRequest(powerup_pkt, latency);
                 pd_ranks[r] = false;
@@ -1233,6 +1671,7 @@ ncycle_t JedecEngine::lp_handle_pd( )
             if (is_rank_ucmdqs_empty(r) && sm->is_issuable(pd_pkt))
             {
                 ncycle_t latency = sm->update_states(pd_pkt);
+                update_issuable(pd_pkt);
                 schedule_postupdate(pd_pkt);
                 media->recvRequest(pd_pkt, latency);
                 pd_ranks[r] = true;
@@ -1266,6 +1705,7 @@ ncycle_t JedecEngine::lp_handle_sref( )
             if (is_rank_ucmdqs_empty(r)==false && sm->is_issuable(srx_pkt))
             {
                 ncycle_t latency = sm->update_states(srx_pkt);
+                update_issuable(srx_pkt);
                 schedule_postupdate(srx_pkt);
                 media->recvRequest(srx_pkt, latency);
                 sref_ranks[r] = false;
@@ -1286,6 +1726,7 @@ ncycle_t JedecEngine::lp_handle_sref( )
             if (is_rank_ucmdqs_empty(r) && sm->is_issuable(sre_pkt))
             {
                 ncycle_t latency = sm->update_states(sre_pkt);
+                update_issuable(sre_pkt);
                 schedule_postupdate(sre_pkt);
                 media->recvRequest(sre_pkt, latency);
                 sref_ranks[r] = true;
@@ -1352,6 +1793,11 @@ void JedecEngine::close_bank(uint64_t rank, uint64_t bank)
         }
     }
     assert(num_opened==1);
+
+    /* No request hits a closed bank */
+    uint64_t q = get_ucmdq_idx(rank, bank);
+    req_row_hits[q] = 0;
+    wr_row_hits[q] = 0;
 }
 
 void JedecEngine::close_bank(uint64_t rank, uint64_t bank, uint64_t part)
@@ -1359,6 +1805,10 @@ void JedecEngine::close_bank(uint64_t rank, uint64_t bank, uint64_t part)
     open_banks[rank][bank] = false;
     open_parts[rank][bank][part] = false;
     open_rows[rank][bank][part] = info->get_rowsPerMAT( );
+
+    uint64_t q = get_ucmdq_idx(rank, bank);
+    req_row_hits[q] = 0;
+    wr_row_hits[q] = 0;
 }
 
 uint64_t JedecEngine::get_ucmdq_idx(uint64_t rank, uint64_t bank)
@@ -1377,9 +1827,8 @@ uint64_t JedecEngine::get_ucmdq_idx(uint64_t rank, uint64_t bank)
 
 uint64_t JedecEngine::get_bank_idx(Packet* pkt)
 {
-    uint64_t bg = adec->decode_addr(pkt->PADDR, FLD_BANKGRP);
-    uint64_t bk = adec->decode_addr(pkt->PADDR, FLD_BANK);
-    return (bg * num_banks + bk);
+    const addr_coord_t& crd = adec->decode_pkt(pkt);
+    return (crd.fld[FLD_BANKGRP] * num_banks + crd.fld[FLD_BANK]);
 }
 
 Packet* JedecEngine::gen_ucmd(Packet* ref_pkt, cmd_t type)
@@ -1445,24 +1894,67 @@ void JedecEngine::register_stats( )
 
     ADD_STATS(cp_name, row_hits);
     ADD_STATS(cp_name, row_miss);
+    if (page_policy==ADAPTIVE_PAGE)
+    {
+        ADD_STATS(cp_name, page_preds);
+        ADD_STATS(cp_name, page_preds_correct);
+        ADD_STATS(cp_name, page_pred_closes);
+        ADD_STATS_LEVEL(cp_name, page_pred_accuracy);
+    }
     ADD_STATS(cp_name, req_reads);
     ADD_STATS(cp_name, req_writes);
-    ADD_STATS_N_UNIT(cp_name, max_issue_lat, "cycles");
-    ADD_STATS_N_UNIT(cp_name, min_issue_lat, "cycles");
-    ADD_STATS_N_UNIT(cp_name, avg_issue_lat, "cycles");
+    ADD_STATS_LAT(cp_name, max_issue_lat);
+    ADD_STATS_LAT(cp_name, min_issue_lat);
+    ADD_STATS_LAT(cp_name, avg_issue_lat);
+
+    memset(src_lat_sum, 0, num_srcs*sizeof(double));
+    memset(src_alone_sum, 0, num_srcs*sizeof(double));
+    memset(src_reqs, 0, num_srcs*sizeof(uint64_t));
+    memset(src_avg_lat, 0, num_srcs*sizeof(double));
+    memset(src_slowdown, 0, num_srcs*sizeof(double));
+    RESET_STATS(max_slowdown, df_init);
+    RESET_STATS(unfairness, df_init);
+    for (uint64_t i=0; i<num_srcs; i++)
+    {
+        ADD_STATS_ITER(cp_name, src_reqs, i);
+        ADD_STATS_ITER_LEVEL_UNIT(cp_name, src_avg_lat, i, "cycles");
+        ADD_STATS_ITER_LEVEL(cp_name, src_slowdown, i);
+    }
+    ADD_STATS_LEVEL(cp_name, max_slowdown);
+    ADD_STATS_LEVEL(cp_name, unfairness);
+
+    last_arrival_dir = -1;
+    last_cas_dir = -1;
+    int64_t i64_zero = 0;
+    RESET_STATS(arrival_rw_switches, u64_zero);
+    RESET_STATS(rw_switches, u64_zero);
+    RESET_STATS(turnarounds_avoided, i64_zero);
+    RESET_STATS(num_drains, u64_zero);
+    RESET_STATS(num_opp_drains, u64_zero);
+    RESET_STATS(raw_holds, u64_zero);
+    RESET_STATS(drain_cycles, u64_zero);
+    RESET_STATS(drain_residency, df_init);
+    ADD_STATS(cp_name, arrival_rw_switches);
+    ADD_STATS(cp_name, rw_switches);
+    ADD_STATS(cp_name, turnarounds_avoided);
+    if (use_write_drain)
+    {
+        ADD_STATS(cp_name, num_drains);
+        ADD_STATS(cp_name, num_opp_drains);
+        ADD_STATS(cp_name, raw_holds);
+        ADD_STATS_N_UNIT(cp_name, drain_cycles, "cycles");
+        ADD_STATS_LEVEL(cp_name, drain_residency);
+    }
+    register_qdepth_stats( );
 
     sm->register_stats( );
 }
 
 void JedecEngine::calculate_stats( )
 {
-    /* Update stats before changing to the next state */
-    ncycle_t sync_cycles = 
-        (geq->getCurrentTick( )-last_updated_tick) / ticks_per_cycle;
-    last_updated_tick = geq->getCurrentTick( );
-    sm->update_stats(sync_cycles);
-    
+    /* Residencies of state machines are synced on calculation */
     sm->calculate_stats( );
+    calculate_qdepth_stats( );
 
     if (num_issue>0)
     {
@@ -1470,6 +1962,43 @@ void JedecEngine::calculate_stats( )
         min_issue_lat /= ticks_per_cycle;
         avg_issue_lat /= ticks_per_cycle;
     }
+
+    if (page_preds>0)
+        page_pred_accuracy = (double)page_preds_correct / page_preds;
+
+    double min_slowdown = 0.0;
+    for (uint64_t i=0; i<num_srcs; i++)
+    {
+        if (src_reqs[i]==0 || src_alone_sum[i]==0.0)
+            continue;
+
+        src_avg_lat[i] = src_lat_sum[i] / src_reqs[i];
+        src_slowdown[i] = src_lat_sum[i] / src_alone_sum[i];
+
+        /* Fairness is among host threads (last one is of other sources) */
+        if (i==num_srcs-1)
+            continue;
+
+        if (src_slowdown[i]>max_slowdown)
+            max_slowdown = src_slowdown[i];
+        if (min_slowdown==0.0 || src_slowdown[i]<min_slowdown)
+            min_slowdown = src_slowdown[i];
+    }
+
+    if (min_slowdown>0.0)
+        unfairness = max_slowdown / min_slowdown;
+
+    turnarounds_avoided = (int64_t)arrival_rw_switches - (int64_t)rw_switches;
+    if (drain_mode)
+    {
+        /* Close the residency of on-going drain */
+        drain_cycles += 
+            (geq->getCurrentTick( )-drain_start_tick) / ticks_per_cycle;
+        drain_start_tick = geq->getCurrentTick( );
+    }
+    if (geq->getCurrentTick( )>0)
+        drain_residency = 
+            (double)drain_cycles / (geq->getCurrentTick( )/ticks_per_cycle);
 }
 
 void JedecEngine::print_stats(std::ostream& os)
@@ -1478,3 +2007,15 @@ void JedecEngine::print_stats(std::ostream& os)
     stats->print(os);
 }
 
+void JedecEngine::sync_stats( )
+{
+    uCMDEngine::sync_stats( );
+    sm->sync_stats( );
+}
+
+void JedecEngine::collect_stats(std::vector<Stats*>& slist)
+{
+    sm->collect_stats(slist);
+    slist.push_back(stats);
+}
+
@@ -54,6 +54,7 @@ namespace PCMCsim
         Component* master=NULL;
 
         bool isReady(Packet* pkt) override;
+        uint64_t get_num_reqs( ) override;
         void recvRequest(Packet* pkt, ncycle_t delay=1) override;
         void recvResponse(Packet* pkt, ncycle_t delay=1) override;
 
@@ -90,6 +91,7 @@ namespace PCMCsim
         {
             CLOSED_PAGE = 0,
             OPEN_PAGE,
+            ADAPTIVE_PAGE,      // open or close by row-hit predictor
             NUM_POLICIES
         };
 
@@ -111,11 +113,63 @@ namespace PCMCsim
         bool decouple_datapath; // a separate datapath
 
         /* Input-side of the engine: reqlist->ucmdq */
+        typedef struct _req_entry_t
+        {
+            Packet* pkt;
+            uint64_t seq;   // arrival order across all sub-lists
+            uint64_t rank;
+            uint64_t bank;
+            uint64_t part;
+            uint64_t row;
+            uint64_t src;   // source (thread) index
+            bool marked;    // marked in current batch (PAR-BS)
+        } req_entry_t;
+
+        enum _find_conds
+        {
+            FIND_STARVED = 0,
+            FIND_ROW_HIT,
+            FIND_OPEN_BANK,
+            FIND_CLOSED_BANK,
+            NUM_FIND_CONDS
+        };
+
+        typedef std::vector<std::list<req_entry_t>> reqlist_t;
+
         uint64_t size_reqlist;
-        std::list<Packet*> reqlist;         // input request list
+        uint64_t num_reqlist;               // requests over all sub-lists
+        uint64_t seq_reqlist;
+        reqlist_t reqlist;                  // per-ucmdq request list
         ncycle_t wake_reqlist;
         ncycle_t last_wake_reqlist;
 
+        /* Write drain: writes are buffered separately and drained in batch */
+        bool use_write_drain;
+        bool drain_mode;                    // schedule from wrlist
+        bool drain_forced;                  // drain by high watermark
+        reqlist_t wrlist;                   // per-ucmdq write list
+        uint64_t num_wrlist;
+        uint64_t wr_high_watermark;
+        uint64_t wr_low_watermark;
+        ncycle_t drain_start_tick;
+
+        /* Reads held until a buffered write to the same address is issued */
+        reqlist_t rawlist;                  // per-ucmdq held read list
+        uint64_t num_rawlist;
+
+        reqlist_t& get_sched_list( ) { return (drain_mode)? wrlist : reqlist; }
+
+        /* Row-hit index: requests of each sub-list to the open row */
+        std::vector<uint64_t> req_row_hits;
+        std::vector<uint64_t> wr_row_hits;
+
+        std::vector<uint64_t>& get_sched_row_hits( ) 
+        { return (drain_mode)? wr_row_hits : req_row_hits; }
+        void index_row_hits(uint64_t rank, uint64_t bank);
+        void update_drain_mode( );
+        bool is_raw_hazard(uint64_t q, Packet* pkt);
+        void release_raw(uint64_t q, uint64_t addr);
+
         virtual void cycle_reqlist( );      // just for event scheduling
 
         /* Scheduler */
@@ -125,6 +179,19 @@ namespace PCMCsim
         vec3u64_t cntr_starv;
         uint64_t th_starv;
 
+        /* Per-bank row-hit predictor for adaptive page policy */
+        vec2u64_t hist_parts;   // last accessed partition
+        vec2u64_t hist_rows;    // last accessed row (num_rows if none)
+        vec2u64_t pred_cntrs;   // saturating counter (trained by hits)
+        vec2b_t pred_open;      // last prediction (keep row open)
+        uint64_t pred_max;
+        uint64_t pred_th;
+
+        bool predict_row_hit(uint64_t rank, uint64_t bank, 
+                             uint64_t part, uint64_t row);
+        bool is_row_queued(uint64_t rank, uint64_t bank, 
+                           uint64_t part, uint64_t row);
+
         bool is_req_schedulable(uint64_t ucmdq_idx);
         bool is_just_arrived(Packet* pkt);
         bool is_ucmdq_empty(uint64_t qidx);
@@ -145,6 +212,22 @@ namespace PCMCsim
         bool find_row_hit(Packet*& found_req);
         bool find_open_bank(Packet*& found_req);
         bool find_closed_bank(Packet*& found_req);
+        bool find_req(Packet*& found_req, int cond);
+        void push_reqlist(Packet* pkt);
+        void pop_reqlist(uint64_t q, std::list<req_entry_t>::iterator it);
+
+        /* Priority-based selection for child-scheduler classes */
+        virtual bool is_prior(req_entry_t& lhs, req_entry_t& rhs);
+        bool find_prior(req_entry_t& found_entry);
+        bool is_row_hit(req_entry_t& entry);
+
+        /* Source (thread) tracking for fairness-aware schedulers */
+        uint64_t num_srcs;  // host threads + 1 (non-host or untagged reqs)
+
+        uint64_t get_src_idx(Packet* pkt);
+        ncycle_t get_service_est(uint64_t rank, uint64_t bank, 
+                                 uint64_t part, uint64_t row, cmd_t cmd);
+        ncycle_t get_service_est(req_entry_t& entry);
 
         /* Output-side of the engine: ucmdq->media */
         StateMachine* sm;
@@ -154,8 +237,21 @@ namespace PCMCsim
         ncycle_t last_wake_ucmdq;
         uint64_t ucmdq_ptr;
 
+        /* Incremental tracking of non-empty ucmdqs and their heads */
+        std::vector<uint64_t> ucmdq_bitmap;     // 1 bit per non-empty ucmdq
+        std::vector<uint64_t> ucmdq_rank;       // ucmdq index -> rank
+        std::vector<uint64_t> rank_busy_ucmdqs; // non-empty ucmdqs per rank
+        uint64_t ucmdq_busy;                    // non-empty ucmdqs in total
+        std::vector<ncycle_t> issuable_tree;    // min-tournament tree of heads
+        uint64_t num_tree_leaves;
+
         void cycle_ucmdq( );
         void update_ucmdq_ptr(uint64_t curr_idx);
+        void push_ucmdq(uint64_t qidx, Packet* pkt);
+        void pop_ucmdq(uint64_t qidx);
+        uint64_t find_ucmdq(uint64_t from);
+        void update_issuable(uint64_t qidx);
+        void update_issuable(Packet* pkt);  // heads constrained by issued pkt
 
         /* Refresh-related part */
         vec2b_t refresh_needed;         // need refresh but ucmd is not generated
@@ -218,9 +314,12 @@ namespace PCMCsim
         uint64_t deadlock_timer;
 
         /* Stats */
-        ncycle_t last_updated_tick;
         uint64_t row_hits=0;
         uint64_t row_miss=0;
+        uint64_t page_preds=0;
+        uint64_t page_preds_correct=0;
+        uint64_t page_pred_closes=0;
+        double page_pred_accuracy=0.0;
         uint64_t req_reads=0;
         uint64_t req_writes=0;
 
@@ -229,9 +328,30 @@ namespace PCMCsim
         double avg_issue_lat;
         uint64_t num_issue;
 
+        double* src_lat_sum;    // shared latency of each source
+        double* src_alone_sum;  // estimated latency if running alone
+        uint64_t* src_reqs;
+        double* src_avg_lat;
+        double* src_slowdown;
+        double max_slowdown;
+        double unfairness;      // max/min slowdown
+
+        int last_arrival_dir;   // -1: none, 0: read, 1: write
+        int last_cas_dir;
+        uint64_t arrival_rw_switches;   // turnarounds in arrival order
+        uint64_t rw_switches;           // turnarounds actually issued
+        int64_t turnarounds_avoided;
+        uint64_t num_drains;
+        uint64_t num_opp_drains;        // drains when no read is pending
+        uint64_t raw_holds;             // reads held behind a buffered write
+        ncycle_t drain_cycles;
+        double drain_residency;
+
         void register_stats( ) override;
         void calculate_stats( ) override;
+        void sync_stats( ) override;
         void print_stats(std::ostream& os) override;
+        void collect_stats(std::vector<Stats*>& slist) override;
     };
 };
 
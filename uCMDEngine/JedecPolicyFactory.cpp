@@ -3,6 +3,9 @@
 #include "uCMDEngine/JedecPolicyFactory.h"
 #include "uCMDEngine/FCFS.h"
 #include "uCMDEngine/FRFCFS.h"
+#include "uCMDEngine/BLISS.h"
+#include "uCMDEngine/PARBS.h"
+#include "uCMDEngine/ATLAS.h"
 
 using namespace PCMCsim;
 
@@ -15,6 +18,12 @@ uCMDEngine* JedecPolicyFactory::create_engine_policy(std::string policy,
         rv = new FCFS(memsys_, adec_, info_, cfg_header, ticks_per_cycle_, id_);
     else if (policy=="FRFCFS")
         rv = new FRFCFS(memsys_, adec_, info_, cfg_header, ticks_per_cycle_, id_);
+    else if (policy=="BLISS")
+        rv = new BLISS(memsys_, adec_, info_, cfg_header, ticks_per_cycle_, id_);
+    else if (policy=="PARBS")
+        rv = new PARBS(memsys_, adec_, info_, cfg_header, ticks_per_cycle_, id_);
+    else if (policy=="ATLAS")
+        rv = new ATLAS(memsys_, adec_, info_, cfg_header, ticks_per_cycle_, id_);
     else
     {
         std::cerr << "[JedecPolicyFactory] Error! Invalid policy is specified!" 
@@ -37,6 +46,12 @@ uCMDEngine* JedecPolicyFactory::create_engine_policy(
         rv = new FCFS(memsys_, adec_, info_, cfg_header, ticks_per_cycle_, id_);
     else if (policy=="FRFCFS")
         rv = new FRFCFS(memsys_, adec_, info_, cfg_header, ticks_per_cycle_, id_);
+    else if (policy=="BLISS")
+        rv = new BLISS(memsys_, adec_, info_, cfg_header, ticks_per_cycle_, id_);
+    else if (policy=="PARBS")
+        rv = new PARBS(memsys_, adec_, info_, cfg_header, ticks_per_cycle_, id_);
+    else if (policy=="ATLAS")
+        rv = new ATLAS(memsys_, adec_, info_, cfg_header, ticks_per_cycle_, id_);
     else
     {
         std::cerr << "[JedecPolicyFactory] Error! Invalid policy is specified!" 
@@ -0,0 +1,115 @@
+#include "base/MemoryControlSystem.h"
+#include "base/Packet.h"
+#include "base/Stats.h"
+#include "uCMDEngine/PARBS.h"
+
+#include <algorithm>
+
+using namespace PCMCsim;
+
+PARBS::PARBS(MemoryControlSystem* memsys_, AddressDecoder* adec_,
+    MemInfo* info_, std::string cfg_header, ncycle_t ticks_per_cycle_, uint64_t id_)
+:JedecEngine(memsys_, adec_, info_, cfg_header, ticks_per_cycle_, id_),
+num_marked(0)
+{
+    marking_cap = memsys->getParamUINT64(cp_name+".PARBS.marking_cap", 5);
+    src_rank.resize(num_srcs, 0);
+
+    num_batches = 0;
+    num_marked_reqs = 0;
+    ADD_STATS(cp_name, num_batches);
+    ADD_STATS(cp_name, num_marked_reqs);
+}
+
+void PARBS::cycle_reqlist( )
+{
+    /* 
+     * New batch is formed once all marked requests are served
+     * (writes buffered by write drain and held reads are never marked)
+     */
+    if (num_marked==0 && num_reqlist>num_wrlist+num_rawlist)
+        form_batch( );
+
+    req_entry_t found;
+    if (find_prior(found))
+    {
+        if (found.marked)
+        {
+            assert(num_marked>0);
+            num_marked -= 1;
+        }
+
+        insert_ucmdq(found.pkt);
+    }
+
+    JedecEngine::cycle_reqlist( );
+}
+
+void PARBS::form_batch( )
+{
+    /* Mark up to marking_cap oldest requests of each source in each bank */
+    std::vector<uint64_t> max_load(num_srcs, 0);
+    std::vector<uint64_t> total_load(num_srcs, 0);
+    std::vector<uint64_t> bank_load(num_srcs);
+    for (uint64_t q=0; q<num_ucmdq; q++)
+    {
+        if (reqlist[q].empty( ))
+            continue;
+
+        std::fill(bank_load.begin( ), bank_load.end( ), 0);
+        std::list<req_entry_t>::iterator l_it = reqlist[q].begin( );
+        for ( ; l_it!=reqlist[q].end( ); l_it++)
+        {
+            if (bank_load[l_it->src]>=marking_cap)
+                continue;
+
+            l_it->marked = true;
+            bank_load[l_it->src] += 1;
+            num_marked += 1;
+        }
+
+        for (uint64_t s=0; s<num_srcs; s++)
+        {
+            max_load[s] = std::max(max_load[s], bank_load[s]);
+            total_load[s] += bank_load[s];
+        }
+    }
+
+    /* Rank sources: lower max-bank-load, then lower total-load first */
+    std::vector<uint64_t> order(num_srcs);
+    for (uint64_t s=0; s<num_srcs; s++)
+        order[s] = s;
+
+    std::stable_sort(order.begin( ), order.end( ), 
+        [&](uint64_t a, uint64_t b) {
+            if (max_load[a]!=max_load[b])
+                return (max_load[a]<max_load[b]);
+            return (total_load[a]<total_load[b]);
+        });
+
+    for (uint64_t r=0; r<num_srcs; r++)
+        src_rank[order[r]] = r;
+
+    num_batches += 1;
+    num_marked_reqs += num_marked;
+
+    PCMC_DBG(dbg_msg, "[PARBS] Form batch #%lu with %lu marked reqs\n", 
+        num_batches, num_marked);
+}
+
+bool PARBS::is_prior(req_entry_t& lhs, req_entry_t& rhs)
+{
+    /* Marked first, row-hit first, higher-ranked first, then older first */
+    if (lhs.marked!=rhs.marked)
+        return lhs.marked;
+
+    bool lhs_hit = is_row_hit(lhs);
+    bool rhs_hit = is_row_hit(rhs);
+    if (lhs_hit!=rhs_hit)
+        return lhs_hit;
+
+    if (src_rank[lhs.src]!=src_rank[rhs.src])
+        return (src_rank[lhs.src]<src_rank[rhs.src]);
+
+    return (lhs.seq<rhs.seq);
+}
@@ -0,0 +1,647 @@
+#include "base/MemoryControlSystem.h"
+#include "base/EventQueue.h"
+#include "base/Packet.h"
+#include "base/Stats.h"
+#include "base/MemInfo.h"
+#include "base/ReqTracer.h"
+#include "uCMDEngine/PCMEngine.h"
+
+using namespace PCMCsim;
+
+#define PRIORITY_CYCLE_REQL     40
+
+#define MAX std::max
+#define MIN std::min
+
+PCMEngine::PCMEngine(MemoryControlSystem* memsys_, AddressDecoder* adec_,
+    MemInfo* info_, std::string cfg_header, ncycle_t ticks_per_cycle_, uint64_t id_)
+:uCMDEngine(memsys_), adec(adec_), info(info_), wake_reqlist(0),
+cmd_free(0), bus_free(0), last_rank(0)
+{
+    id = id_;
+    cp_name = cfg_header + "[" + std::to_string(id) + "]";
+    dbg_msg = memsys->getParamBOOL(cp_name+".dbg_msg", false);
+    if (ticks_per_cycle_==0)
+        ticks_per_cycle= memsys->getParamUINT64(cp_name+".ticks_per_cycle", 1);
+    else
+        ticks_per_cycle = ticks_per_cycle_;
+
+    deadlock_timer = memsys->getParamUINT64(cp_name+".deadlock_timer", 1000000000);
+
+    std::string read_str = memsys->getParamSTR(cp_name+".policy", "FRFCFS");
+    if (read_str=="FCFS")
+        policy = POLICY_FCFS;
+    else if (read_str=="FRFCFS")
+        policy = POLICY_FRFCFS;
+    else
+    {
+        std::cerr << "[PCMEngine] Error! Invalid policy is specified!"
+            << std::endl;
+        assert(0);
+        exit(1);
+    }
+
+    read_str = memsys->getParamSTR(cp_name+".write_scheme", "SERIAL");
+    if (read_str=="SERIAL")
+        write_scheme = SERIAL;
+    else if (read_str=="PARALLEL")
+        write_scheme = PARALLEL;
+    else
+    {
+        std::cerr << "[PCMEngine] Error! Invalid write scheme is specified!"
+            << std::endl;
+        assert(0);
+        exit(1);
+    }
+
+    size_reqlist = memsys->getParamUINT64(cp_name+".size_reqlist", 64);
+    th_starv = memsys->getParamUINT64(cp_name+".threshold_starvation", 4);
+
+    /* Timing parameters */
+    tCMD = memsys->getParamUINT64(cp_name+".tCMD", 1);
+    tRD = memsys->getParamUINT64(cp_name+".tRD", 133);
+    tCWL = memsys->getParamUINT64(cp_name+".tCWL", 18);
+    tBURST = memsys->getParamUINT64(cp_name+".tBURST", 4);
+    tRTRS = memsys->getParamUINT64(cp_name+".tRTRS", 1);
+    tRESET = memsys->getParamUINT64(cp_name+".tRESET", 67);
+    tSET = memsys->getParamUINT64(cp_name+".tSET", 200);
+    tPROG = (write_scheme==SERIAL)? (tRESET+tSET) : MAX(tRESET, tSET);
+
+    eRD = memsys->getParamFLOAT(cp_name+".eRD", 0.0);
+    eRESET = memsys->getParamFLOAT(cp_name+".eRESET", 0.0);
+    eSET = memsys->getParamFLOAT(cp_name+".eSET", 0.0);
+
+    /* Setup partitions of all banks */
+    num_ranks = info->get_ranks( );
+    num_all_banks = info->get_bankgroups( ) * info->get_banks( );
+    num_parts = info->get_partitions( ) * ((info->is_half_bank( ))? 2:1);
+    writes_per_bank = memsys->getParamUINT64(cp_name+".writes_per_bank", 1);
+    if (writes_per_bank==0 || writes_per_bank>num_parts)
+    {
+        std::cerr << "[PCMEngine] Error! Concurrent writes per bank must be "
+            << "within [1, " << num_parts << "]!" << std::endl;
+        assert(0);
+        exit(1);
+    }
+
+    part_free.resize(num_ranks*num_all_banks*num_parts, 0);
+    bank_wr_free.resize(num_ranks*num_all_banks);
+    for (uint64_t b=0; b<bank_wr_free.size( ); b++)
+        bank_wr_free[b].resize(writes_per_bank, 0);
+
+    /* Write cancellation and pausing */
+    use_cancel = memsys->getParamBOOL(cp_name+".write_cancel", false);
+    th_cancel = memsys->getParamFLOAT(cp_name+".write_cancel.threshold", 0.75);
+    max_cancels = memsys->getParamUINT64(cp_name+".write_cancel.max", 2);
+    use_pause = memsys->getParamBOOL(cp_name+".write_pause", false);
+    max_pauses = memsys->getParamUINT64(cp_name+".write_pause.max", 4);
+    uint64_t num_iters = 
+        memsys->getParamUINT64(cp_name+".write_pause.iterations", 4);
+    if (num_iters==0 || num_iters>tPROG || th_cancel<0.0 || th_cancel>1.0)
+    {
+        std::cerr << "[PCMEngine] Error! Invalid parameters of write "
+            << "cancellation or pausing!" << std::endl;
+        assert(0);
+        exit(1);
+    }
+    tITER = tPROG/num_iters;
+
+    prog_t init_prog;
+    memset(&init_prog, 0, sizeof(prog_t));
+    progs.resize(part_free.size( ), init_prog);
+
+    register_stats( );
+}
+
+PCMEngine::~PCMEngine( )
+{
+    for (uint64_t p=0; p<progs.size( ); p++)
+        delete progs[p].pkt;
+}
+
+bool PCMEngine::isReady(Packet* /*pkt*/)
+{
+    bool rv = true;
+    if (get_num_reqs( )>=size_reqlist)
+        rv = false;
+    return rv;
+}
+
+uint64_t PCMEngine::get_num_reqs( )
+{
+    return reqlist.size( )+req_events.size( )+await_req.size( );
+}
+
+void PCMEngine::recvRequest(Packet* pkt, ncycle_t delay)
+{
+    assert(isReady(pkt));
+
+    pkt->recvTick = geq->getCurrentTick( )+delay*ticks_per_cycle;
+    pkt->recvTick_ucmde = geq->getCurrentTick( )+delay*ticks_per_cycle;
+    PCMC_TRACE(pkt, TRC_UCMDE, pkt->recvTick);
+    Component::recvRequest(pkt, delay);
+
+    /* Update Stats */
+    if (pkt->cmd==CMD_READ)
+        req_reads += 1;
+    else
+        req_writes += 1;
+}
+
+void PCMEngine::handle_events(ncycle_t curr_tick)
+{
+    /* Get events from queue */
+    prepare_events(curr_tick);
+
+    /* Don't change following order */
+    if (!await_req.empty( ))
+        handle_await_reqs( );
+
+    if (!await_cb.empty( ))
+        handle_await_callbacks( );
+}
+
+void PCMEngine::handle_await_reqs( )
+{
+    std::list<LocalEvent*>::iterator e_it = await_req.begin( );
+    for ( ; e_it!=await_req.end( ); )
+    {
+        Packet* pkt = (*e_it)->pkt;
+        assert(pkt->cmd==CMD_READ || pkt->cmd==CMD_WRITE);
+
+        /* Decode coordinates once when a request enters the list */
+        const addr_coord_t& crd = adec->decode_pkt(pkt);
+        req_entry_t entry;
+        entry.pkt = pkt;
+        entry.rank = crd.fld[FLD_RANK];
+        entry.bank = crd.fld[FLD_BANKGRP] * info->get_banks( ) +
+                     crd.fld[FLD_BANK];
+        entry.part = crd.fld[FLD_HALF] * info->get_partitions( ) +
+                     crd.fld[FLD_PART];
+        entry.bypassed = 0;
+        entry.part_stalled = false;
+        entry.wr_stalled = false;
+        entry.reissue = false;
+        entry.cancels = 0;
+        reqlist.push_back(entry);
+        update_qdepth(reqlist.size( ));
+
+        PCMC_DBG(dbg_msg, "[PE] Push req [0x%lx, ID=%lx, CMD=%s](%p)"
+            " in request list (size=%lu/%lu)\n", pkt->LADDR, pkt->req_id,
+            get_cmd_str(pkt).c_str( ), pkt, reqlist.size( ), size_reqlist);
+
+        /* Free event */
+        delete (*e_it);
+        e_it = await_req.erase(e_it);
+    }
+
+    schedule_reqlist(geq->getCurrentTick( )+1*ticks_per_cycle);
+}
+
+void PCMEngine::schedule_reqlist(ncycle_t wakeup)
+{
+    /* Keep a pending wakeup if it comes no later than the new one */
+    if (wake_reqlist>geq->getCurrentTick( ) && wake_reqlist<=wakeup)
+        return;
+
+    wake_reqlist = wakeup;
+    registerCallbackAt((CallbackPtr)&PCMEngine::cycle_reqlist,
+        wake_reqlist, PRIORITY_CYCLE_REQL);
+}
+
+void PCMEngine::cycle_reqlist( )
+{
+    /* Superseded by an earlier wakeup */
+    if (geq->getCurrentTick( )!=wake_reqlist || reqlist.empty( ))
+        return;
+
+    std::list<req_entry_t>::iterator found;
+    ncycle_t next_tick = std::numeric_limits<uint64_t>::max( );
+    bool issued = false;
+    if (policy==POLICY_FRFCFS && reqlist.front( ).bypassed<th_starv)
+    {
+        /* Reads first, then writes (reads are never blocked by writes) */
+        issued = find_req(found, next_tick, true);
+        if (issued==false)
+            issued = find_req(found, next_tick, false);
+    }
+    else
+        issued = find_req(found, next_tick, false);
+
+    if (issued)
+    {
+        if (found!=reqlist.begin( ))
+        {
+            reqlist.front( ).bypassed += 1;
+            if (reqlist.front( ).bypassed==th_starv)
+                starved_reqs += 1;
+        }
+
+        issue(found);
+        reqlist.erase(found);
+        update_qdepth(reqlist.size( ));
+        next_tick = geq->getCurrentTick( )+MAX(tCMD, (ncycle_t)1)*ticks_per_cycle;
+    }
+    else
+    {
+        /* Requests are not issuable in this cycle */
+        Packet* pkt = reqlist.front( ).pkt;
+        ncycle_t stalled_duration = geq->getCurrentTick( )-pkt->recvTick_ucmde;
+        if (stalled_duration>=deadlock_timer)
+        {
+            PCMC_DBG(dbg_msg, "[PE] Deadlock occurs! "
+                "in-tick=%lu, stall-duration=%lu, Req[0x%lx, "
+                "ID=%lx, CMD=%s]\n", pkt->recvTick_ucmde,
+                stalled_duration, pkt->LADDR, pkt->req_id,
+                get_cmd_str(pkt).c_str( ));
+            assert(0);
+            exit(1);
+        }
+    }
+
+    /* Self schedule */
+    if (reqlist.empty( )==false)
+    {
+        assert(next_tick>geq->getCurrentTick( ));
+        schedule_reqlist(next_tick);
+    }
+}
+
+bool PCMEngine::find_req(std::list<req_entry_t>::iterator& found,
+                         ncycle_t& next_tick, bool reads_only)
+{
+    /* Requests to the same partition are served in arrival order */
+    ncycle_t curr_tick = geq->getCurrentTick( );
+    std::set<uint64_t> blocked_parts;
+    std::list<req_entry_t>::iterator it = reqlist.begin( );
+    for ( ; it!=reqlist.end( ); it++)
+    {
+        uint64_t part_idx = get_part_idx(it->rank, it->bank, it->part);
+        if (blocked_parts.find(part_idx)!=blocked_parts.end( ))
+            continue;
+        blocked_parts.insert(part_idx);
+
+        if (reads_only && it->pkt->cmd==CMD_WRITE)
+            continue;
+
+        ncycle_t issue_tick = get_issue_tick(*it);
+        if (it->pkt->cmd==CMD_WRITE && it->reissue==false)
+        {
+            /* Write data must have arrived at DPU */
+            it->pkt->from = this; // for identification in DPU
+            if (dpu->isReady(it->pkt)==false)
+                issue_tick = MAX(issue_tick, curr_tick+1*ticks_per_cycle);
+        }
+
+        if (issue_tick<=curr_tick)
+        {
+            found = it;
+            return true;
+        }
+        next_tick = MIN(next_tick, issue_tick);
+    }
+    return false;
+}
+
+ncycle_t PCMEngine::get_issue_tick(req_entry_t& entry)
+{
+    ncycle_t curr_tick = geq->getCurrentTick( );
+    ncycle_t rv = MAX(curr_tick, cmd_free);
+    uint64_t part_idx = get_part_idx(entry.rank, entry.bank, entry.part);
+
+    /* Partition is sensing or programming (reads may preempt a program) */
+    ncycle_t part_tick = part_free[part_idx];
+    if (entry.pkt->cmd==CMD_READ && (use_cancel || use_pause))
+    {
+        int type = PREEMPT_NONE;
+        part_tick = get_preempt_tick(part_idx, type);
+    }
+    if (part_tick>curr_tick)
+        entry.part_stalled = true;
+    rv = MAX(rv, part_tick);
+
+    /* Data bus should be free when data is on it */
+    ncycle_t bus_tick = bus_free;
+    if (entry.rank!=last_rank)
+        bus_tick += tRTRS*ticks_per_cycle;
+
+    ncycle_t data_lat = (entry.pkt->cmd==CMD_READ)? tRD : tCWL;
+    if (bus_tick>data_lat*ticks_per_cycle)
+        rv = MAX(rv, bus_tick-data_lat*ticks_per_cycle);
+
+    if (entry.pkt->cmd==CMD_WRITE)
+    {
+        /* Programming starts after data-in if a write slot is free */
+        ncycle_t prog_lat = (tCWL+tBURST)*ticks_per_cycle;
+        ncycle_t slot_tick = get_free_slot(get_bank_idx(entry.rank, entry.bank));
+        if (slot_tick>curr_tick+prog_lat)
+            entry.wr_stalled = true;
+        if (slot_tick>prog_lat)
+            rv = MAX(rv, slot_tick-prog_lat);
+    }
+
+    return rv;
+}
+
+ncycle_t PCMEngine::get_preempt_tick(uint64_t part_idx, int& type)
+{
+    ncycle_t curr_tick = geq->getCurrentTick( );
+    prog_t& prog = progs[part_idx];
+    type = PREEMPT_NONE;
+    if (prog.active==false || prog.end<=curr_tick)
+        return part_free[part_idx];
+
+    /* Program can be preempted once it starts (after data-in) */
+    ncycle_t from = MAX(curr_tick, prog.start);
+    ncycle_t full = tPROG*ticks_per_cycle;
+    ncycle_t elapsed = full-(prog.end-from);
+    if (use_cancel && prog.cancels<max_cancels &&
+        (double)elapsed/full<th_cancel)
+    {
+        type = PREEMPT_CANCEL;
+        return from;
+    }
+
+    if (use_pause && prog.pauses<max_pauses)
+    {
+        /* Suspend at the next boundary of program-and-verify iterations */
+        ncycle_t iter = tITER*ticks_per_cycle;
+        ncycle_t boundary = (elapsed+iter-1)/iter*iter;
+        if (boundary<full)
+        {
+            type = PREEMPT_PAUSE;
+            return from+(boundary-elapsed);
+        }
+    }
+    return part_free[part_idx];
+}
+
+void PCMEngine::preempt(std::list<req_entry_t>::iterator it, 
+                        uint64_t part_idx, int type)
+{
+    ncycle_t curr_tick = geq->getCurrentTick( );
+    uint64_t bank_idx = get_bank_idx(it->rank, it->bank);
+    prog_t& prog = progs[part_idx];
+    assert(prog.active && curr_tick>=prog.start && curr_tick<prog.end);
+
+    preempt_reads += 1;
+    read_lat_saved += (prog.end-curr_tick)/ticks_per_cycle;
+
+    if (type==PREEMPT_CANCEL)
+    {
+        /* Abort and re-issue the write right after the read */
+        req_entry_t entry = *it;
+        entry.pkt = prog.pkt;
+        entry.pkt->cmd = CMD_WRITE;
+        entry.bypassed = 0;
+        entry.part_stalled = false;
+        entry.wr_stalled = false;
+        entry.reissue = true;
+        entry.cancels = prog.cancels+1;
+        reqlist.insert(std::next(it), entry);
+        update_qdepth(reqlist.size( ));
+
+        wasted_prog_cycles += 
+            (tPROG*ticks_per_cycle-(prog.end-curr_tick))/ticks_per_cycle;
+
+        /* Only the programmed part is consumed, re-issue charges a full one */
+        energy_write -= (eRESET+eSET) * 
+            (double)(prog.end-curr_tick)/(tPROG*ticks_per_cycle);
+        bank_wr_free[bank_idx][prog.slot] = curr_tick;
+        prog.active = false;
+        prog.pkt = NULL;
+        write_cancels += 1;
+
+        PCMC_DBG(dbg_msg, "[PE] Cancel write [0x%lx, ID=%lx] for a read "
+            "to part=%lu\n", entry.pkt->LADDR, entry.pkt->req_id, it->part);
+    }
+    else
+    {
+        /* Resume the remaining iterations after sensing */
+        assert(type==PREEMPT_PAUSE);
+        ncycle_t remaining = prog.end-curr_tick;
+        prog.start = curr_tick+tRD*ticks_per_cycle;
+        prog.end = prog.start+remaining;
+        prog.pauses += 1;
+        bank_wr_free[bank_idx][prog.slot] = prog.end;
+        write_pauses += 1;
+
+        if (use_cancel)
+        {
+            registerCallbackAt((CallbackPtr)&PCMEngine::finish_prog,
+                prog.end, PRIORITY_CYCLE_REQL, reinterpret_cast<void*>(&prog));
+        }
+    }
+}
+
+void PCMEngine::finish_prog(void* prog)
+{
+    /* Stale callbacks of paused or cancelled programs are ignored */
+    prog_t* p = reinterpret_cast<prog_t*>(prog);
+    if (p->active==false || p->end>geq->getCurrentTick( ))
+        return;
+
+    /* Retire write data retained in DPU for re-issue */
+    p->pkt->cmd = CMD_WACK_ID;
+    p->pkt->from = this;
+    dpu->recvRequest(p->pkt);
+    delete p->pkt;
+    p->pkt = NULL;
+    p->active = false;
+}
+
+ncycle_t PCMEngine::get_free_slot(uint64_t bank_idx)
+{
+    ncycle_t rv = bank_wr_free[bank_idx][0];
+    for (uint64_t s=1; s<writes_per_bank; s++)
+        rv = MIN(rv, bank_wr_free[bank_idx][s]);
+    return rv;
+}
+
+void PCMEngine::issue(std::list<req_entry_t>::iterator it)
+{
+    ncycle_t curr_tick = geq->getCurrentTick( );
+    Packet* pkt = it->pkt;
+    uint64_t bank_idx = get_bank_idx(it->rank, it->bank);
+    uint64_t part_idx = get_part_idx(it->rank, it->bank, it->part);
+    ncycle_t latency = 0;
+
+    if (pkt->cmd==CMD_READ)
+    {
+        /* Cancel or pause a write programming the partition */
+        int type = PREEMPT_NONE;
+        if (use_cancel || use_pause)
+        {
+            get_preempt_tick(part_idx, type);
+            if (type!=PREEMPT_NONE)
+                preempt(it, part_idx, type);
+        }
+
+        /* Any other partition of the bank is being programmed */
+        for (uint64_t s=0; s<writes_per_bank; s++)
+        {
+            if (bank_wr_free[bank_idx][s]>curr_tick)
+            {
+                reads_under_write += 1;
+                break;
+            }
+        }
+
+        latency = tRD+tBURST;
+        part_free[part_idx] = curr_tick+tRD*ticks_per_cycle;
+        if (type==PREEMPT_PAUSE)
+            part_free[part_idx] = progs[part_idx].end;
+        bus_free = curr_tick+latency*ticks_per_cycle;
+        energy_read += eRD;
+    }
+    else
+    {
+        /* Occupy the earliest free write slot of the bank */
+        uint64_t slot = 0;
+        for (uint64_t s=1; s<writes_per_bank; s++)
+        {
+            if (bank_wr_free[bank_idx][s]<bank_wr_free[bank_idx][slot])
+                slot = s;
+        }
+
+        latency = tCWL+tBURST+tPROG;
+        bus_free = curr_tick+(tCWL+tBURST)*ticks_per_cycle;
+        part_free[part_idx] = curr_tick+latency*ticks_per_cycle;
+        bank_wr_free[bank_idx][slot] = part_free[part_idx];
+        energy_write += eRESET+eSET;
+
+        /* Track the program for preemption by reads */
+        prog_t& prog = progs[part_idx];
+        if (prog.pkt!=NULL)
+            finish_prog(&prog); // retire the previous one in the same tick
+        assert(prog.pkt==NULL);
+        prog.active = true;
+        prog.slot = slot;
+        prog.start = bus_free;
+        prog.end = part_free[part_idx];
+        prog.pauses = 0;
+        prog.cancels = it->cancels;
+        if (use_cancel)
+        {
+            if (it->reissue)
+                prog.pkt = pkt;
+            else
+            {
+                prog.pkt = new Packet( );
+                *(prog.pkt) = *pkt;
+                prog.pkt->owner = this;
+            }
+            registerCallbackAt((CallbackPtr)&PCMEngine::finish_prog,
+                prog.end, PRIORITY_CYCLE_REQL, reinterpret_cast<void*>(&prog));
+        }
+    }
+
+    if (it->reissue)
+    {
+        /* Data retained in DPU is programmed again, not a new issue in stats */
+        PCMC_DBG(dbg_msg, "[PE] Re-issue cancelled write [0x%lx, ID=%lx] to "
+            "rank=%lu, bank=%lu, part=%lu\n", pkt->LADDR, pkt->req_id,
+            it->rank, it->bank, it->part);
+
+        cmd_free = curr_tick+tCMD*ticks_per_cycle;
+        last_rank = it->rank;
+        pkt->from = this;
+        dpu->recvRequest(pkt);
+        return;
+    }
+    cmd_free = curr_tick+tCMD*ticks_per_cycle;
+    last_rank = it->rank;
+
+    PCMC_DBG(dbg_msg, "[PE] Issue req [0x%lx, ID=%lx, CMD=%s] to "
+        "rank=%lu, bank=%lu, part=%lu (lat=%lu)\n", pkt->LADDR, pkt->req_id,
+        get_cmd_str(pkt).c_str( ), it->rank, it->bank, it->part, latency);
+
+    /* Stats update */
+    ncycle_t tmp_lat = curr_tick-pkt->recvTick;
+    if (tmp_lat>max_issue_lat)
+        max_issue_lat = tmp_lat;
+    if (tmp_lat<min_issue_lat)
+        min_issue_lat = tmp_lat;
+    avg_issue_lat = (avg_issue_lat*num_issue+tmp_lat)/(double)(num_issue+1);
+    num_issue += 1;
+
+    if (it->part_stalled)
+        part_conflicts += 1;
+    if (it->wr_stalled)
+        bank_write_stalls += 1;
+
+    pkt->from = this;
+    media->recvRequest(pkt, latency); // send command
+    if (pkt->cmd==CMD_WRITE)
+    {
+        /* Send write command signal to DPU */
+        dpu->recvRequest(pkt);
+        wack(pkt, CMD_WACK_ID);
+    }
+}
+
+void PCMEngine::register_stats( )
+{
+    uint64_t u64_zero = 0;
+    uint64_t u64_max = std::numeric_limits<uint64_t>::max( );
+    double df_init = 0.0;
+
+    RESET_STATS(req_reads, u64_zero);
+    RESET_STATS(req_writes, u64_zero);
+    RESET_STATS(part_conflicts, u64_zero);
+    RESET_STATS(bank_write_stalls, u64_zero);
+    RESET_STATS(reads_under_write, u64_zero);
+    RESET_STATS(starved_reqs, u64_zero);
+    RESET_STATS(max_issue_lat, u64_zero);
+    RESET_STATS(min_issue_lat, u64_max);
+    RESET_STATS(avg_issue_lat, df_init);
+    RESET_STATS(energy_read, df_init);
+    RESET_STATS(energy_write, df_init);
+    RESET_STATS(energy_total, df_init);
+    RESET_STATS(write_cancels, u64_zero);
+    RESET_STATS(write_pauses, u64_zero);
+    RESET_STATS(preempt_reads, u64_zero);
+    RESET_STATS(wasted_prog_cycles, u64_zero);
+    RESET_STATS(read_lat_saved, u64_zero);
+    num_issue = 0;
+
+    ADD_STATS(cp_name, req_reads);
+    ADD_STATS(cp_name, req_writes);
+    ADD_STATS(cp_name, part_conflicts);
+    ADD_STATS(cp_name, bank_write_stalls);
+    ADD_STATS(cp_name, reads_under_write);
+    if (policy==POLICY_FRFCFS)
+        ADD_STATS(cp_name, starved_reqs);
+    ADD_STATS_LAT(cp_name, max_issue_lat);
+    ADD_STATS_LAT(cp_name, min_issue_lat);
+    ADD_STATS_LAT(cp_name, avg_issue_lat);
+    register_qdepth_stats( );
+    if (use_cancel)
+    {
+        ADD_STATS(cp_name, write_cancels);
+        ADD_STATS_N_UNIT(cp_name, wasted_prog_cycles, "cycles");
+    }
+    if (use_pause)
+        ADD_STATS(cp_name, write_pauses);
+    if (use_cancel || use_pause)
+    {
+        ADD_STATS(cp_name, preempt_reads);
+        ADD_STATS_N_UNIT(cp_name, read_lat_saved, "cycles");
+    }
+    ADD_STATS_N_UNIT(cp_name, energy_read, "pJ");
+    ADD_STATS_N_UNIT(cp_name, energy_write, "pJ");
+    ADD_STATS_N_UNIT(cp_name, energy_total, "pJ");
+}
+
+void PCMEngine::calculate_stats( )
+{
+    if (num_issue>0)
+    {
+        max_issue_lat /= ticks_per_cycle;
+        min_issue_lat /= ticks_per_cycle;
+        avg_issue_lat /= ticks_per_cycle;
+    }
+    calculate_qdepth_stats( );
+
+    energy_total = energy_read + energy_write;
+}
@@ -0,0 +1,211 @@
+/*
+ * Copyright (c) 2019 Computer Architecture and Paralllel Processing Lab, 
+ * Seoul National University, Republic of Korea. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     1. Redistribution of source code must retain the above copyright 
+ *        notice, this list of conditions and the follwoing disclaimer.
+ *     2. Redistributions in binary form must reproduce the above copyright 
+ *        notice, this list conditions and the following disclaimer in the 
+ *        documentation and/or other materials provided with the distirubtion.
+ *     3. Neither the name of the copyright holders nor the name of its 
+ *        contributors may be used to endorse or promote products derived from 
+ *        this software without specific prior written permission. 
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Authors: Hyokeun Lee (hklee@capp.snu.ac.kr)
+ *
+ * Decription: uCMD engine that issues PCM-native commands. A read senses 
+ * a partition with tRD, and a write programs a partition with RESET and 
+ * SET pulses (tRESET/tSET), so there is neither ACT/PRE nor refresh. 
+ * Partitions (FLD_HALF x FLD_PART) in a bank work concurrently while 
+ * concurrent writes in a bank are bounded by its write-busy windows.
+ */
+
+#ifndef __PCMCSIM_PCM_ENGINE_H_
+#define __PCMCSIM_PCM_ENGINE_H_
+
+#include "uCMDEngine/uCMDEngine.h"
+
+namespace PCMCsim
+{
+    class AddressDecoder;
+    class MemInfo;
+
+    class PCMEngine : public uCMDEngine
+    {
+      public:
+        PCMEngine( ) = delete;
+        PCMEngine(MemoryControlSystem* memsys_, AddressDecoder* adec_, 
+                  MemInfo* info_, std::string cfg_header, 
+                  ncycle_t ticks_per_cycle_, uint64_t id_=0);
+        ~PCMEngine( );
+
+        bool isReady(Packet* pkt) override;
+        uint64_t get_num_reqs( ) override;
+        void recvRequest(Packet* pkt, ncycle_t delay=1) override;
+
+        void handle_events(ncycle_t curr_tick) override;
+
+        /* DPU should retain write data until a write is programmed */
+        bool is_write_cancellable( ) { return use_cancel; }
+
+        /* Tools */
+        AddressDecoder* adec;
+        MemInfo* info;
+
+      protected:
+        /* Event processing functions */
+        void handle_await_reqs( ) override;
+
+        enum _pcm_policies
+        {
+            POLICY_FCFS = 0,    // oldest issuable request first
+            POLICY_FRFCFS,      // reads first, writes bounded by starvation
+            NUM_POLICIES
+        };
+
+        enum _write_schemes
+        {
+            SERIAL = 0,     // RESET pulses followed by SET pulses
+            PARALLEL,       // RESET and SET pulses overlap
+            NUM_WRITE_SCHEMES
+        };
+
+        int policy;
+        int write_scheme;
+
+        /* Request list */
+        typedef struct _req_entry_t
+        {
+            Packet* pkt;
+            uint64_t rank;
+            uint64_t bank;
+            uint64_t part;      // half*partitions+partition
+            uint64_t bypassed;  // times younger requests went ahead
+            bool part_stalled;  // waited for a busy partition
+            bool wr_stalled;    // waited for write-busy window of bank
+            bool reissue;       // re-issue of a cancelled write
+            uint64_t cancels;   // times the write has been cancelled
+        } req_entry_t;
+
+        uint64_t size_reqlist;
+        uint64_t th_starv;
+        std::list<req_entry_t> reqlist;
+        ncycle_t wake_reqlist;
+
+        void cycle_reqlist( );
+        void schedule_reqlist(ncycle_t wakeup);
+        bool find_req(std::list<req_entry_t>::iterator& found, 
+                      ncycle_t& next_tick, bool reads_only);
+        ncycle_t get_issue_tick(req_entry_t& entry);
+        void issue(std::list<req_entry_t>::iterator it);
+
+        /* Timing states (in ticks) */
+        ncycle_t cmd_free;                      // command bus
+        ncycle_t bus_free;                      // data bus
+        uint64_t last_rank;                     // rank driving data bus
+        std::vector<ncycle_t> part_free;        // per-partition busy window
+        std::vector<std::vector<ncycle_t>> bank_wr_free; // write slots of bank
+
+        uint64_t get_bank_idx(uint64_t rank, uint64_t bank) 
+        { return rank*num_all_banks+bank; }
+        uint64_t get_part_idx(uint64_t rank, uint64_t bank, uint64_t part) 
+        { return get_bank_idx(rank, bank)*num_parts+part; }
+        ncycle_t get_free_slot(uint64_t bank_idx);
+
+        /* Write cancellation and pausing in favor of reads */
+        enum _preempt_types
+        {
+            PREEMPT_NONE = 0,
+            PREEMPT_CANCEL,     // abort the write and re-issue it later
+            PREEMPT_PAUSE,      // suspend the write at an iteration boundary
+            NUM_PREEMPT_TYPES
+        };
+
+        typedef struct _prog_t
+        {
+            bool active;        // programming or paused
+            uint64_t slot;      // occupied write slot of bank
+            ncycle_t start;     // start of current program segment
+            ncycle_t end;       // expected end of program
+            uint64_t pauses;
+            uint64_t cancels;
+            Packet* pkt;        // kept for re-issue if cancellable
+        } prog_t;
+
+        bool use_cancel;
+        bool use_pause;
+        double th_cancel;       // progress beyond which cancel is unattractive
+        uint64_t max_cancels;   // per write
+        uint64_t max_pauses;    // per write
+        ncycle_t tITER;         // program-and-verify iteration
+        std::vector<prog_t> progs;  // per-partition program
+
+        ncycle_t get_preempt_tick(uint64_t part_idx, int& type);
+        void preempt(std::list<req_entry_t>::iterator it, uint64_t part_idx, int type);
+        void finish_prog(void* prog);
+
+        /* Timing parameters (in cycles) */
+        ncycle_t tCMD;
+        ncycle_t tRD;       // array read (sensing) latency
+        ncycle_t tCWL;      // write data latency
+        ncycle_t tBURST;
+        ncycle_t tRTRS;     // rank-to-rank switching on data bus
+        ncycle_t tRESET;
+        ncycle_t tSET;
+        ncycle_t tPROG;     // write-busy window of a partition
+
+        /* Energy parameters (pJ per access) */
+        double eRD;
+        double eRESET;
+        double eSET;
+
+        /* Frequently used memory information */
+        uint64_t num_ranks;
+        uint64_t num_all_banks;
+        uint64_t num_parts;
+        uint64_t writes_per_bank;
+
+        uint64_t deadlock_timer;
+
+        /* Stats */
+        uint64_t req_reads;
+        uint64_t req_writes;
+        uint64_t part_conflicts;    // requests delayed by a busy partition
+        uint64_t bank_write_stalls; // writes delayed by write-busy windows
+        uint64_t reads_under_write; // reads overlapped with a program in bank
+        uint64_t starved_reqs;     // requests bypassed up to the threshold
+        uint64_t write_cancels;
+        uint64_t write_pauses;
+        uint64_t preempt_reads;     // reads served by cancel or pause
+        ncycle_t wasted_prog_cycles;// programmed cycles of cancelled writes
+        ncycle_t read_lat_saved;    // program cycles preempting reads skipped
+
+        ncycle_t max_issue_lat;
+        ncycle_t min_issue_lat;
+        double avg_issue_lat;
+        uint64_t num_issue;
+
+        double energy_read;
+        double energy_write;
+        double energy_total;
+
+        void register_stats( ) override;
+        void calculate_stats( ) override;
+    };
+};
+
+#endif
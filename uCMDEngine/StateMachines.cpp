@@ -33,6 +33,9 @@ StateMachine::StateMachine(JedecEngine* je_): je(je_)
     setup_timings(num_all_banks);
     setup_currents( );
 
+    cas_events.resize(2);
+    check_lazy = je->getParamBOOL(".SM.check_lazy", false);
+
     for (uint64_t i=0; i<num_ranks; i++)
         rm.push_back(RankMachine(this, i));
 }
@@ -44,27 +47,37 @@ bool StateMachine::is_idle(uint64_t rank)
 
 bool StateMachine::is_issuable(Packet* pkt)
 {
-    uint64_t rank = je->adec->decode_addr(pkt->PADDR, FLD_RANK);
+    uint64_t rank = je->adec->decode_pkt(pkt).fld[FLD_RANK];
     return rm[rank].is_issuable(pkt);
 }
 
 ncycle_t StateMachine::timely_issuable(Packet* pkt)
 {
-    uint64_t rank = je->adec->decode_addr(pkt->PADDR, FLD_RANK);
+    uint64_t rank = je->adec->decode_pkt(pkt).fld[FLD_RANK];
     return rm[rank].timely_issuable(pkt);
 }
 
 ncycle_t StateMachine::update_states(Packet* pkt)
 {
     /* Update states of ACCESSED rank */
-    uint64_t rank = je->adec->decode_addr(pkt->PADDR, FLD_RANK);
+    uint64_t rank = je->adec->decode_pkt(pkt).fld[FLD_RANK];
     ncycle_t rv = rm[rank].update_states(pkt);
 
-    /* Notify unaccessed ranks */
-    for (uint64_t r=0; r<num_ranks; r++)
+    /* Record CAS for unaccessed ranks, which derive timings from it */
+    ncycle_t curr_tick = je->getGlobalEventQueue( )->getCurrentTick( );
+    if (pkt->cmd==CMD_READ || pkt->cmd==CMD_READ_PRE)
+        cas_events[0].push(curr_tick, rank);
+    else if (pkt->cmd==CMD_WRITE || pkt->cmd==CMD_WRITE_PRE)
+        cas_events[1].push(curr_tick, rank);
+
+    if (check_lazy)
     {
-        if (r==rank) continue;
-        rm[r].notify(pkt);
+        /* Notify unaccessed ranks */
+        for (uint64_t r=0; r<num_ranks; r++)
+        {
+            if (r==rank) continue;
+            rm[r].notify(pkt);
+        }
     }
     return rv;
 }
@@ -97,15 +110,14 @@ void StateMachine::postupdate_states(Packet* pkt)
      * Postupdate states. E.g., CLOSED if no bank 
      * is active after PRECAHRGE-ended operations 
      */
-    uint64_t rank = je->adec->decode_addr(pkt->PADDR, FLD_RANK);
+    uint64_t rank = je->adec->decode_pkt(pkt).fld[FLD_RANK];
     rm[rank].postupdate_states(pkt);
 }
 
-void StateMachine::update_stats(ncycle_t cycles)
+void StateMachine::sync_stats( )
 {
-    if (cycles==0) return;
     for (uint64_t r=0; r<num_ranks; r++)
-        rm[r].update_stats(cycles);
+        rm[r].sync_bckgnd( );
 }
 
 void StateMachine::calculate_stats( )
@@ -133,6 +145,12 @@ std::string StateMachine::print_state(int state)
     return rv;
 }
 
+ncycle_t StateMachine::get_curr_cycle( )
+{
+    return (je->getGlobalEventQueue( )->getCurrentTick( ) 
+        / je->getTicksPerCycle( ));
+}
+
 ncycle_t StateMachine::get_tick_after(ncycle_t LAT)
 {
     assert((int64_t)LAT>=0);
@@ -140,6 +158,15 @@ ncycle_t StateMachine::get_tick_after(ncycle_t LAT)
         + LAT*je->getTicksPerCycle( ));
 }
 
+ncycle_t StateMachine::get_tick_after(ncycle_t base_tick, ncycle_t LAT)
+{
+    /* No constraint if the event has never occurred */
+    assert((int64_t)LAT>=0);
+    if (base_tick==last_event_t::NO_TICK)
+        return 0;
+    return (base_tick + LAT*je->getTicksPerCycle( ));
+}
+
 void StateMachine::setup_timings(const uint64_t num_all_banks)
 {
     /* Initialize timing-relatd parameters */
@@ -330,8 +357,8 @@ uint64_t StateMachine::get_tCCD_L(cmd_t type)
 
 /* Definition of RankMachine */
 RankMachine::RankMachine(StateMachine* sm_, uint64_t id_)
-: id(id_), sm(sm_), state(ST_CLOSED), issuable_READ(0),
-issuable_WRITE(0), XAW_ptr(0)
+: id(id_), sm(sm_), num_busy_banks(0), state(ST_CLOSED), XAW_ptr(0), 
+chk_READ(0), chk_WRITE(0), last_state_cycle(0)
 {
     num_bgs = sm->je->info->get_bankgroups( );
     num_banks = sm->je->info->get_banks( );
@@ -339,6 +366,8 @@ issuable_WRITE(0), XAW_ptr(0)
     name = sm->je->get_name( ) + ".rank[" + std::to_string(id) + "]";
 
     last_ACTs.resize(sm->XAW, 0);
+    bg_events.resize(num_bgs*NUM_EVS);
+    rank_events.resize(NUM_EVS);
 
     for (uint64_t i=0; i<num_all_banks; i++)
         bm.push_back(BankMachine(sm, i, id));
@@ -379,18 +408,146 @@ RankMachine::RankMachine(const RankMachine& obj)
     stats = new Stats( ); // deep-copy for instantiation
 }
 
+uint64_t RankMachine::get_bm_idx(Packet* pkt)
+{
+    const addr_coord_t& crd = sm->je->adec->decode_pkt(pkt);
+    return get_bm_idx(crd.fld[FLD_BANKGRP], crd.fld[FLD_BANK]);
+}
+
+int RankMachine::get_event(cmd_t cmd)
+{
+    int rv = -1;
+    if (cmd==CMD_ACT)
+        rv = EV_ACT;
+    else if (cmd==CMD_READ || cmd==CMD_READ_PRE)
+        rv = EV_READ;
+    else if (cmd==CMD_WRITE || cmd==CMD_WRITE_PRE)
+        rv = EV_WRITE;
+    else if (cmd==CMD_PRE)
+        rv = EV_PRE;
+    else if (cmd==CMD_REFRESH)
+        rv = EV_REFRESH;
+    return rv;
+}
+
+void RankMachine::push_event(Packet* pkt)
+{
+    int ev = get_event(pkt->cmd);
+    if (ev<0) return;
+
+    ncycle_t curr_tick = sm->je->getGlobalEventQueue( )->getCurrentTick( );
+    uint64_t bm_idx = get_bm_idx(pkt);
+    uint64_t bg = bm_idx / num_banks;
+    bg_events[bg*NUM_EVS+ev].push(curr_tick, bm_idx);
+    rank_events[ev].push(curr_tick, bg);
+}
+
+ncycle_t RankMachine::get_notified(uint64_t bm_idx, cmd_t cmd)
+{
+    /* Timing of bank imposed by the other banks in same & diff BGs */
+    uint64_t bg = bm_idx / num_banks;
+    last_event_t* same = &bg_events[bg*NUM_EVS];
+    last_event_t* diff = &rank_events[0];
+    ncycle_t rv = 0;
+
+    switch (cmd)
+    {
+        case CMD_ACT:
+        case CMD_REFRESH: // NOTE: issuable_REFRESH==issuable_ACT
+            rv = MAX(sm->get_tick_after(same[EV_ACT].get_except(bm_idx), 
+                        sm->tRRD_L),
+                     sm->get_tick_after(diff[EV_ACT].get_except(bg), 
+                        sm->tRRD_S));
+            rv = MAX(rv, sm->get_tick_after(
+                same[EV_REFRESH].get_except(bm_idx), sm->tRFC));
+            rv = MAX(rv, sm->get_tick_after(
+                diff[EV_REFRESH].get_except(bg), sm->tRFC));
+            break;
+
+        case CMD_READ:
+        case CMD_READ_PRE:
+            rv = MAX(sm->get_tick_after(same[EV_READ].get_except(bm_idx),
+                        MAX(sm->tBURST, sm->get_tCCD_L(CMD_READ))),
+                     sm->get_tick_after(diff[EV_READ].get_except(bg),
+                        MAX(sm->tBURST, sm->tCCD_S)));
+            rv = MAX(rv, sm->get_tick_after(
+                same[EV_WRITE].get_except(bm_idx), 
+                sm->tCWL + sm->tBURST + sm->tWTR_L));
+            rv = MAX(rv, sm->get_tick_after(
+                diff[EV_WRITE].get_except(bg), 
+                sm->tCWL + sm->tBURST + sm->tWTR_S));
+            break;
+
+        case CMD_WRITE:
+        case CMD_WRITE_PRE:
+            rv = MAX(sm->get_tick_after(same[EV_WRITE].get_except(bm_idx),
+                        MAX(sm->tBURST, sm->get_tCCD_L(CMD_WRITE))),
+                     sm->get_tick_after(diff[EV_WRITE].get_except(bg),
+                        MAX(sm->tBURST, sm->tCCD_S)));
+            rv = MAX(rv, sm->get_tick_after(
+                same[EV_READ].get_except(bm_idx), 
+                sm->tAL + sm->tCL + sm->tBURST + sm->tRTRS - sm->tCWL));
+            rv = MAX(rv, sm->get_tick_after(
+                diff[EV_READ].get_except(bg), 
+                sm->tAL + sm->tCL + sm->tBURST + sm->tRTRS - sm->tCWL));
+            break;
+
+        case CMD_PRE:
+            rv = MAX(sm->get_tick_after(same[EV_PRE].get_except(bm_idx), 
+                        sm->tPPD),
+                     sm->get_tick_after(diff[EV_PRE].get_except(bg), 
+                        sm->tPPD));
+            break;
+
+        default:
+            break;
+    }
+
+    assert(sm->check_lazy==false || rv==bm[bm_idx].get_checked(cmd));
+    return rv;
+}
+
+ncycle_t RankMachine::get_notified(cmd_t cmd)
+{
+    /* Timing of rank imposed by CAS of the other ranks */
+    ncycle_t last_RD = sm->cas_events[0].get_except(id);
+    ncycle_t last_WR = sm->cas_events[1].get_except(id);
+    ncycle_t rv = 0;
+
+    if (cmd==CMD_READ || cmd==CMD_READ_PRE)
+    {
+        rv = MAX(sm->get_tick_after(last_RD, sm->tBURST + sm->tRTRS),
+                 sm->get_tick_after(last_WR, 
+                    sm->tBURST + sm->tCWL + sm->tRTRS - sm->tCL));
+        assert(sm->check_lazy==false || rv==chk_READ);
+    }
+    else if (cmd==CMD_WRITE || cmd==CMD_WRITE_PRE)
+    {
+        rv = MAX(sm->get_tick_after(last_RD, 
+                    sm->tCL + sm->tBURST + sm->tRTRS - sm->tCWL),
+                 sm->get_tick_after(last_WR, sm->tBURST));
+        assert(sm->check_lazy==false || rv==chk_WRITE);
+    }
+    return rv;
+}
+
 bool RankMachine::is_idle( )
 {
-    /* Check rank idleness */
-    bool rank_idle = true;
+    /* Check rank idleness (all banks are closed) */
+    bool rank_idle = (num_busy_banks==0);
     
-    for (uint64_t i=0; i<num_all_banks; i++)
+    if (sm->check_lazy)
     {
-        if (bm[i].is_idle( )==false)
+        bool chk_idle = true;
+        for (uint64_t i=0; i<num_all_banks; i++)
         {
-            rank_idle = false;
-            break;
+            if (bm[i].is_idle( )==false)
+            {
+                chk_idle = false;
+                break;
+            }
         }
+        assert(chk_idle==rank_idle);
     }
     return rank_idle;
 }
@@ -400,9 +557,7 @@ bool RankMachine::is_issuable(Packet* pkt)
     bool rv = true;
     ncycle_t cur_tick = sm->je->getGlobalEventQueue( )->getCurrentTick( );
     uint64_t check_cnt = 0;
-    uint64_t bm_idx = get_bm_idx(
-        sm->je->adec->decode_addr(pkt->PADDR, FLD_BANKGRP),
-        sm->je->adec->decode_addr(pkt->PADDR, FLD_BANK));
+    uint64_t bm_idx = get_bm_idx(pkt);
 
     switch (pkt->cmd)
     {
@@ -417,7 +572,8 @@ bool RankMachine::is_issuable(Packet* pkt)
                     sm->je->get_cmd_str(pkt).c_str( ));
             }
             else
-                rv = bm[bm_idx].is_issuable(pkt);
+                rv = bm[bm_idx].is_issuable(pkt, 
+                    get_notified(bm_idx, pkt->cmd));
 
             if (pkt->cmd==CMD_REFRESH)
             {
@@ -431,7 +587,9 @@ bool RankMachine::is_issuable(Packet* pkt)
                         uint64_t offset = bg*num_banks+bm_idx;
                         for (uint64_t b=0; b<sm->banks_per_refresh; b++)
                         {
-                            if (bm[offset+b].is_issuable(pkt)==false)
+                            uint64_t b_idx = offset+b;
+                            if (bm[b_idx].is_issuable(pkt, 
+                                    get_notified(b_idx, pkt->cmd))==false)
                             {
                                 rv = false;
                                 break;
@@ -443,7 +601,9 @@ bool RankMachine::is_issuable(Packet* pkt)
                 {
                     for (uint64_t i=0; i<sm->banks_per_refresh; i++)
                     {
-                        if (bm[bm_idx+i].is_issuable(pkt)==false)
+                        uint64_t b_idx = bm_idx+i;
+                        if (bm[b_idx].is_issuable(pkt, 
+                                get_notified(b_idx, pkt->cmd))==false)
                         {
                             rv = false;
                             break;
@@ -455,22 +615,25 @@ bool RankMachine::is_issuable(Packet* pkt)
 
         case CMD_READ:
         case CMD_READ_PRE:
-            if (issuable_READ>cur_tick)
+            if (get_notified(pkt->cmd)>cur_tick)
                 rv = false;
             else 
-                rv = bm[bm_idx].is_issuable(pkt);
+                rv = bm[bm_idx].is_issuable(pkt, 
+                    get_notified(bm_idx, pkt->cmd));
             break;
 
         case CMD_WRITE:
         case CMD_WRITE_PRE:
-            if (issuable_WRITE>cur_tick)
+            if (get_notified(pkt->cmd)>cur_tick)
                 rv = false;
             else
-                rv = bm[bm_idx].is_issuable(pkt);
+                rv = bm[bm_idx].is_issuable(pkt, 
+                    get_notified(bm_idx, pkt->cmd));
             break;
 
         case CMD_PRE:
-            rv = bm[bm_idx].is_issuable(pkt);
+            rv = bm[bm_idx].is_issuable(pkt, 
+                    get_notified(bm_idx, pkt->cmd));
             break;
 
         case CMD_APDE:
@@ -482,7 +645,7 @@ bool RankMachine::is_issuable(Packet* pkt)
             {
                 for (uint64_t b=0; b<num_all_banks; b++)
                 {
-                    if (bm[b].is_issuable(pkt)==false)
+                    if (bm[b].is_issuable(pkt, get_notified(b, pkt->cmd))==false)
                     {
                         rv = false;
                         break;
@@ -494,7 +657,7 @@ bool RankMachine::is_issuable(Packet* pkt)
         case CMD_PDX:
             for (uint64_t b=0; b<num_all_banks; b++)
             {
-                if (bm[b].is_issuable(pkt)==false)
+                if (bm[b].is_issuable(pkt, get_notified(b, pkt->cmd))==false)
                     rv = false;
                 else
                     check_cnt += 1; // ensure all banks in PD
@@ -509,7 +672,7 @@ bool RankMachine::is_issuable(Packet* pkt)
             {
                 for (uint64_t b=0; b<num_all_banks; b++)
                 {
-                    if (bm[b].is_issuable(pkt)==false)
+                    if (bm[b].is_issuable(pkt, get_notified(b, pkt->cmd))==false)
                     {
                         rv = false;
                         break;
@@ -521,7 +684,7 @@ bool RankMachine::is_issuable(Packet* pkt)
         case CMD_SRX:
             for (uint64_t b=0; b<num_all_banks; b++)
             {
-                if (bm[b].is_issuable(pkt)==false)
+                if (bm[b].is_issuable(pkt, get_notified(b, pkt->cmd))==false)
                     rv = false;
                 else
                     check_cnt += 1; // ensure all banks in SREF
@@ -539,18 +702,17 @@ bool RankMachine::is_issuable(Packet* pkt)
 ncycle_t RankMachine::timely_issuable(Packet* pkt)
 {
     ncycle_t issuable = 0;
-    uint64_t bm_idx = get_bm_idx(
-        sm->je->adec->decode_addr(pkt->PADDR, FLD_BANKGRP),
-        sm->je->adec->decode_addr(pkt->PADDR, FLD_BANK));
+    uint64_t bm_idx = get_bm_idx(pkt);
 
     if (pkt->cmd==CMD_ACT || pkt->cmd==CMD_REFRESH)
         issuable = last_ACTs[(XAW_ptr+1)%sm->XAW] + sm->tXAW;
     else if (pkt->cmd==CMD_READ || pkt->cmd==CMD_READ_PRE)
-        issuable = issuable_READ;
+        issuable = get_notified(pkt->cmd);
     else if (pkt->cmd==CMD_WRITE || pkt->cmd==CMD_WRITE_PRE)
-        issuable = issuable_WRITE;
+        issuable = get_notified(pkt->cmd);
     
-    return MAX(issuable, bm[bm_idx].timely_issuable(pkt));
+    return MAX(issuable, bm[bm_idx].timely_issuable(pkt, 
+        get_notified(bm_idx, pkt->cmd)));
 }
 
 ncycle_t RankMachine::update_states(Packet* pkt)
@@ -606,18 +768,22 @@ ncycle_t RankMachine::update_states(Packet* pkt)
             break;
     }
 
-    /* Notify unaccessed banks to update timings */
-    uint64_t pkt_bg = sm->je->adec->decode_addr(pkt->PADDR, FLD_BANKGRP);
-    uint64_t bm_idx = get_bm_idx(
-        sm->je->adec->decode_addr(pkt->PADDR, FLD_BANKGRP),
-        sm->je->adec->decode_addr(pkt->PADDR, FLD_BANK));
-    for (uint64_t bg=0; bg<num_bgs; bg++)
+    /* Record the cmd for unaccessed banks, which derive timings from it */
+    push_event(pkt);
+
+    if (sm->check_lazy)
     {
-        for (uint64_t b=0; b<num_banks; b++)
+        /* Notify unaccessed banks to update timings */
+        uint64_t pkt_bg = sm->je->adec->decode_pkt(pkt).fld[FLD_BANKGRP];
+        uint64_t bm_idx = get_bm_idx(pkt);
+        for (uint64_t bg=0; bg<num_bgs; bg++)
         {
-            uint64_t tmp_idx = get_bm_idx(bg, b);
-            if (tmp_idx==bm_idx) continue;
-            bm[tmp_idx].notify(pkt, bg==pkt_bg);
+            for (uint64_t b=0; b<num_banks; b++)
+            {
+                uint64_t tmp_idx = get_bm_idx(bg, b);
+                if (tmp_idx==bm_idx) continue;
+                bm[tmp_idx].notify(pkt, bg==pkt_bg);
+            }
         }
     }
 
@@ -626,18 +792,16 @@ ncycle_t RankMachine::update_states(Packet* pkt)
 
 void RankMachine::postupdate_states(Packet* pkt)
 {
-    uint64_t bm_idx = get_bm_idx(
-        sm->je->adec->decode_addr(pkt->PADDR, FLD_BANKGRP),
-        sm->je->adec->decode_addr(pkt->PADDR, FLD_BANK));
+    uint64_t bm_idx = get_bm_idx(pkt);
 
     if (pkt->cmd==CMD_READ_PRE ||
         pkt->cmd==CMD_WRITE_PRE)
     {
-        bm[bm_idx].postupdate_states(pkt);
+        postupdate_bank(bm_idx, pkt);
 
         if (is_idle( ))
         {
-            state = ST_CLOSED;
+            set_state(ST_CLOSED);
             PCMC_DBG(sm->je->is_msg( ), "[RM] Rank=%lu is idle now\n", id);
         }
     }
@@ -653,18 +817,18 @@ void RankMachine::postupdate_states(Packet* pkt)
             {
                 uint64_t offset = bg*num_banks+bm_idx;
                 for (uint64_t b=0; b<sm->banks_per_refresh; b++)
-                    bm[offset+b].postupdate_states(pkt);
+                    postupdate_bank(offset+b, pkt);
             }
         }
         else
         {
             for (uint64_t i=0; i<sm->banks_per_refresh; i++)
-                bm[bm_idx+i].postupdate_states(pkt);
+                postupdate_bank(bm_idx+i, pkt);
         }
 
         if (is_idle( ))
         {
-            state = ST_CLOSED;
+            set_state(ST_CLOSED);
             PCMC_DBG(sm->je->is_msg( ), "[RM] Rank=%lu is idle now\n", id);
         }
     }
@@ -674,21 +838,21 @@ void RankMachine::postupdate_states(Packet* pkt)
 
 void RankMachine::notify(Packet* pkt)
 {
-    /* Notify ranks except the accessed one */
+    /* Notify ranks except the accessed one (only for cross-check) */
     if (pkt->cmd==CMD_READ || pkt->cmd==CMD_READ_PRE)
     {
-        issuable_READ = MAX(issuable_READ, sm->get_tick_after(
+        chk_READ = MAX(chk_READ, sm->get_tick_after(
             sm->tBURST + sm->tRTRS));
 
-        issuable_WRITE = MAX(issuable_WRITE, sm->get_tick_after(
+        chk_WRITE = MAX(chk_WRITE, sm->get_tick_after(
             sm->tCL + sm->tBURST + sm->tRTRS - sm->tCWL));
     }
     else if (pkt->cmd==CMD_WRITE || pkt->cmd==CMD_WRITE_PRE)
     {
-        issuable_WRITE = MAX(issuable_WRITE, sm->get_tick_after(
+        chk_WRITE = MAX(chk_WRITE, sm->get_tick_after(
             sm->tBURST)); // DDR3: latency is tBURST+MAX(tRTRS, tOST)
 
-        issuable_READ = MAX(issuable_READ, sm->get_tick_after(
+        chk_READ = MAX(chk_READ, sm->get_tick_after(
             sm->tBURST + sm->tCWL + sm->tRTRS - sm->tCL));
     }
 
@@ -697,48 +861,45 @@ void RankMachine::notify(Packet* pkt)
     {
         PCMC_DBG(sm->je->is_msg( ), "[RM] Notify to update timing of rank=%lu" 
             " from rank=%lu by CMD=%s, issue-READ @ %lu, issue-WRITE @ %lu\n",
-            id, sm->je->adec->decode_addr(pkt->PADDR, FLD_RANK),
-            sm->je->get_cmd_str(pkt).c_str( ), issuable_READ, issuable_WRITE);
+            id, sm->je->adec->decode_pkt(pkt).fld[FLD_RANK],
+            sm->je->get_cmd_str(pkt).c_str( ), chk_READ, chk_WRITE);
     }
 }
 
-void RankMachine::update_stats(ncycle_t cycles)
+void RankMachine::set_state(int next_state)
 {
-     uint64_t num_dev = sm->je->info->get_devs();
-    
-    /* Update BMs first */
-    for (uint64_t b=0; b<num_all_banks; b++)
-        bm[b].update_stats(cycles);
+    /* Close residency of the current state before transition */
+    sync_stats( );
+    state = next_state;
+}
+
+void RankMachine::sync_stats( )
+{
+    /* Accumulate residency of the current state since last sync */
+    ncycle_t curr_cycle = sm->get_curr_cycle( );
+    ncycle_t cycles = curr_cycle - last_state_cycle;
+    last_state_cycle = curr_cycle;
 
-    /* Update rank-related stats */
     switch (state)
     {
         case ST_APD:
             cycles_apd += cycles;
-            E_bckgnd += (sm->E_apd_inc*cycles) * num_dev;
             break;
         case ST_FPPD:
             cycles_fppd += cycles;
-            E_bckgnd += (sm->E_fppd_inc*cycles) * num_dev;
             break;
         case ST_SPPD:
             cycles_sppd += cycles;
-            E_bckgnd += (sm->E_sppd_inc*cycles) * num_dev;
             break;
         case ST_REFRESH:
         case ST_OPEN:
             cycles_stnby_act += cycles;
-            E_bckgnd += (sm->E_stnby_act_inc*cycles) * num_dev;
-            E_stnby += (sm->E_stnby_act_inc*cycles) * num_dev;
             break;
         case ST_CLOSED:
             cycles_stnby_pre += cycles;
-            E_bckgnd += (sm->E_stnby_pre_inc*cycles) * num_dev;
-            E_stnby += (sm->E_stnby_pre_inc*cycles) * num_dev;
             break;
         case ST_SREF:
             cycles_sref += cycles;
-            E_bckgnd += (sm->E_sref_inc*cycles) * num_dev;
             break;
         default:
             assert(0);
@@ -746,8 +907,52 @@ void RankMachine::update_stats(ncycle_t cycles)
     }
 }
 
+ncycle_t RankMachine::update_bank(uint64_t bm_idx, Packet* pkt)
+{
+    bool was_idle = bm[bm_idx].is_idle( );
+    ncycle_t rv = bm[bm_idx].update_states(pkt, get_notified(bm_idx, pkt->cmd));
+    count_busy_banks(was_idle, bm[bm_idx].is_idle( ));
+    return rv;
+}
+
+void RankMachine::postupdate_bank(uint64_t bm_idx, Packet* pkt)
+{
+    bool was_idle = bm[bm_idx].is_idle( );
+    bm[bm_idx].postupdate_states(pkt);
+    count_busy_banks(was_idle, bm[bm_idx].is_idle( ));
+}
+
+void RankMachine::count_busy_banks(bool was_idle, bool now_idle)
+{
+    if (was_idle && now_idle==false)
+        num_busy_banks += 1;
+    else if (was_idle==false && now_idle)
+    {
+        assert(num_busy_banks>0);
+        num_busy_banks -= 1;
+    }
+}
+
+void RankMachine::sync_bckgnd( )
+{
+    /* Close residencies, then derive background energy from them */
+    sync_stats( );
+    for (uint64_t b=0; b<num_all_banks; b++)
+        bm[b].sync_stats( );
+
+    double num_dev = (double)(sm->je->info->get_devs( ));
+    E_stnby = (sm->E_stnby_act_inc*cycles_stnby_act +
+               sm->E_stnby_pre_inc*cycles_stnby_pre) * num_dev;
+    E_bckgnd = E_stnby + (sm->E_apd_inc*cycles_apd + 
+                          sm->E_fppd_inc*cycles_fppd +
+                          sm->E_sppd_inc*cycles_sppd +
+                          sm->E_sref_inc*cycles_sref) * num_dev;
+}
+
 void RankMachine::calculate_stats( )
 {
+    sync_bckgnd( );
+
     double E_dynamic = 0.0; //ACT+RD+WR
     uint64_t bus_width = sm->je->info->get_DQs( ) * sm->je->info->get_devs( ) / 8;
     double max_bw = (double)(sm->je->info->get_ctrl_freq( ))*bus_width*2.0; //2 for DDR
@@ -781,15 +986,13 @@ void RankMachine::calculate_stats( )
 
 ncycle_t RankMachine::activate(Packet* pkt)
 {
-    uint64_t bm_idx = get_bm_idx(
-        sm->je->adec->decode_addr(pkt->PADDR, FLD_BANKGRP),
-        sm->je->adec->decode_addr(pkt->PADDR, FLD_BANK));
+    uint64_t bm_idx = get_bm_idx(pkt);
     
-    bm[bm_idx].update_states(pkt);
+    update_bank(bm_idx, pkt);
 
     if (state==ST_CLOSED)
     {
-        state = ST_OPEN;
+        set_state(ST_OPEN);
         PCMC_DBG(sm->je->is_msg( ), "[RM] Rank=%lu is active now\n", id);
     }
 
@@ -800,25 +1003,21 @@ ncycle_t RankMachine::activate(Packet* pkt)
 
 ncycle_t RankMachine::rdwr(Packet* pkt)
 {
-    uint64_t bm_idx = get_bm_idx(
-        sm->je->adec->decode_addr(pkt->PADDR, FLD_BANKGRP),
-        sm->je->adec->decode_addr(pkt->PADDR, FLD_BANK));
+    uint64_t bm_idx = get_bm_idx(pkt);
     
-    return bm[bm_idx].update_states(pkt);
+    return update_bank(bm_idx, pkt);
 }
 
 ncycle_t RankMachine::precharge(Packet* pkt)
 {
-    uint64_t bm_idx = get_bm_idx(
-        sm->je->adec->decode_addr(pkt->PADDR, FLD_BANKGRP),
-        sm->je->adec->decode_addr(pkt->PADDR, FLD_BANK));
+    uint64_t bm_idx = get_bm_idx(pkt);
     
-    bm[bm_idx].update_states(pkt);
+    update_bank(bm_idx, pkt);
 
     /* Update rank state */
     if (is_idle( ))
     {
-        state = ST_CLOSED;
+        set_state(ST_CLOSED);
         PCMC_DBG(sm->je->is_msg( ), "[RM] Rank=%lu is idle now\n", id);
     }
 
@@ -828,18 +1027,18 @@ ncycle_t RankMachine::precharge(Packet* pkt)
 ncycle_t RankMachine::powerdown(Packet* pkt)
 {
     for (uint64_t i=0; i<num_all_banks; i++)
-        bm[i].update_states(pkt);
+        update_bank(i, pkt);
 
     switch (pkt->cmd)
     {
         case CMD_APDE:
-            state = ST_APD;
+            set_state(ST_APD);
             break;
         case CMD_FPPDE:
-            state = ST_FPPD;
+            set_state(ST_FPPD);
             break;
         case CMD_SPPDE:
-            state = ST_SPPD;
+            set_state(ST_SPPD);
             break;
         default:
             assert(0);
@@ -852,16 +1051,16 @@ ncycle_t RankMachine::powerup(Packet* pkt)
 {
     /* Wakeup all banks */
     for (uint64_t i=0; i<num_all_banks; i++)
-        bm[i].update_states(pkt);
+        update_bank(i, pkt);
 
     switch (state)
     {
         case ST_APD:
-            state = ST_OPEN;
+            set_state(ST_OPEN);
             break;
         case ST_FPPD:
         case ST_SPPD:
-            state = ST_CLOSED;
+            set_state(ST_CLOSED);
             break;
         default:
             assert(0);
@@ -872,9 +1071,7 @@ ncycle_t RankMachine::powerup(Packet* pkt)
 
 ncycle_t RankMachine::refresh(Packet* pkt)
 {
-    uint64_t base_refresh = get_bm_idx(
-        sm->je->adec->decode_addr(pkt->PADDR, FLD_BANKGRP),
-        sm->je->adec->decode_addr(pkt->PADDR, FLD_BANK));
+    uint64_t base_refresh = get_bm_idx(pkt);
 
     if (sm->sb_refresh)
     {
@@ -883,16 +1080,16 @@ ncycle_t RankMachine::refresh(Packet* pkt)
         {
             uint64_t offset = bg*num_banks+base_refresh;
             for (uint64_t b=0; b<sm->banks_per_refresh; b++)
-                bm[offset+b].update_states(pkt);
+                update_bank(offset+b, pkt);
         }
     }
     else
     {
         for (uint64_t i=0; i<sm->banks_per_refresh; i++)
-            bm[base_refresh+i].update_states(pkt);
+            update_bank(base_refresh+i, pkt);
     }
 
-    state = ST_REFRESH;
+    set_state(ST_REFRESH);
     XAW_ptr = (XAW_ptr+1) % sm->XAW;
     last_ACTs[XAW_ptr] = sm->je->getGlobalEventQueue( )->getCurrentTick( );
     return 0;
@@ -901,9 +1098,9 @@ ncycle_t RankMachine::refresh(Packet* pkt)
 ncycle_t RankMachine::sre(Packet* pkt)
 {
     for (uint64_t i=0; i<num_all_banks; i++)
-        bm[i].update_states(pkt);
+        update_bank(i, pkt);
     
-    state = ST_SREF;
+    set_state(ST_SREF);
 
     return 0;
 }
@@ -911,9 +1108,9 @@ ncycle_t RankMachine::sre(Packet* pkt)
 ncycle_t RankMachine::srx(Packet* pkt)
 {
     for (uint64_t i=0; i<num_all_banks; i++)
-        bm[i].update_states(pkt);
+        update_bank(i, pkt);
 
-    state = ST_CLOSED;
+    set_state(ST_CLOSED);
 
     return 0;
 }
@@ -922,7 +1119,8 @@ ncycle_t RankMachine::srx(Packet* pkt)
 BankMachine::BankMachine(StateMachine* sm_, uint64_t id_, uint64_t rank_id)
 : id(id_), sm(sm_), state(ST_CLOSED), issuable_ACT(0), issuable_PRE(0),
 issuable_READ(0), issuable_WRITE(0), issuable_REFRESH(0),
-issuable_PDE(0), issuable_PDX(0), issuable_SRE(0), issuable_SRX(0)
+issuable_PDE(0), issuable_PDX(0), issuable_SRE(0), issuable_SRX(0),
+chk_ACT(0), chk_PRE(0), chk_READ(0), chk_WRITE(0), last_state_cycle(0)
 {
     num_parts = sm->je->info->get_partitions( );
     half_banks = (sm->je->info->is_half_bank( ))? 2 : 1;
@@ -952,6 +1150,9 @@ issuable_PDE(0), issuable_PDX(0), issuable_SRE(0), issuable_SRX(0)
     E_rd = 0.0;
     E_wr = 0.0;
     E_refresh = 0.0;
+
+    bandwidth = 0.0;
+    util_bw = 0.0;
 }
 
 BankMachine::BankMachine(const BankMachine& obj)
@@ -960,24 +1161,28 @@ BankMachine::BankMachine(const BankMachine& obj)
     stats = new Stats( ); // deep-copy for instantiation
 }
 
+uint64_t BankMachine::get_row_idx(Packet* pkt)
+{
+    const addr_coord_t& crd = sm->je->adec->decode_pkt(pkt);
+    return get_row_idx(crd.fld[FLD_HALF], crd.fld[FLD_PART], crd.fld[FLD_ROW]);
+}
+
 bool BankMachine::is_idle( )
 {
     return (state==ST_CLOSED);
 }
 
-bool BankMachine::is_issuable(Packet* pkt)
+bool BankMachine::is_issuable(Packet* pkt, ncycle_t notified)
 {
     bool rv = true;
     ncycle_t cur_tick = sm->je->getGlobalEventQueue( )->getCurrentTick( );
-    uint64_t row_idx = get_row_idx(
-        sm->je->adec->decode_addr(pkt->PADDR, FLD_HALF),
-        sm->je->adec->decode_addr(pkt->PADDR, FLD_PART),
-        sm->je->adec->decode_addr(pkt->PADDR, FLD_ROW));
+    uint64_t row_idx = get_row_idx(pkt);
+    ncycle_t issuable = timely_issuable(pkt, notified);
         
     switch (pkt->cmd)
     {
         case CMD_ACT:
-            if (issuable_ACT>cur_tick || 
+            if (issuable>cur_tick || 
                 state==ST_APD ||
                 state==ST_FPPD ||
                 state==ST_SPPD ||
@@ -990,7 +1195,7 @@ bool BankMachine::is_issuable(Packet* pkt)
 
         case CMD_READ:
         case CMD_READ_PRE:
-            if (issuable_READ>cur_tick || 
+            if (issuable>cur_tick || 
                 state!=ST_OPEN ||
                 open_row!=row_idx)
                 rv = false;
@@ -1000,7 +1205,7 @@ bool BankMachine::is_issuable(Packet* pkt)
 
         case CMD_WRITE:
         case CMD_WRITE_PRE:
-            if (issuable_WRITE>cur_tick || 
+            if (issuable>cur_tick || 
                 state!=ST_OPEN ||
                 open_row!=row_idx)
                 rv = false;
@@ -1009,7 +1214,7 @@ bool BankMachine::is_issuable(Packet* pkt)
             break;
 
         case CMD_PRE:
-            if (issuable_PRE>cur_tick ||
+            if (issuable>cur_tick ||
                 (state!=ST_CLOSED && state!=ST_OPEN))
                 rv = false;
             else 
@@ -1019,7 +1224,7 @@ bool BankMachine::is_issuable(Packet* pkt)
         case CMD_APDE:
         case CMD_FPPDE:
         case CMD_SPPDE:
-            if (issuable_PDE>cur_tick ||
+            if (issuable>cur_tick ||
                 (state!=ST_CLOSED && state!=ST_OPEN) ||
                  ((pkt->cmd==CMD_FPPDE || pkt->cmd==CMD_SPPDE) &&
                   state==ST_OPEN))
@@ -1029,7 +1234,7 @@ bool BankMachine::is_issuable(Packet* pkt)
             break;
 
         case CMD_PDX:
-            if (issuable_PDX>cur_tick ||
+            if (issuable>cur_tick ||
                 (state!=ST_APD && 
                  state!=ST_FPPD && 
                  state!=ST_SPPD))
@@ -1039,8 +1244,8 @@ bool BankMachine::is_issuable(Packet* pkt)
             break;
 
         case CMD_REFRESH: // NOTE: issuable_REFRESH==issuable_ACT
-            if (issuable_ACT>cur_tick || state!=ST_CLOSED)
-//            if (issuable_ACT>cur_tick || //XXX
+            if (issuable>cur_tick || state!=ST_CLOSED)
+//            if (issuable>cur_tick || //XXX
 //                (state!=ST_CLOSED && state!=ST_OPEN))
                 rv = false;
             else
@@ -1048,14 +1253,14 @@ bool BankMachine::is_issuable(Packet* pkt)
             break;
 
         case CMD_SRE:
-            if (issuable_SRE>cur_tick || state!=ST_CLOSED)
+            if (issuable>cur_tick || state!=ST_CLOSED)
                 rv = false;
             else
                 rv = true;
             break;
 
         case CMD_SRX:
-            if (issuable_SRX>cur_tick || state!=ST_SREF)
+            if (issuable>cur_tick || state!=ST_SREF)
                 rv = false;
             else
                 rv = true;
@@ -1068,7 +1273,7 @@ bool BankMachine::is_issuable(Packet* pkt)
     return rv;
 }
 
-ncycle_t BankMachine::timely_issuable(Packet* pkt)
+ncycle_t BankMachine::timely_issuable(Packet* pkt, ncycle_t notified)
 {
     ncycle_t issuable = 0;
     if (pkt->cmd==CMD_ACT || pkt->cmd==CMD_REFRESH)
@@ -1090,12 +1295,13 @@ ncycle_t BankMachine::timely_issuable(Packet* pkt)
     else
         assert(0);
     
-    return issuable;
+    /* Timing imposed by other banks is derived by RankMachine */
+    return MAX(issuable, notified);
 }
 
-ncycle_t BankMachine::update_states(Packet* pkt)
+ncycle_t BankMachine::update_states(Packet* pkt, ncycle_t notified)
 {
-    assert(is_issuable(pkt));
+    assert(is_issuable(pkt, notified));
     ncycle_t rv = 0;
 
     /* Update states of ACCESSED banks */
@@ -1166,7 +1372,7 @@ void BankMachine::postupdate_states(Packet* pkt)
         pkt->cmd==CMD_WRITE_PRE ||
         pkt->cmd==CMD_REFRESH)
     {
-        state = ST_CLOSED;
+        set_state(ST_CLOSED);
         open_row = num_rows;
         
         PCMC_DBG(sm->je->is_msg( ), "[BM] bank=(%lu, %lu) will"
@@ -1181,7 +1387,7 @@ void BankMachine::postupdate_states(Packet* pkt)
 
 void BankMachine::notify(Packet* pkt, bool is_same_bankgroup)
 {
-    /* Notify all banks except the accessed one */
+    /* Notify all banks except the accessed one (only for cross-check) */
     ncycle_t tRRD = (is_same_bankgroup)? sm->tRRD_L : sm->tRRD_S;
     ncycle_t tCCD = (is_same_bankgroup)? sm->get_tCCD_L(pkt->cmd) : sm->tCCD_S;
     ncycle_t tWTR = (is_same_bankgroup)? sm->tWTR_L : sm->tWTR_S;
@@ -1189,29 +1395,26 @@ void BankMachine::notify(Packet* pkt, bool is_same_bankgroup)
     bool updated = true;
     if (pkt->cmd==CMD_READ || pkt->cmd==CMD_READ_PRE)
     {
-        issuable_READ = MAX(issuable_READ, sm->get_tick_after(
+        chk_READ = MAX(chk_READ, sm->get_tick_after(
             MAX(sm->tBURST, tCCD)));
 
-        issuable_WRITE = MAX(issuable_WRITE, sm->get_tick_after(
+        chk_WRITE = MAX(chk_WRITE, sm->get_tick_after(
             sm->tAL + sm->tCL + sm->tBURST + sm->tRTRS - sm->tCWL));
     }
     else if (pkt->cmd==CMD_WRITE || pkt->cmd==CMD_WRITE_PRE)
     {
-        issuable_READ = MAX(issuable_READ, sm->get_tick_after(
+        chk_READ = MAX(chk_READ, sm->get_tick_after(
             sm->tCWL + sm->tBURST + tWTR));
 
-        issuable_WRITE = MAX(issuable_WRITE, sm->get_tick_after(
+        chk_WRITE = MAX(chk_WRITE, sm->get_tick_after(
             MAX(sm->tBURST, tCCD)));
     }
     else if (pkt->cmd==CMD_REFRESH)
-    {
-        issuable_ACT = MAX(issuable_ACT, sm->get_tick_after(sm->tRFC));
-        issuable_REFRESH = MAX(issuable_REFRESH, sm->get_tick_after(sm->tRFC));
-    }
+        chk_ACT = MAX(chk_ACT, sm->get_tick_after(sm->tRFC));
     else if (pkt->cmd==CMD_ACT)
-        issuable_ACT = MAX(issuable_ACT, sm->get_tick_after(tRRD));
+        chk_ACT = MAX(chk_ACT, sm->get_tick_after(tRRD));
     else if (pkt->cmd==CMD_PRE)
-        issuable_PRE = MAX(issuable_PRE, sm->get_tick_after(sm->tPPD));
+        chk_PRE = MAX(chk_PRE, sm->get_tick_after(sm->tPPD));
     else
         updated = false;
 
@@ -1220,20 +1423,42 @@ void BankMachine::notify(Packet* pkt, bool is_same_bankgroup)
         PCMC_DBG(sm->je->is_msg( ), "[BM] Notify banks in"
             " %s BGs, bank=%lu(%lu, %lu), except the accessed one."
             " Timings: issue-ACT @ %lu, issue-PRE @ %lu,"
-            " issue-RD @ %lu, issue-WR @ %lu, issue-REFRESH @ %lu,"
-            " issue-PD @ %lu, issue-POWERUP @ %lu\n", 
+            " issue-RD @ %lu, issue-WR @ %lu\n", 
             (is_same_bankgroup)? "same":"diff",
             id, id/(sm->je->info->get_banks( )), 
             id%(sm->je->info->get_banks( )), 
-            issuable_ACT, issuable_PRE, issuable_READ, 
-            issuable_WRITE, issuable_REFRESH, 
-            issuable_PDE, issuable_PDX);
+            chk_ACT, chk_PRE, chk_READ, chk_WRITE);
     }
 }
 
-void BankMachine::update_stats(ncycle_t cycles)
+ncycle_t BankMachine::get_checked(cmd_t cmd)
+{
+    ncycle_t rv = 0;
+    if (cmd==CMD_ACT || cmd==CMD_REFRESH)
+        rv = chk_ACT;
+    else if (cmd==CMD_READ || cmd==CMD_READ_PRE)
+        rv = chk_READ;
+    else if (cmd==CMD_WRITE || cmd==CMD_WRITE_PRE)
+        rv = chk_WRITE;
+    else if (cmd==CMD_PRE)
+        rv = chk_PRE;
+    return rv;
+}
+
+void BankMachine::set_state(int next_state)
 {
-    /* Update bank-related stats */
+    /* Close residency of the current state before transition */
+    sync_stats( );
+    state = next_state;
+}
+
+void BankMachine::sync_stats( )
+{
+    /* Accumulate residency of the current state since last sync */
+    ncycle_t curr_cycle = sm->get_curr_cycle( );
+    ncycle_t cycles = curr_cycle - last_state_cycle;
+    last_state_cycle = curr_cycle;
+
     switch (state)
     {
         case ST_APD:
@@ -1255,6 +1480,8 @@ void BankMachine::update_stats(ncycle_t cycles)
 
 void BankMachine::calculate_stats( )
 {
+    sync_stats( );
+
     uint64_t bus_width = sm->je->info->get_DQs( ) * sm->je->info->get_devs( ) / 8;
     double max_bw = (double)(sm->je->info->get_ctrl_freq( ))*bus_width*2; //2 for DDR
     if (cycles_act!=0)
@@ -1273,10 +1500,7 @@ void BankMachine::calculate_stats( )
 ncycle_t BankMachine::activate(Packet* pkt)
 {
     assert(state==ST_CLOSED || open_row==num_rows);
-    uint64_t row_idx = get_row_idx(
-        sm->je->adec->decode_addr(pkt->PADDR, FLD_HALF),
-        sm->je->adec->decode_addr(pkt->PADDR, FLD_PART),
-        sm->je->adec->decode_addr(pkt->PADDR, FLD_ROW));
+    uint64_t row_idx = get_row_idx(pkt);
 
     issuable_ACT = MAX(issuable_ACT, sm->get_tick_after(
         sm->tRAS + sm->tRP));
@@ -1287,7 +1511,7 @@ ncycle_t BankMachine::activate(Packet* pkt)
     issuable_PRE = MAX(issuable_PRE, sm->get_tick_after(sm->tRAS));
     issuable_PDE = MAX(issuable_PDE, sm->get_tick_after(sm->tRAS));
 
-    state = ST_OPEN;
+    set_state(ST_OPEN);
     open_row = row_idx;
 
     /* Update stats */
@@ -1304,7 +1528,7 @@ ncycle_t BankMachine::precharge(Packet* /*pkt*/)
     issuable_SRE = MAX(issuable_SRE, sm->get_tick_after(sm->tRP));
     issuable_PDE = MAX(issuable_PDE, sm->get_tick_after(sm->tRP));
 
-    state = ST_CLOSED;
+    set_state(ST_CLOSED);
     open_row = num_rows;
 
     num_PRE += 1;
@@ -1386,14 +1610,14 @@ ncycle_t BankMachine::powerdown(Packet* pkt)
     if (state==ST_OPEN)
     {
         assert(pkt->cmd==CMD_APDE);
-        state = ST_APD;
+        set_state(ST_APD);
     }
     else if (state==ST_CLOSED)
     {
         if (pkt->cmd==CMD_APDE || pkt->cmd==CMD_FPPDE)
-            state = ST_FPPD;
+            set_state(ST_FPPD);
         else if (pkt->cmd==CMD_SPPDE)
-            state = ST_SPPD;
+            set_state(ST_SPPD);
         else
             assert(0);
     }
@@ -1417,16 +1641,16 @@ ncycle_t BankMachine::powerup(Packet* /*pkt*/)
         issuable_READ = MAX(issuable_READ, sm->get_tick_after(sm->tXP));
 
     if (state==ST_APD)
-        state = ST_OPEN;
+        set_state(ST_OPEN);
     else
-        state = ST_CLOSED;
+        set_state(ST_CLOSED);
 
     return 0;
 }
 
 ncycle_t BankMachine::refresh(Packet* /*pkt*/)
 {
-    state = ST_REFRESH;
+    set_state(ST_REFRESH);
     issuable_ACT = MAX(issuable_ACT, sm->get_tick_after(sm->tRFC));
     issuable_REFRESH = MAX(issuable_REFRESH, sm->get_tick_after(sm->tRFC));
     issuable_SRE = MAX(issuable_SRE, sm->get_tick_after(sm->tRFC));
@@ -1441,7 +1665,7 @@ ncycle_t BankMachine::refresh(Packet* /*pkt*/)
 
 ncycle_t BankMachine::sre(Packet* /*pkt*/)
 {
-    state = ST_SREF;
+    set_state(ST_SREF);
     issuable_SRX = MAX(issuable_SRX, sm->get_tick_after(sm->tCKESR));
 
     num_SREF += 1;
@@ -1451,7 +1675,7 @@ ncycle_t BankMachine::sre(Packet* /*pkt*/)
 
 ncycle_t BankMachine::srx(Packet* /*pkt*/)
 {
-    state = ST_CLOSED;
+    set_state(ST_CLOSED);
     issuable_ACT = MAX(issuable_ACT, sm->get_tick_after(sm->tXS));
     issuable_PRE = MAX(issuable_PRE, sm->get_tick_after(sm->tXS));
     issuable_REFRESH = MAX(issuable_REFRESH, sm->get_tick_after(sm->tXS));
@@ -1491,8 +1715,8 @@ void RankMachine::register_stats( )
     ADD_STATS_N_UNIT(name, E_bckgnd, "nJ");
     ADD_STATS_N_UNIT(name, E_total, "nJ");
     
-    ADD_STATS_N_UNIT(name, avg_bandwidth, "MB/s");
-    ADD_STATS(name, util_bw);
+    ADD_STATS_LEVEL_N_UNIT(name, avg_bandwidth, "MB/s");
+    ADD_STATS_LEVEL(name, util_bw);
 }
 
 void BankMachine::register_stats( )
@@ -1502,8 +1726,8 @@ void BankMachine::register_stats( )
     ADD_STATS_N_UNIT(name, E_rd, "nJ");
     ADD_STATS_N_UNIT(name, E_wr, "nJ");
     
-    ADD_STATS_N_UNIT(name, bandwidth, "MB/s");
-    ADD_STATS(name, util_bw);
+    ADD_STATS_LEVEL_N_UNIT(name, bandwidth, "MB/s");
+    ADD_STATS_LEVEL(name, util_bw);
 }
 
 void StateMachine::print_stats(std::ostream& os)
@@ -1524,3 +1748,21 @@ void BankMachine::print_stats(std::ostream& os)
     stats->print(os);
 }
 
+void StateMachine::collect_stats(std::vector<Stats*>& slist)
+{
+    for (uint64_t r=0; r<num_ranks; r++)
+        rm[r].collect_stats(slist);
+}
+
+void RankMachine::collect_stats(std::vector<Stats*>& slist)
+{
+    for (uint64_t b=0; b<num_bgs*num_banks; b++)
+        bm[b].collect_stats(slist);
+    slist.push_back(stats);
+}
+
+void BankMachine::collect_stats(std::vector<Stats*>& slist)
+{
+    slist.push_back(stats);
+}
+
@@ -47,6 +47,38 @@ namespace PCMCsim
     class StateMachine;
     class Stats;
 
+    /* 
+     * Aggregated constraint register of an event (e.g., RD in a bankgroup).
+     * It keeps the latest event and the latest one from other sources, so
+     * the constraint seen by any source (which excludes its own) is O(1).
+     */
+    typedef struct _last_event_t
+    {
+        ncycle_t tick;          // tick of the latest event
+        uint64_t src;           // source of the latest event
+        ncycle_t tick_others;   // latest tick from sources other than src
+
+        _last_event_t( ) : tick(NO_TICK), src(NO_SRC), tick_others(NO_TICK) { }
+
+        void push(ncycle_t curr_tick, uint64_t src_)
+        {
+            if (src_!=src)
+            {
+                tick_others = tick;
+                src = src_;
+            }
+            tick = curr_tick;
+        }
+
+        ncycle_t get_except(uint64_t src_) 
+        { 
+            return (src_==src)? tick_others : tick; 
+        }
+
+        static const ncycle_t NO_TICK = std::numeric_limits<ncycle_t>::max( );
+        static const uint64_t NO_SRC = std::numeric_limits<uint64_t>::max( );
+    } last_event_t;
+
     class BankMachine
     {
       public:
@@ -56,17 +88,19 @@ namespace PCMCsim
         ~BankMachine( ) { delete stats; }
 
         bool is_idle( );
-        bool is_issuable(Packet* pkt);
-        ncycle_t timely_issuable(Packet* pkt);
-        ncycle_t update_states(Packet* pkt);
+        bool is_issuable(Packet* pkt, ncycle_t notified);
+        ncycle_t timely_issuable(Packet* pkt, ncycle_t notified);
+        ncycle_t update_states(Packet* pkt, ncycle_t notified);
 
         void postupdate_states(Packet* pkt);
         void notify(Packet* pkt, bool is_same_bankgroup);
+        ncycle_t get_checked(cmd_t cmd);
 
-        void update_stats(ncycle_t cycles);
+        void sync_stats( );
         void register_stats( );
         void calculate_stats( );
         void print_stats(std::ostream& os);
+        void collect_stats(std::vector<Stats*>& slist);
         double get_dynamic_energy( ) { return (E_act+E_rd+E_wr); }
 
       private:
@@ -82,6 +116,8 @@ namespace PCMCsim
         uint64_t open_row;  // row that is currently activated
         int state;
 
+        void set_state(int next_state);
+
         /* Machine states */
         ncycle_t issuable_ACT;
         ncycle_t issuable_PRE;
@@ -93,6 +129,12 @@ namespace PCMCsim
         ncycle_t issuable_SRE;
         ncycle_t issuable_SRX;
 
+        /* Eagerly notified timings for cross-checking lazy ones */
+        ncycle_t chk_ACT;
+        ncycle_t chk_PRE;
+        ncycle_t chk_READ;
+        ncycle_t chk_WRITE;
+
         ncycle_t activate(Packet* pkt);
         ncycle_t precharge(Packet* pkt);
         ncycle_t read(Packet* pkt);
@@ -107,9 +149,11 @@ namespace PCMCsim
         {
             return ((half*num_parts+part)*num_rows_per_part+row);
         }
+        uint64_t get_row_idx(Packet* pkt);
 
         /* Stats (BM only records dynamic energy) */
         Stats* stats;
+        ncycle_t last_state_cycle;  // cycle of last residency sync
         ncycle_t cycles_act;
         ncycle_t cycles_bckgnd;
         ncycle_t cycles_io;
@@ -148,10 +192,12 @@ namespace PCMCsim
         void postupdate_states(Packet* pkt);
 
         void notify(Packet* pkt);
-        void update_stats(ncycle_t cycles);
+        void sync_stats( );
+        void sync_bckgnd( );    // sync residencies & derive background energy
         void register_stats( );
         void calculate_stats( );
         void print_stats(std::ostream& os);
+        void collect_stats(std::vector<Stats*>& slist);
         
       private:
         uint64_t id;
@@ -162,14 +208,44 @@ namespace PCMCsim
         uint64_t num_bgs;
         uint64_t num_banks;
         uint64_t num_all_banks;
+        uint64_t num_busy_banks;    // banks that are not closed
         int state;
 
+        void set_state(int next_state);
+        ncycle_t update_bank(uint64_t bm_idx, Packet* pkt);
+        void postupdate_bank(uint64_t bm_idx, Packet* pkt);
+        void count_busy_banks(bool was_idle, bool now_idle);
+
         /* Machine states */
-        ncycle_t issuable_READ;
-        ncycle_t issuable_WRITE;
         std::vector<uint64_t> last_ACTs;  // time window of last X ACTs
         uint64_t XAW_ptr;
 
+        /* 
+         * Constraint registers of bankgroups & rank, where timings of
+         * unaccessed banks are derived lazily from them on query
+         */
+        enum _bank_events
+        {
+            EV_ACT = 0,
+            EV_READ,
+            EV_WRITE,
+            EV_PRE,
+            EV_REFRESH,
+            NUM_EVS
+        };
+
+        std::vector<last_event_t> bg_events;    // [bg*NUM_EVS+ev], src=bank
+        std::vector<last_event_t> rank_events;  // [ev], src=bankgroup
+
+        int get_event(cmd_t cmd);
+        void push_event(Packet* pkt);
+        ncycle_t get_notified(uint64_t bm_idx, cmd_t cmd);
+        ncycle_t get_notified(cmd_t cmd);
+
+        /* Eagerly notified timings for cross-checking lazy ones */
+        ncycle_t chk_READ;
+        ncycle_t chk_WRITE;
+
         ncycle_t activate(Packet* pkt);
         ncycle_t rdwr(Packet* pkt);
         ncycle_t precharge(Packet* pkt);
@@ -180,9 +256,11 @@ namespace PCMCsim
         ncycle_t srx(Packet* pkt);
 
         uint64_t get_bm_idx(uint64_t bg, uint64_t bk) { return (bg*num_banks+bk); }
+        uint64_t get_bm_idx(Packet* pkt);
 
         /* Stats */
         Stats* stats;
+        ncycle_t last_state_cycle;  // cycle of last residency sync
         ncycle_t cycles_apd; // units are not ticks
         ncycle_t cycles_fppd;
         ncycle_t cycles_sppd;
@@ -226,10 +304,11 @@ namespace PCMCsim
         ncycle_t get_postupdate_latency(Packet* pkt);
         void postupdate_states(Packet* pkt);
 
-        void update_stats(ncycle_t cycles);
         void register_stats( );
+        void sync_stats( );
         void calculate_stats( );
         void print_stats(std::ostream& os);
+        void collect_stats(std::vector<Stats*>& slist);
 
         /* Timing-related parameters */
         bool timing_set = false;
@@ -314,8 +393,14 @@ namespace PCMCsim
         std::vector<RankMachine> rm;
         uint64_t num_ranks;
         
+        /* Rank-to-rank constraint registers ([0]: RD, [1]: WR, src=rank) */
+        std::vector<last_event_t> cas_events;
+        bool check_lazy;    // cross-check lazy timings with eager ones
+
         std::string print_state(int i=0);
+        ncycle_t get_curr_cycle( );
         ncycle_t get_tick_after(ncycle_t LAT);
+        ncycle_t get_tick_after(ncycle_t base_tick, ncycle_t LAT);
 
         /* Device parameter setup */
         void setup_timings(const uint64_t num_all_banks);
@@ -1,12 +1,17 @@
 #include "base/MemoryControlSystem.h"
 #include "base/Packet.h"
+#include "base/EventQueue.h"
+#include "base/Stats.h"
 #include "uCMDEngine/uCMDEngine.h"
 
 using namespace PCMCsim;
 
 uCMDEngine::uCMDEngine(MemoryControlSystem* memsys_)
-:Component(memsys_), dpu(NULL), media(NULL)
+:Component(memsys_), dpu(NULL), media(NULL), qdepth(0), qdepth_tick(0), 
+qdepth_sum(0.0), qdepth_base_tick(0), qdepth_base_sum(0.0)
 {
+    track_qdepth = (memsys->getParamUINT64("global.epoch_ticks", 0)>0 ||
+                    memsys->getParamUINT64("global.epoch_reqs", 0)>0);
 }
 
 uCMDEngine::~uCMDEngine( )
@@ -36,3 +41,58 @@ void uCMDEngine::wack(Packet* pkt, cmd_t type)
     }
 }
 
+void uCMDEngine::update_qdepth(uint64_t depth)
+{
+    if (track_qdepth==false)
+        return;
+
+    ncycle_t curr_tick = geq->getCurrentTick( );
+    qdepth_sum += (double)qdepth*(curr_tick-qdepth_tick);
+    qdepth_tick = curr_tick;
+    qdepth = depth;
+}
+
+void uCMDEngine::sync_stats( )
+{
+    if (track_qdepth==false)
+        return;
+
+    /* An epoch dump gets the time-weighted depth over the epoch */
+    update_qdepth(qdepth);
+    queue_depth = qdepth;
+    if (qdepth_tick>qdepth_base_tick)
+    {
+        avg_queue_depth = (qdepth_sum-qdepth_base_sum) / 
+                          (qdepth_tick-qdepth_base_tick);
+    }
+    qdepth_base_tick = qdepth_tick;
+    qdepth_base_sum = qdepth_sum;
+}
+
+/*========== Below is stats setting ==========*/
+void uCMDEngine::register_qdepth_stats( )
+{
+    if (track_qdepth==false)
+        return;
+
+    uint64_t u64_zero = 0;
+    double df_init = 0.0;
+
+    RESET_STATS(queue_depth, u64_zero);
+    RESET_STATS(avg_queue_depth, df_init);
+
+    ADD_STATS_LEVEL(cp_name, queue_depth);
+    ADD_STATS_LEVEL(cp_name, avg_queue_depth);
+}
+
+void uCMDEngine::calculate_qdepth_stats( )
+{
+    if (track_qdepth==false)
+        return;
+
+    /* Over the whole run at the end */
+    update_qdepth(qdepth);
+    queue_depth = qdepth;
+    if (qdepth_tick>0)
+        avg_queue_depth = qdepth_sum / qdepth_tick;
+}
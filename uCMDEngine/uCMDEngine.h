@@ -51,12 +51,34 @@ namespace PCMCsim
 
         void handle_events(ncycle_t curr_tick) override = 0;
 
+        /* Number of reqs the engine holds (for load-aware modules) */
+        virtual uint64_t get_num_reqs( ) { return 0; }
+
+        void sync_stats( ) override;
+
         /* Connected Modules & public var. */
         Component* dpu;
         Component* media;
 
       protected:
         void wack(Packet* pkt, cmd_t type);
+
+        /* Occupancy of the request list (only tracked w/ epoch dumps) */
+        bool track_qdepth;
+        uint64_t qdepth;            // current depth
+        ncycle_t qdepth_tick;       // tick of the last change of depth
+        double qdepth_sum;          // depth accumulated over ticks
+        ncycle_t qdepth_base_tick;  // tick of the last epoch dump
+        double qdepth_base_sum;     // qdepth_sum at the last epoch dump
+
+        void update_qdepth(uint64_t depth);
+
+        /* Stats */
+        uint64_t queue_depth;
+        double avg_queue_depth;
+
+        void register_qdepth_stats( );
+        void calculate_qdepth_stats( );
    };
 };
 